@@ -0,0 +1,96 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/Common.h"
+
+#include "HeapSnapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static void displayHelp(const char* argv0)
+{
+    printf("Usage: %s [options] snapshot [newsnapshot]\n", argv0);
+    printf("\n");
+    printf("With one snapshot, lists objects that retain the most memory.\n");
+    printf("With two snapshots, lists objects from the first snapshot that retain the most memory allocated since it was taken.\n");
+    printf("Snapshots can be captured with 'luau --heapsnapshot=<file>'.\n");
+    printf("\n");
+    printf("Available options:\n");
+    printf("  -h, --help: Display this usage message.\n");
+    printf("  --top=N: number of objects to list (default 20)\n");
+}
+
+static int assertionHandler(const char* expr, const char* file, int line, const char* function)
+{
+    printf("%s(%d): ASSERTION FAILED: %s\n", file, line, expr);
+    return 1;
+}
+
+static bool loadSnapshot(const char* path, HeapSnapshot& snapshot)
+{
+    FILE* f = fopen(path, "rb");
+
+    if (!f)
+    {
+        fprintf(stderr, "Couldn't open snapshot %s\n", path);
+        return false;
+    }
+
+    bool result = heapSnapshotLoad(snapshot, f);
+    fclose(f);
+
+    if (!result)
+        fprintf(stderr, "Couldn't load snapshot %s: invalid format\n", path);
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    Luau::assertHandler() = assertionHandler;
+
+    size_t top = 20;
+    const char* paths[2] = {};
+    int pathcount = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            displayHelp(argv[0]);
+            return 0;
+        }
+        else if (strncmp(argv[i], "--top=", 6) == 0)
+        {
+            top = size_t(atoi(argv[i] + 6));
+        }
+        else if (argv[i][0] == '-' || pathcount == 2)
+        {
+            fprintf(stderr, "Error: Unrecognized option '%s'.\n\n", argv[i]);
+            displayHelp(argv[0]);
+            return 1;
+        }
+        else
+        {
+            paths[pathcount++] = argv[i];
+        }
+    }
+
+    if (pathcount == 0)
+    {
+        displayHelp(argv[0]);
+        return 1;
+    }
+
+    HeapSnapshot snapshots[2];
+
+    for (int i = 0; i < pathcount; ++i)
+        if (!loadSnapshot(paths[i], snapshots[i]))
+            return 1;
+
+    const HeapSnapshot& current = snapshots[pathcount - 1];
+    HeapDominators dominators = heapSnapshotDominators(current);
+
+    heapSnapshotReport(stdout, current, dominators, pathcount == 2 ? &snapshots[0] : nullptr, top);
+
+    return 0;
+}
@@ -0,0 +1,669 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "HeapSnapshot.h"
+
+#include "lua.h"
+
+#include "Luau/Common.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <string.h>
+
+static const char kHeapSnapshotMagic[8] = {'L', 'U', 'A', 'U', 'H', 'E', 'A', 'P'};
+static const uint32_t kHeapSnapshotVersion = 2;
+
+struct HeapSnapshotBuilder
+{
+    HeapSnapshot& snapshot;
+
+    // edge targets are recorded as addresses and resolved after enumeration
+    std::vector<uint64_t> targets;
+    std::vector<uint32_t> targetnames;
+    std::unordered_map<std::string, uint32_t> names;
+};
+
+static uint32_t internName(HeapSnapshotBuilder& builder, const char* name)
+{
+    auto [it, inserted] = builder.names.try_emplace(name, uint32_t(builder.snapshot.strings.size()));
+
+    if (inserted)
+        builder.snapshot.strings.push_back(name);
+
+    return it->second;
+}
+
+static void captureNode(void* context, void* ptr, int tt, int memcat, size_t size, const char* name)
+{
+    HeapSnapshotBuilder& builder = *static_cast<HeapSnapshotBuilder*>(context);
+    HeapSnapshot& snapshot = builder.snapshot;
+
+    snapshot.addresses.push_back(uintptr_t(ptr));
+    snapshot.sizes.push_back(size);
+    snapshot.types.push_back(uint8_t(tt));
+    snapshot.categories.push_back(uint8_t(memcat));
+    snapshot.names.push_back(name && *name ? internName(builder, name) : 0);
+    snapshot.edgeoffsets.push_back(uint32_t(builder.targets.size()));
+}
+
+static void captureEdge(void* context, void* from, void* to, const char* name)
+{
+    HeapSnapshotBuilder& builder = *static_cast<HeapSnapshotBuilder*>(context);
+
+    // references are reported right after the object they belong to
+    LUAU_ASSERT(!builder.snapshot.addresses.empty() && builder.snapshot.addresses.back() == uintptr_t(from));
+
+    builder.targets.push_back(uintptr_t(to));
+    builder.targetnames.push_back(name && *name ? internName(builder, name) : 0);
+}
+
+void heapSnapshotCapture(lua_State* L, HeapSnapshot& snapshot)
+{
+    snapshot = HeapSnapshot();
+    snapshot.strings.push_back(""); // index 0 is reserved for objects without a name
+
+    HeapSnapshotBuilder builder{snapshot};
+
+    lua_enumheap(L, &builder, captureNode, captureEdge);
+
+    size_t count = snapshot.size();
+    snapshot.edgeoffsets.push_back(uint32_t(builder.targets.size()));
+
+    // resolve references using a sorted copy of the addresses; this doesn't need the VM anymore
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i)
+        order[i] = uint32_t(i);
+
+    std::sort(order.begin(), order.end(), [&](uint32_t l, uint32_t r) {
+        return snapshot.addresses[l] < snapshot.addresses[r];
+    });
+
+    std::vector<uint64_t> sorted(count);
+    for (size_t i = 0; i < count; ++i)
+        sorted[i] = snapshot.addresses[order[i]];
+
+    snapshot.edges.reserve(builder.targets.size());
+    snapshot.edgenames.reserve(builder.targets.size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t begin = snapshot.edgeoffsets[i];
+        uint32_t end = snapshot.edgeoffsets[i + 1];
+
+        snapshot.edgeoffsets[i] = uint32_t(snapshot.edges.size());
+
+        for (uint32_t e = begin; e < end; ++e)
+        {
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), builder.targets[e]);
+
+            if (it != sorted.end() && *it == builder.targets[e])
+            {
+                snapshot.edges.push_back(order[it - sorted.begin()]);
+                snapshot.edgenames.push_back(builder.targetnames[e]);
+            }
+        }
+    }
+
+    snapshot.edgeoffsets[count] = uint32_t(snapshot.edges.size());
+}
+
+template<typename T>
+static bool writeArray(FILE* file, const std::vector<T>& data)
+{
+    uint64_t size = data.size();
+
+    return fwrite(&size, sizeof(size), 1, file) == 1 && (data.empty() || fwrite(data.data(), sizeof(T), data.size(), file) == data.size());
+}
+
+static uint64_t getRemainingSize(FILE* file)
+{
+    long pos = ftell(file);
+
+    if (pos < 0 || fseek(file, 0, SEEK_END) != 0)
+        return 0;
+
+    long end = ftell(file);
+
+    if (end < pos || fseek(file, pos, SEEK_SET) != 0)
+        return 0;
+
+    return uint64_t(end - pos);
+}
+
+template<typename T>
+static bool readArray(FILE* file, std::vector<T>& data)
+{
+    uint64_t size = 0;
+
+    if (fread(&size, sizeof(size), 1, file) != 1)
+        return false;
+
+    // count comes from the file, so it's checked against the data that is left before anything is allocated
+    if (getRemainingSize(file) / sizeof(T) < size)
+        return false;
+
+    data.resize(size_t(size));
+
+    return data.empty() || fread(data.data(), sizeof(T), data.size(), file) == data.size();
+}
+
+bool heapSnapshotSave(const HeapSnapshot& snapshot, FILE* file)
+{
+    if (fwrite(kHeapSnapshotMagic, sizeof(kHeapSnapshotMagic), 1, file) != 1)
+        return false;
+
+    if (fwrite(&kHeapSnapshotVersion, sizeof(kHeapSnapshotVersion), 1, file) != 1)
+        return false;
+
+    if (!writeArray(file, snapshot.addresses) || !writeArray(file, snapshot.sizes) || !writeArray(file, snapshot.types) ||
+        !writeArray(file, snapshot.categories) || !writeArray(file, snapshot.names) || !writeArray(file, snapshot.edgeoffsets) ||
+        !writeArray(file, snapshot.edges) || !writeArray(file, snapshot.edgenames))
+        return false;
+
+    uint64_t stringcount = snapshot.strings.size();
+
+    if (fwrite(&stringcount, sizeof(stringcount), 1, file) != 1)
+        return false;
+
+    for (const std::string& s : snapshot.strings)
+    {
+        uint32_t length = uint32_t(s.size());
+
+        if (fwrite(&length, sizeof(length), 1, file) != 1 || (length && fwrite(s.data(), 1, length, file) != length))
+            return false;
+    }
+
+    return true;
+}
+
+bool heapSnapshotLoad(HeapSnapshot& snapshot, FILE* file)
+{
+    char magic[sizeof(kHeapSnapshotMagic)] = {};
+    uint32_t version = 0;
+
+    if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, kHeapSnapshotMagic, sizeof(magic)) != 0)
+        return false;
+
+    if (fread(&version, sizeof(version), 1, file) != 1 || version != kHeapSnapshotVersion)
+        return false;
+
+    if (!readArray(file, snapshot.addresses) || !readArray(file, snapshot.sizes) || !readArray(file, snapshot.types) ||
+        !readArray(file, snapshot.categories) || !readArray(file, snapshot.names) || !readArray(file, snapshot.edgeoffsets) ||
+        !readArray(file, snapshot.edges) || !readArray(file, snapshot.edgenames))
+        return false;
+
+    uint64_t stringcount = 0;
+
+    // each string takes at least its length
+    if (fread(&stringcount, sizeof(stringcount), 1, file) != 1 || getRemainingSize(file) / sizeof(uint32_t) < stringcount)
+        return false;
+
+    snapshot.strings.resize(size_t(stringcount));
+
+    for (std::string& s : snapshot.strings)
+    {
+        uint32_t length = 0;
+
+        if (fread(&length, sizeof(length), 1, file) != 1 || getRemainingSize(file) < length)
+            return false;
+
+        s.resize(length);
+
+        if (length && fread(&s[0], 1, length, file) != length)
+            return false;
+    }
+
+    // validate the structure so that analysis doesn't need to
+    size_t count = snapshot.addresses.size();
+
+    if (snapshot.sizes.size() != count || snapshot.types.size() != count || snapshot.categories.size() != count ||
+        snapshot.names.size() != count || snapshot.edgeoffsets.size() != count + 1 || snapshot.strings.empty())
+        return false;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (snapshot.edgeoffsets[i] > snapshot.edgeoffsets[i + 1] || snapshot.names[i] >= snapshot.strings.size())
+            return false;
+    }
+
+    if (snapshot.edgeoffsets[count] != snapshot.edges.size() || snapshot.edgenames.size() != snapshot.edges.size())
+        return false;
+
+    for (uint32_t target : snapshot.edges)
+        if (target >= count)
+            return false;
+
+    for (uint32_t name : snapshot.edgenames)
+        if (name >= snapshot.strings.size())
+            return false;
+
+    return true;
+}
+
+// Immediate dominators are computed with the semi-NCA variant of the Lengauer-Tarjan algorithm
+// Vertex 0 is a virtual root that refers to the main thread first, and then to every object that wasn't reached from it
+HeapDominators heapSnapshotDominators(const HeapSnapshot& snapshot)
+{
+    const uint32_t kNone = ~0u;
+
+    size_t count = snapshot.size();
+    size_t vertices = count + 1;
+
+    // depth-first numbering; object i is vertex i + 1
+    std::vector<uint32_t> number(vertices, kNone);
+    std::vector<uint32_t> vertex;
+    std::vector<uint32_t> parent;
+
+    vertex.reserve(vertices);
+    parent.reserve(vertices);
+
+    number[0] = 0;
+    vertex.push_back(0);
+    parent.push_back(kNone);
+
+    std::vector<std::pair<uint32_t, uint32_t>> stack; // object and its next reference to visit
+
+    for (size_t start = 0; start < count; ++start)
+    {
+        if (number[start + 1] != kNone)
+            continue;
+
+        number[start + 1] = uint32_t(vertex.size());
+        vertex.push_back(uint32_t(start + 1));
+        parent.push_back(0);
+
+        stack.push_back({uint32_t(start), snapshot.edgeoffsets[start]});
+
+        while (!stack.empty())
+        {
+            auto& [object, edge] = stack.back();
+
+            if (edge == snapshot.edgeoffsets[object + 1])
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            uint32_t target = snapshot.edges[edge++];
+
+            if (number[target + 1] == kNone)
+            {
+                uint32_t from = number[object + 1];
+
+                number[target + 1] = uint32_t(vertex.size());
+                vertex.push_back(target + 1);
+                parent.push_back(from);
+
+                stack.push_back({target, snapshot.edgeoffsets[target]});
+            }
+        }
+    }
+
+    LUAU_ASSERT(vertex.size() == vertices);
+
+    // predecessors of each vertex in depth-first numbering
+    std::vector<uint32_t> predoffsets(vertices + 1, 0);
+
+    for (uint32_t target : snapshot.edges)
+        predoffsets[number[target + 1] + 1]++;
+
+    for (size_t i = 0; i < vertices; ++i)
+        predoffsets[i + 1] += predoffsets[i];
+
+    std::vector<uint32_t> preds(snapshot.edges.size());
+    std::vector<uint32_t> predfill(predoffsets.begin(), predoffsets.end() - 1);
+
+    for (size_t object = 0; object < count; ++object)
+    {
+        for (uint32_t e = snapshot.edgeoffsets[object]; e < snapshot.edgeoffsets[object + 1]; ++e)
+            preds[predfill[number[snapshot.edges[e] + 1]]++] = number[object + 1];
+    }
+
+    // semidominators, using a link-eval forest with path compression
+    std::vector<uint32_t> semi(vertices);
+    std::vector<uint32_t> label(vertices);
+    std::vector<uint32_t> ancestor(vertices, kNone);
+    std::vector<uint32_t> path;
+
+    for (size_t i = 0; i < vertices; ++i)
+        semi[i] = label[i] = uint32_t(i);
+
+    auto eval = [&](uint32_t v) {
+        if (ancestor[v] == kNone)
+            return v;
+
+        path.clear();
+
+        for (uint32_t x = v; ancestor[ancestor[x]] != kNone; x = ancestor[x])
+            path.push_back(x);
+
+        for (size_t i = path.size(); i > 0; --i)
+        {
+            uint32_t x = path[i - 1];
+            uint32_t a = ancestor[x];
+
+            if (semi[label[a]] < semi[label[x]])
+                label[x] = label[a];
+
+            ancestor[x] = ancestor[a];
+        }
+
+        return label[v];
+    };
+
+    for (size_t w = vertices - 1; w > 0; --w)
+    {
+        // parent is always a predecessor, including the virtual references of the root
+        semi[w] = parent[w];
+
+        for (uint32_t p = predoffsets[w]; p < predoffsets[w + 1]; ++p)
+        {
+            uint32_t u = eval(preds[p]);
+
+            if (semi[u] < semi[w])
+                semi[w] = semi[u];
+        }
+
+        ancestor[w] = parent[w];
+    }
+
+    // immediate dominator is the nearest common ancestor of the parent and the semidominator in the depth-first tree
+    std::vector<uint32_t> idom(vertices, 0);
+
+    for (size_t w = 1; w < vertices; ++w)
+    {
+        uint32_t d = parent[w];
+
+        while (d > semi[w])
+            d = idom[d];
+
+        idom[w] = d;
+    }
+
+    HeapDominators result;
+    result.idom.resize(count);
+    result.retained.assign(snapshot.sizes.begin(), snapshot.sizes.end());
+    result.order.resize(count);
+
+    for (size_t w = 1; w < vertices; ++w)
+    {
+        uint32_t object = vertex[w] - 1;
+
+        result.idom[object] = idom[w] == 0 ? HeapDominators::kRoot : vertex[idom[w]] - 1;
+        result.order[w - 1] = object;
+    }
+
+    // dominators precede the objects they dominate in depth-first order
+    for (size_t w = vertices - 1; w > 0; --w)
+    {
+        if (idom[w] != 0)
+            result.retained[vertex[idom[w]] - 1] += result.retained[vertex[w] - 1];
+    }
+
+    return result;
+}
+
+static const char* getTypeName(uint8_t tt)
+{
+    switch (tt)
+    {
+    case LUA_TSTRING:
+        return "string";
+    case LUA_TTABLE:
+        return "table";
+    case LUA_TFUNCTION:
+        return "function";
+    case LUA_TUSERDATA:
+        return "userdata";
+    case LUA_TTHREAD:
+        return "thread";
+    case LUA_TPROTO:
+        return "proto";
+    case LUA_TUPVAL:
+        return "upvalue";
+    default:
+        return "unknown";
+    }
+}
+
+static void printObject(FILE* out, const HeapSnapshot& snapshot, uint32_t object)
+{
+    const char* name = snapshot.name(object);
+
+    fprintf(out, "%s %s%s0x%llx (category %d)", getTypeName(snapshot.types[object]), name ? name : "", name ? " " : "",
+        (unsigned long long)snapshot.addresses[object], snapshot.categories[object]);
+}
+
+struct TypeSummary
+{
+    uint64_t count = 0;
+    uint64_t size = 0;
+};
+
+static void printTypeSummary(FILE* out, const char* title, const TypeSummary (&summary)[256])
+{
+    fprintf(out, "%s:\n", title);
+
+    for (int tt = 0; tt < 256; ++tt)
+    {
+        if (summary[tt].count)
+            fprintf(out, "  %-10s %12llu objects %16llu bytes\n", getTypeName(uint8_t(tt)), (unsigned long long)summary[tt].count,
+                (unsigned long long)summary[tt].size);
+    }
+}
+
+static std::vector<uint32_t> getTopObjects(const std::vector<uint64_t>& values, size_t count)
+{
+    std::vector<uint32_t> objects;
+
+    for (size_t i = 0; i < values.size(); ++i)
+        if (values[i])
+            objects.push_back(uint32_t(i));
+
+    count = std::min(count, objects.size());
+
+    std::partial_sort(objects.begin(), objects.begin() + count, objects.end(), [&](uint32_t l, uint32_t r) {
+        return values[l] > values[r];
+    });
+
+    objects.resize(count);
+    return objects;
+}
+
+void heapSnapshotReport(FILE* out, const HeapSnapshot& snapshot, const HeapDominators& dominators, const HeapSnapshot* old, size_t count)
+{
+    TypeSummary total[256];
+
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        total[snapshot.types[i]].count++;
+        total[snapshot.types[i]].size += snapshot.sizes[i];
+    }
+
+    printTypeSummary(out, "Heap", total);
+
+    if (!old)
+    {
+        fprintf(out, "\nLargest retained sizes:\n");
+
+        for (uint32_t object : getTopObjects(dominators.retained, count))
+        {
+            fprintf(out, "  %14llu bytes retained by ", (unsigned long long)dominators.retained[object]);
+            printObject(out, snapshot, object);
+
+            if (uint32_t holder = dominators.idom[object]; holder != HeapDominators::kRoot)
+            {
+                fprintf(out, ", held by ");
+                printObject(out, snapshot, holder);
+
+                if (const char* edgename = snapshot.edgename(holder, object))
+                    fprintf(out, " through '%s'", edgename);
+            }
+
+            fprintf(out, "\n");
+        }
+
+        return;
+    }
+
+    // objects are matched by address and type; a different type at the same address means the memory was reused
+    std::vector<uint32_t> oldorder(old->size());
+    for (size_t i = 0; i < oldorder.size(); ++i)
+        oldorder[i] = uint32_t(i);
+
+    std::sort(oldorder.begin(), oldorder.end(), [&](uint32_t l, uint32_t r) {
+        return old->addresses[l] < old->addresses[r];
+    });
+
+    std::vector<bool> existed(snapshot.size());
+    std::vector<bool> survived(old->size());
+    size_t matched = 0;
+
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        auto it = std::lower_bound(oldorder.begin(), oldorder.end(), snapshot.addresses[i], [&](uint32_t l, uint64_t address) {
+            return old->addresses[l] < address;
+        });
+
+        if (it != oldorder.end() && old->addresses[*it] == snapshot.addresses[i] && old->types[*it] == snapshot.types[i])
+        {
+            existed[i] = true;
+            survived[*it] = true;
+            matched++;
+        }
+    }
+
+    TypeSummary oldtotal[256];
+
+    for (size_t i = 0; i < old->size(); ++i)
+    {
+        oldtotal[old->types[i]].count++;
+        oldtotal[old->types[i]].size += old->sizes[i];
+    }
+
+    fprintf(out, "\nChange since the old snapshot:\n");
+
+    for (int tt = 0; tt < 256; ++tt)
+    {
+        if (total[tt].count || oldtotal[tt].count)
+            fprintf(out, "  %-10s %+12lld objects %+16lld bytes\n", getTypeName(uint8_t(tt)),
+                (long long)total[tt].count - (long long)oldtotal[tt].count, (long long)total[tt].size - (long long)oldtotal[tt].size);
+    }
+
+    // objects can only be matched between snapshots taken in the same process
+    if (matched == 0)
+    {
+        fprintf(out, "\nSnapshots have no objects in common; allocations can't be attributed to old objects\n");
+        return;
+    }
+
+    TypeSummary allocated[256];
+    TypeSummary freed[256];
+
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        if (!existed[i])
+        {
+            allocated[snapshot.types[i]].count++;
+            allocated[snapshot.types[i]].size += snapshot.sizes[i];
+        }
+    }
+
+    for (size_t i = 0; i < old->size(); ++i)
+    {
+        if (!survived[i])
+        {
+            freed[old->types[i]].count++;
+            freed[old->types[i]].size += old->sizes[i];
+        }
+    }
+
+    fprintf(out, "\n");
+    printTypeSummary(out, "Allocated since the old snapshot", allocated);
+    fprintf(out, "\n");
+    printTypeSummary(out, "Freed since the old snapshot", freed);
+
+    // each new object is attributed to the nearest dominator that existed in the old snapshot, and to the new object right below it
+    std::vector<uint32_t> owner(snapshot.size(), HeapDominators::kRoot);
+    std::vector<uint32_t> branch(snapshot.size(), HeapDominators::kRoot);
+    std::vector<uint64_t> growth(snapshot.size(), 0);
+    std::vector<uint64_t> branchgrowth(snapshot.size(), 0);
+    uint64_t unowned = 0;
+
+    for (uint32_t object : dominators.order)
+    {
+        uint32_t holder = dominators.idom[object];
+
+        if (holder != HeapDominators::kRoot)
+            owner[object] = existed[holder] ? holder : owner[holder];
+
+        if (!existed[object])
+        {
+            branch[object] = holder != HeapDominators::kRoot && !existed[holder] ? branch[holder] : object;
+
+            if (owner[object] != HeapDominators::kRoot)
+            {
+                growth[owner[object]] += snapshot.sizes[object];
+                branchgrowth[branch[object]] += snapshot.sizes[object];
+            }
+            else
+            {
+                unowned += snapshot.sizes[object];
+            }
+        }
+    }
+
+    std::vector<uint32_t> top = getTopObjects(growth, count);
+
+    // references of the listed objects that hold the most growth; they name the field, upvalue, etc. that keeps the memory alive
+    std::vector<std::vector<uint32_t>> branches(top.size());
+    std::unordered_map<uint32_t, size_t> topindex;
+
+    for (size_t i = 0; i < top.size(); ++i)
+        topindex[top[i]] = i;
+
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        if (branch[i] != i || owner[i] == HeapDominators::kRoot)
+            continue;
+
+        if (auto it = topindex.find(owner[i]); it != topindex.end())
+            branches[it->second].push_back(uint32_t(i));
+    }
+
+    fprintf(out, "\nLargest growth retained by old objects:\n");
+
+    for (size_t i = 0; i < top.size(); ++i)
+    {
+        uint32_t object = top[i];
+
+        fprintf(out, "  %14llu bytes retained by ", (unsigned long long)growth[object]);
+        printObject(out, snapshot, object);
+        fprintf(out, "\n");
+
+        std::vector<uint32_t>& children = branches[i];
+        size_t shown = std::min(children.size(), size_t(3));
+
+        std::partial_sort(children.begin(), children.begin() + shown, children.end(), [&](uint32_t l, uint32_t r) {
+            return branchgrowth[l] > branchgrowth[r];
+        });
+
+        for (size_t j = 0; j < shown; ++j)
+        {
+            const char* edgename = snapshot.edgename(object, children[j]);
+
+            fprintf(out, "  %14llu bytes through ", (unsigned long long)branchgrowth[children[j]]);
+
+            if (edgename)
+                fprintf(out, "'%s' -> ", edgename);
+            else
+                fprintf(out, "other objects -> ");
+
+            printObject(out, snapshot, children[j]);
+            fprintf(out, "\n");
+        }
+    }
+
+    if (unowned)
+        fprintf(out, "  %14llu bytes in new objects that are only held by other new objects or roots\n", (unsigned long long)unowned);
+}
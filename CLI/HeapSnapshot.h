@@ -0,0 +1,70 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct lua_State;
+
+// Compact heap graph: objects are numbered in enumeration order, the main thread is always object 0
+// References of object i are stored in edges[edgeoffsets[i]..edgeoffsets[i + 1]), with their names at the same positions in edgenames
+struct HeapSnapshot
+{
+    // objects are identified by their address across snapshots since the collector doesn't move objects
+    std::vector<uint64_t> addresses;
+    std::vector<uint64_t> sizes;
+    std::vector<uint8_t> types;
+    std::vector<uint8_t> categories;
+    std::vector<uint32_t> names; // index into 'strings', 0 when the object has no name
+
+    std::vector<uint32_t> edgeoffsets;
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> edgenames; // index into 'strings' (table field key, "metatable", "upvalue", etc.), 0 when the reference has no name
+
+    std::vector<std::string> strings;
+
+    size_t size() const
+    {
+        return addresses.size();
+    }
+
+    const char* name(uint32_t object) const
+    {
+        return names[object] ? strings[names[object]].c_str() : nullptr;
+    }
+
+    // Name of a reference from one object to another, nullptr when there is no direct reference or it has no name
+    const char* edgename(uint32_t from, uint32_t to) const
+    {
+        for (uint32_t e = edgeoffsets[from]; e < edgeoffsets[from + 1]; ++e)
+            if (edges[e] == to && edgenames[e])
+                return strings[edgenames[e]].c_str();
+
+        return nullptr;
+    }
+};
+
+// Immediate dominators of the objects and the amount of memory that would be freed if each object was no longer referenced
+struct HeapDominators
+{
+    static constexpr uint32_t kRoot = ~0u; // dominator of objects that are only dominated by the root set
+
+    std::vector<uint32_t> idom;
+    std::vector<uint64_t> retained;
+    std::vector<uint32_t> order; // depth-first order from the roots, dominators come before the objects they dominate
+};
+
+// Enumeration is the only part that needs the VM; reference resolution happens after it, so the VM isn't blocked while it runs
+void heapSnapshotCapture(lua_State* L, HeapSnapshot& snapshot);
+
+bool heapSnapshotSave(const HeapSnapshot& snapshot, FILE* file);
+bool heapSnapshotLoad(HeapSnapshot& snapshot, FILE* file);
+
+HeapDominators heapSnapshotDominators(const HeapSnapshot& snapshot);
+
+// Prints objects with the largest retained size; when 'old' is provided, only memory of the objects allocated since 'old' was taken is
+// attributed to the objects that already existed in 'old' and keep it alive
+void heapSnapshotReport(FILE* out, const HeapSnapshot& snapshot, const HeapDominators& dominators, const HeapSnapshot* old, size_t count);
@@ -6,6 +6,7 @@
 #include <thread>
 #include <atomic>
 #include <string>
+#include <unordered_map>
 
 struct Profiler
 {
@@ -28,6 +29,48 @@ struct Profiler
     uint64_t gc[16] = {};
 } gProfiler;
 
+struct MemoryProfiler
+{
+    struct Sample
+    {
+        uint32_t stack;
+        uint64_t weight;
+    };
+
+    lua_Callbacks* callbacks = nullptr;
+    size_t interval = 0;
+
+    std::string stackScratch;
+
+    // sampled stacks, and statistics per stack index
+    Luau::DenseHashMap<std::string, uint32_t> stackIds{""};
+    std::vector<std::string> stacks;
+    std::vector<uint64_t> allocated;
+    std::vector<uint64_t> live;
+
+    // samples that weren't freed yet
+    std::unordered_map<void*, Sample> samples;
+    uint64_t sampleCount = 0;
+} gMemoryProfiler;
+
+static void appendStack(lua_State* L, std::string& stack)
+{
+    lua_Debug ar;
+    for (int level = 0; lua_getinfo(L, level, "sn", &ar); ++level)
+    {
+        if (!stack.empty())
+            stack += ';';
+
+        stack += ar.short_src;
+        stack += ',';
+        if (ar.name)
+            stack += ar.name;
+        stack += ',';
+        if (ar.linedefined > 0)
+            stack += std::to_string(ar.linedefined);
+    }
+}
+
 static void profilerTrigger(lua_State* L, int gc)
 {
     uint64_t currentTicks = gProfiler.ticks.load();
@@ -42,20 +85,7 @@ static void profilerTrigger(lua_State* L, int gc)
         if (gc > 0)
             stack += "GC,GC,";
 
-        lua_Debug ar;
-        for (int level = 0; lua_getinfo(L, level, "sn", &ar); ++level)
-        {
-            if (!stack.empty())
-                stack += ';';
-
-            stack += ar.short_src;
-            stack += ',';
-            if (ar.name)
-                stack += ar.name;
-            stack += ',';
-            if (ar.linedefined > 0)
-                stack += std::to_string(ar.linedefined);
-        }
+        appendStack(L, stack);
 
         if (!stack.empty())
         {
@@ -155,3 +185,102 @@ void profilerDump(const char* path)
         printf("\n");
     }
 }
+
+static void memoryProfilerAllocSample(lua_State* L, void* block, size_t size, size_t weight, int memcat)
+{
+    std::string& stack = gMemoryProfiler.stackScratch;
+
+    stack.clear();
+    appendStack(L, stack);
+
+    // memory category is the outermost frame so that the flame graph is split by category first
+    if (!stack.empty())
+        stack += ';';
+
+    stack += "memcat,category ";
+    stack += std::to_string(memcat);
+    stack += ',';
+
+    uint32_t& id = gMemoryProfiler.stackIds[stack];
+
+    if (id == 0)
+    {
+        gMemoryProfiler.stacks.push_back(stack);
+        gMemoryProfiler.allocated.push_back(0);
+        gMemoryProfiler.live.push_back(0);
+
+        id = uint32_t(gMemoryProfiler.stacks.size());
+    }
+
+    gMemoryProfiler.allocated[id - 1] += weight;
+    gMemoryProfiler.live[id - 1] += weight;
+    gMemoryProfiler.samples[block] = {id - 1, weight};
+    gMemoryProfiler.sampleCount++;
+}
+
+static void memoryProfilerFreeSample(lua_State* L, void* block, size_t size, int memcat)
+{
+    auto it = gMemoryProfiler.samples.find(block);
+
+    if (it != gMemoryProfiler.samples.end())
+    {
+        gMemoryProfiler.live[it->second.stack] -= it->second.weight;
+        gMemoryProfiler.samples.erase(it);
+    }
+}
+
+void memoryProfilerStart(lua_State* L, size_t interval)
+{
+    gMemoryProfiler.callbacks = lua_callbacks(L);
+    gMemoryProfiler.interval = interval;
+
+    gMemoryProfiler.callbacks->allocsample = memoryProfilerAllocSample;
+    gMemoryProfiler.callbacks->freesample = memoryProfilerFreeSample;
+
+    lua_setallocsampling(L, interval);
+}
+
+void memoryProfilerStop(lua_State* L)
+{
+    lua_setallocsampling(L, 0);
+
+    gMemoryProfiler.callbacks->allocsample = nullptr;
+    gMemoryProfiler.callbacks->freesample = nullptr;
+}
+
+static bool memoryProfilerDumpData(const char* path, const std::vector<uint64_t>& data, uint64_t& total)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "Error opening profile %s\n", path);
+        return false;
+    }
+
+    total = 0;
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if (data[i])
+        {
+            fprintf(f, "%lld %s\n", static_cast<long long>(data[i]), gMemoryProfiler.stacks[i].c_str());
+            total += data[i];
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+void memoryProfilerDump(const char* allocatedPath, const char* livePath)
+{
+    uint64_t allocated = 0;
+    uint64_t live = 0;
+
+    if (!memoryProfilerDumpData(allocatedPath, gMemoryProfiler.allocated, allocated) || !memoryProfilerDumpData(livePath, gMemoryProfiler.live, live))
+        return;
+
+    printf("Allocation profile written to %s and %s (allocated %.3f MB, live %.3f MB, %lld samples, %lld stacks)\n", allocatedPath, livePath,
+        double(allocated) / (1 << 20), double(live) / (1 << 20), static_cast<long long>(gMemoryProfiler.sampleCount),
+        static_cast<long long>(gMemoryProfiler.stacks.size()));
+}
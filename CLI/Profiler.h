@@ -6,3 +6,8 @@ struct lua_State;
 void profilerStart(lua_State* L, int frequency);
 void profilerStop();
 void profilerDump(const char* path);
+
+// samples an allocation every 'interval' bytes; dump lists bytes allocated and bytes still live by call stack
+void memoryProfilerStart(lua_State* L, size_t interval);
+void memoryProfilerStop(lua_State* L);
+void memoryProfilerDump(const char* allocatedPath, const char* livePath);
@@ -12,6 +12,7 @@
 #include "Coverage.h"
 #include "FileUtils.h"
 #include "Flags.h"
+#include "HeapSnapshot.h"
 #include "Profiler.h"
 
 #include "isocline.h"
@@ -59,6 +60,8 @@ enum class CompileFormat
 constexpr int MaxTraversalLimit = 50;
 
 static bool codegen = false;
+static bool codegenTiered = false;
+static bool gcGenerational = false;
 
 // Ctrl-C handling
 static void sigintCallback(lua_State* L, int gc)
@@ -254,9 +257,21 @@ static int lua_callgrind(lua_State* L)
 
 void setupState(lua_State* L)
 {
+    if (gcGenerational)
+        lua_gc(L, LUA_GCGEN, 0);
+
     if (codegen)
+    {
         Luau::CodeGen::create(L);
 
+        if (codegenTiered)
+        {
+            Luau::CodeGen::TieringOptions options = Luau::CodeGen::getTieringOptions(L);
+            options.enabled = true;
+            Luau::CodeGen::setTieringOptions(L, options);
+        }
+    }
+
     luaL_openlibs(L);
 
     static const luaL_Reg funcs[] = {
@@ -600,8 +615,33 @@ static void runRepl()
     runReplImpl(L);
 }
 
+static bool writeHeapSnapshot(lua_State* L, const char* path)
+{
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    HeapSnapshot snapshot;
+    heapSnapshotCapture(L, snapshot);
+
+    FILE* f = fopen(path, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "Error opening %s\n", path);
+        return false;
+    }
+
+    bool result = heapSnapshotSave(snapshot, f);
+    fclose(f);
+
+    if (!result)
+        fprintf(stderr, "Error writing heap snapshot to %s\n", path);
+
+    return result;
+}
+
 // `repl` is used it indicate if a repl should be started after executing the file.
-static bool runFile(const char* name, lua_State* GL, bool repl)
+// `heapsnapshot` is the path to write a heap snapshot to before the module thread is released.
+// `allocprofile` is used to indicate if the allocation profile should be written before the module thread is released.
+static bool runFile(const char* name, lua_State* GL, bool repl, const char* heapsnapshot = nullptr, bool allocprofile = false)
 {
     std::optional<std::string> source = readFile(name);
     if (!source)
@@ -659,6 +699,19 @@ static bool runFile(const char* name, lua_State* GL, bool repl)
     {
         runReplImpl(L);
     }
+
+    if (heapsnapshot && !writeHeapSnapshot(GL, heapsnapshot))
+        status = LUA_ERRRUN;
+
+    if (allocprofile)
+    {
+        // garbage left by the scripts shouldn't be reported as live
+        lua_gc(GL, LUA_GCCOLLECT, 0);
+
+        memoryProfilerStop(GL);
+        memoryProfilerDump("profile-alloc.out", "profile-live.out");
+    }
+
     lua_pop(GL, 1);
     return status == 0;
 }
@@ -820,8 +873,13 @@ static void displayHelp(const char* argv0)
     printf("  -O<n>: compile with optimization level n (default 1, n should be between 0 and 2).\n");
     printf("  -g<n>: compile with debug level n (default 1, n should be between 0 and 2).\n");
     printf("  --profile[=N]: profile the code using N Hz sampling (default 10000) and output results to profile.out\n");
+    printf("  --profile-alloc[=N]: sample an allocation every N bytes (default 65536) and output bytes allocated and bytes live after\n");
+    printf("    running the last file by call stack to profile-alloc.out and profile-live.out\n");
     printf("  --timetrace: record compiler time tracing information into trace.json\n");
     printf("  --codegen: execute code using native code generation\n");
+    printf("  --codegen-tiered: execute code using native code generation for functions that are called or loop often enough\n");
+    printf("  --gc=<incremental|generational>: garbage collection mode (default incremental)\n");
+    printf("  --heapsnapshot=<file>: after running the last file, collect garbage and write a heap snapshot for luau-heapdiff to file\n");
 }
 
 static int assertionHandler(const char* expr, const char* file, int line, const char* function)
@@ -839,8 +897,10 @@ int replMain(int argc, char** argv)
     CliMode mode = CliMode::Unknown;
     CompileFormat compileFormat{};
     int profile = 0;
+    int profileAlloc = 0;
     bool coverage = false;
     bool interactive = false;
+    const char* heapsnapshot = nullptr;
 
     // Set the mode if the user has explicitly specified one.
     int argStart = 1;
@@ -934,10 +994,35 @@ int replMain(int argc, char** argv)
         {
             profile = atoi(argv[i] + 10);
         }
+        else if (strcmp(argv[i], "--profile-alloc") == 0)
+        {
+            profileAlloc = 65536;
+        }
+        else if (strncmp(argv[i], "--profile-alloc=", 16) == 0)
+        {
+            profileAlloc = atoi(argv[i] + 16);
+        }
         else if (strcmp(argv[i], "--codegen") == 0)
         {
             codegen = true;
         }
+        else if (strcmp(argv[i], "--codegen-tiered") == 0)
+        {
+            codegen = true;
+            codegenTiered = true;
+        }
+        else if (strcmp(argv[i], "--gc=generational") == 0)
+        {
+            gcGenerational = true;
+        }
+        else if (strcmp(argv[i], "--gc=incremental") == 0)
+        {
+            gcGenerational = false;
+        }
+        else if (strncmp(argv[i], "--heapsnapshot=", 15) == 0)
+        {
+            heapsnapshot = argv[i] + 15;
+        }
         else if (strcmp(argv[i], "--coverage") == 0)
         {
             coverage = true;
@@ -1024,6 +1109,9 @@ int replMain(int argc, char** argv)
         if (profile)
             profilerStart(L, profile);
 
+        if (profileAlloc > 0)
+            memoryProfilerStart(L, profileAlloc);
+
         if (coverage)
             coverageInit(L);
 
@@ -1032,7 +1120,7 @@ int replMain(int argc, char** argv)
         for (size_t i = 0; i < files.size(); ++i)
         {
             bool isLastFile = i == files.size() - 1;
-            failed += !runFile(files[i].c_str(), L, interactive && isLastFile);
+            failed += !runFile(files[i].c_str(), L, interactive && isLastFile, isLastFile ? heapsnapshot : nullptr, isLastFile && profileAlloc > 0);
         }
 
         if (profile)
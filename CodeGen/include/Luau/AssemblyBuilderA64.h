@@ -21,6 +21,7 @@ public:
     ~AssemblyBuilderA64();
 
     // Moves
+    // Note: mov also accepts a pair of q registers to copy a full vector register
     void mov(RegisterA64 dst, RegisterA64 src);
     void mov(RegisterA64 dst, uint16_t src, int shift = 0);
     void movk(RegisterA64 dst, uint16_t src, int shift = 0);
@@ -36,6 +37,11 @@ public:
     // Note: some arithmetic instructions also have versions that update flags (ADDS etc) but we aren't using them atm
     void cmp(RegisterA64 src1, RegisterA64 src2);
     void cmp(RegisterA64 src1, int src2);
+    void tst(RegisterA64 src1, RegisterA64 src2);
+
+    // Conditional selection
+    void csel(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, ConditionA64 cond);
+    void cset(RegisterA64 dst, ConditionA64 cond);
 
     // Bitwise
     // Note: shifted-register support and bitfield operations are omitted for simplicity
@@ -54,18 +60,20 @@ public:
     void rbit(RegisterA64 dst, RegisterA64 src);
 
     // Load
-    // Note: paired loads are currently omitted for simplicity
+    // Note: ldr/str also accept d/q registers for SIMD&FP loads and stores
     void ldr(RegisterA64 dst, AddressA64 src);
     void ldrb(RegisterA64 dst, AddressA64 src);
     void ldrh(RegisterA64 dst, AddressA64 src);
     void ldrsb(RegisterA64 dst, AddressA64 src);
     void ldrsh(RegisterA64 dst, AddressA64 src);
     void ldrsw(RegisterA64 dst, AddressA64 src);
+    void ldp(RegisterA64 dst1, RegisterA64 dst2, AddressA64 src);
 
     // Store
     void str(RegisterA64 src, AddressA64 dst);
     void strb(RegisterA64 src, AddressA64 dst);
     void strh(RegisterA64 src, AddressA64 dst);
+    void stp(RegisterA64 src1, RegisterA64 src2, AddressA64 dst);
 
     // Control flow
     // Note: tbz/tbnz are currently not supported because they have 15-bit offsets and we don't support branch thunks
@@ -77,6 +85,39 @@ public:
     void blr(RegisterA64 src);
     void ret();
 
+    // Floating-point scalar moves
+    // Note: fmov between d and x registers copies raw bits
+    void fmov(RegisterA64 dst, RegisterA64 src);
+
+    // Floating-point scalar math
+    // Note: fadd, fdiv, fmul, fneg and fsub also accept q registers and operate on four single-precision elements
+    void fabs(RegisterA64 dst, RegisterA64 src);
+    void fadd(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2);
+    void fdiv(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2);
+    void fmul(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2);
+    void fneg(RegisterA64 dst, RegisterA64 src);
+    void fsqrt(RegisterA64 dst, RegisterA64 src);
+    void fsub(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2);
+
+    // Floating-point rounding
+    void frinta(RegisterA64 dst, RegisterA64 src);
+    void frintm(RegisterA64 dst, RegisterA64 src);
+    void frintp(RegisterA64 dst, RegisterA64 src);
+
+    // Floating-point conversions
+    void fcvt(RegisterA64 dst, RegisterA64 src);
+    void fcvtzs(RegisterA64 dst, RegisterA64 src);
+    void scvtf(RegisterA64 dst, RegisterA64 src);
+
+    // Floating-point comparisons
+    void fcmp(RegisterA64 src1, RegisterA64 src2);
+    void fcmpz(RegisterA64 src);
+
+    // Single-precision vector element operations
+    // ins_4s copies a w register into an element of a q register, dup_4s copies an element of a s/q register into all elements of a q register
+    void ins_4s(RegisterA64 dst, RegisterA64 src, uint8_t index);
+    void dup_4s(RegisterA64 dst, RegisterA64 src, uint8_t index);
+
     // Address of embedded data
     void adr(RegisterA64 dst, const void* ptr, size_t size);
     void adr(RegisterA64 dst, uint64_t value);
@@ -111,9 +152,13 @@ private:
     void placeSR2(const char* name, RegisterA64 dst, RegisterA64 src, uint8_t op, uint8_t op2 = 0);
     void placeR3(const char* name, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, uint8_t op, uint8_t op2);
     void placeR1(const char* name, RegisterA64 dst, RegisterA64 src, uint32_t op);
+    void placeVR(const char* name, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, uint16_t op, uint8_t op2);
     void placeI12(const char* name, RegisterA64 dst, RegisterA64 src1, int src2, uint8_t op);
     void placeI16(const char* name, RegisterA64 dst, int src, uint8_t op, int shift = 0);
-    void placeA(const char* name, RegisterA64 dst, AddressA64 src, uint8_t op, uint8_t size);
+    void placeA(const char* name, RegisterA64 dst, AddressA64 src, uint8_t op, uint8_t size, int sizelog);
+    void placeP(const char* name, RegisterA64 dst1, RegisterA64 dst2, AddressA64 src, uint8_t op, uint8_t opc, int sizelog);
+    void placeCS(const char* name, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, ConditionA64 cond, uint8_t op, uint8_t opc, int invert = 0);
+    void placeFCMP(const char* name, RegisterA64 src1, RegisterA64 src2, uint8_t op, uint8_t opc);
     void placeBC(const char* name, Label& label, uint8_t op, uint8_t cond);
     void placeBCR(const char* name, Label& label, uint8_t op, RegisterA64 cond);
     void placeBR(const char* name, RegisterA64 src, uint32_t op);
@@ -137,9 +182,11 @@ private:
     LUAU_NOINLINE void log(const char* opcode, RegisterA64 dst, RegisterA64 src);
     LUAU_NOINLINE void log(const char* opcode, RegisterA64 dst, int src, int shift = 0);
     LUAU_NOINLINE void log(const char* opcode, RegisterA64 dst, AddressA64 src);
+    LUAU_NOINLINE void log(const char* opcode, RegisterA64 dst1, RegisterA64 dst2, AddressA64 src);
     LUAU_NOINLINE void log(const char* opcode, RegisterA64 src, Label label);
     LUAU_NOINLINE void log(const char* opcode, RegisterA64 src);
     LUAU_NOINLINE void log(const char* opcode, Label label);
+    LUAU_NOINLINE void log(const char* opcode, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, ConditionA64 cond);
     LUAU_NOINLINE void log(Label label);
     LUAU_NOINLINE void log(RegisterA64 reg);
     LUAU_NOINLINE void log(AddressA64 addr);
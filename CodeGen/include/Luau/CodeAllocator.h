@@ -23,6 +23,20 @@ struct CodeAllocator
     // It's important to group functions together so that page alignment won't result in a lot of wasted space
     bool allocate(uint8_t* data, size_t dataSize, uint8_t* code, size_t codeSize, uint8_t*& result, size_t& resultSize, uint8_t*& resultCodeStart);
 
+    // Returns the pages of an allocation described by 'result' and 'resultSize' of 'allocate' so that they can be reused
+    // The code of the allocation must not be running anymore
+    // Blocks that are left without allocations are released together with their unwinding information
+    void deallocate(uint8_t* result, size_t resultSize);
+
+    // Bytes in allocated blocks that are occupied by allocations (with page alignment) and unwinding information
+    size_t getUsedSize() const;
+
+    // Bytes in allocated blocks that are available for new allocations
+    size_t getFreeSize() const;
+
+    // Part of the free bytes that are in ranges between allocations, these can only be reused by allocations that fit
+    size_t getFragmentedSize() const;
+
     // Provided to callbacks
     void* context = nullptr;
 
@@ -37,15 +51,30 @@ struct CodeAllocator
     // But to simplify block space checks, we limit the max size of all that data
     static const size_t kMaxReservedDataSize = 256;
 
-    bool allocateNewBlock(size_t& unwindInfoSize);
+    // Range of pages in a block that is available for allocations, offsets are in bytes from the start of the block
+    struct FreeRange
+    {
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    struct Block
+    {
+        uint8_t* memory = nullptr;
+        void* unwindInfo = nullptr;
+
+        // Space at the beginning of the block with unwinding information
+        size_t reservedSize = 0;
+
+        // Sorted by offset, adjacent ranges are merged together
+        std::vector<FreeRange> freeRanges;
+    };
 
-    // Current block we use for allocations
-    uint8_t* blockPos = nullptr;
-    uint8_t* blockEnd = nullptr;
+    bool allocateNewBlock();
+    void releaseBlock(size_t blockIndex);
 
     // All allocated blocks
-    std::vector<uint8_t*> blocks;
-    std::vector<void*> unwindInfos;
+    std::vector<Block> blocks;
 
     size_t blockSize = 0;
     size_t maxTotalSize = 0;
@@ -3,6 +3,9 @@
 
 #include <string>
 
+#include <stddef.h>
+#include <stdint.h>
+
 struct lua_State;
 
 namespace Luau
@@ -15,8 +18,75 @@ bool isSupported();
 void create(lua_State* L);
 
 // Builds target function and all inner functions
+// In tiered mode, functions are prepared for profiling instead and each one is built once it crosses one of the tiering thresholds
 void compile(lua_State* L, int idx);
 
+// Builds target function and all inner functions like 'compile' does without tiering, and returns the generated code in a form that can be
+// loaded by 'loadSerialized' in another process to skip compilation; the result is empty if no functions were compiled
+std::string compileSerialized(lua_State* L, int idx);
+
+// Loads native code produced by 'compileSerialized' for target function and all inner functions
+// Returns false without loading anything if the code was generated for different bytecode, CPU features or code generator version
+bool loadSerialized(lua_State* L, int idx, const char* data, size_t size);
+
+struct TieringOptions
+{
+    // When disabled, all functions are compiled by 'compile' up front
+    bool enabled = false;
+
+    // Functions running in the interpreter are compiled when they have been called or have executed loop back edges this many times
+    // Functions that are compiled on a loop back edge continue running in the interpreter until the next call
+    // Compilation happens synchronously on the thread that crosses the threshold, so the call or loop iteration that triggers it pays the full
+    // compilation latency of the function and its inner functions
+    uint32_t callThreshold = 16;
+    uint32_t loopThreshold = 1024;
+};
+
+struct TieringStats
+{
+    // Interpreter tier: functions that are currently profiled and the total number of events counted for all profiled functions
+    size_t profiledFunctions = 0;
+    uint64_t profiledCalls = 0;
+    uint64_t profiledLoopIterations = 0;
+
+    // Native tier: functions compiled up front, functions compiled after crossing a tiering threshold and functions loaded from serialized code
+    size_t compiledFunctions = 0;
+    size_t tieredFunctions = 0;
+    size_t loadedFunctions = 0;
+
+    // Functions that couldn't be compiled and remain in the interpreter
+    size_t failedFunctions = 0;
+
+    // Call instructions that were compiled with a guarded copy of the function they called while being profiled
+    size_t inlinedCalls = 0;
+
+    // Executable memory allocated for native code and its data, in bytes
+    size_t nativeCodeSize = 0;
+};
+
+// Enabling tiered mode affects functions passed to 'compile' afterwards, while new thresholds also apply to already profiled functions
+void setTieringOptions(lua_State* L, const TieringOptions& options);
+TieringOptions getTieringOptions(lua_State* L);
+
+TieringStats getTieringStats(lua_State* L);
+
+// Executable memory is reserved in blocks, and the code of functions is returned to the blocks after all functions compiled with it are destroyed
+// Blocks that don't have any code left are released
+struct CodeMemoryStats
+{
+    // Memory reserved for all blocks, in bytes
+    size_t totalSize = 0;
+
+    // Memory occupied by code, data and unwinding information, including page alignment
+    size_t usedSize = 0;
+
+    // Memory available for new code and the part of it that is located in gaps between code that is still used
+    size_t freeSize = 0;
+    size_t fragmentedSize = 0;
+};
+
+CodeMemoryStats getCodeMemoryStats(lua_State* L);
+
 using annotatorFn = void (*)(void* context, std::string& result, int fid, int instpos);
 
 struct AssemblyOptions
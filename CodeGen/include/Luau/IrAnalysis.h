@@ -1,16 +1,66 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
 namespace Luau
 {
 namespace CodeGen
 {
 
 struct IrFunction;
+struct CfgInfo;
 
 void updateUseCounts(IrFunction& function);
 
 void updateLastUseLocations(IrFunction& function);
 
+// Finds instruction results that are still live after an instruction that performs a call, when blocks are lowered in the specified order
+// Registers do not survive such calls, so these values have to be preserved in memory from the point where they are computed
+std::vector<uint8_t> findValuesLiveAcrossCalls(const IrFunction& function, const std::vector<uint32_t>& sortedBlocks);
+
+// Block operands of all instructions in a block are treated as edges, including the ones of guards that jump to fallback blocks
+void computeCfgInfo(IrFunction& function);
+
+struct BlockIteratorWrapper
+{
+    const uint32_t* itBegin = nullptr;
+    const uint32_t* itEnd = nullptr;
+
+    bool empty() const
+    {
+        return itBegin == itEnd;
+    }
+
+    size_t size() const
+    {
+        return size_t(itEnd - itBegin);
+    }
+
+    const uint32_t* begin() const
+    {
+        return itBegin;
+    }
+
+    const uint32_t* end() const
+    {
+        return itEnd;
+    }
+};
+
+BlockIteratorWrapper predecessors(const CfgInfo& cfg, uint32_t blockIdx);
+BlockIteratorWrapper successors(const CfgInfo& cfg, uint32_t blockIdx);
+
+// Returns blocks reachable from the function entry and from the blocks without predecessors in reverse postorder
+// Every block comes after all its predecessors, except for the ones that reach it through a loop back edge
+std::vector<uint32_t> getReversePostorder(const IrFunction& function);
+
+// Returns the immediate dominator of each block in the reverse postorder computed by the function above
+// Function entry, blocks without predecessors and blocks that are not in the order get ~0u
+std::vector<uint32_t> getImmediateDominators(const IrFunction& function, const std::vector<uint32_t>& order);
+
 } // namespace CodeGen
 } // namespace Luau
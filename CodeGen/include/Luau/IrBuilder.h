@@ -51,6 +51,8 @@ struct IrBuilder
     IrOp vmConst(uint32_t index);
     IrOp vmUpvalue(uint8_t index);
 
+    IrOp inlineCache(Proto* owner = nullptr); // Owner is the function the instruction belongs to when it isn't the function that is built
+
     bool inTerminatedBlock = false;
 
     bool activeFastcallFallback = false;
@@ -58,6 +60,9 @@ struct IrBuilder
 
     IrFunction function;
 
+    // Functions called by call instructions while the function was profiled, indexed by instruction; these calls can be inlined
+    std::vector<Proto*> callTargets;
+
     uint32_t activeBlockIdx = ~0u;
 
     std::vector<uint32_t> instIndexToBlock; // Block index at the bytecode instruction
@@ -5,6 +5,7 @@
 #include "Luau/RegisterX64.h"
 #include "Luau/RegisterA64.h"
 
+#include <bitset>
 #include <optional>
 #include <vector>
 
@@ -43,6 +44,11 @@ enum class IrCmd : uint8_t
     // A: Rn
     LOAD_INT,
 
+    // Load a float component of a vector from TValue as a double number
+    // A: Rn or Kn
+    // B: int (offset of the component from the start of TValue)
+    LOAD_FLOAT,
+
     // Load a TValue from memory
     // A: Rn or Kn or pointer (TValue)
     LOAD_TVALUE,
@@ -83,6 +89,11 @@ enum class IrCmd : uint8_t
     // B: int
     STORE_INT,
 
+    // Store a vector into TValue, components are converted to floats
+    // A: Rn
+    // B, C, D: double (x, y, z)
+    STORE_VECTOR,
+
     // Store a TValue into memory
     // A: Rn or pointer (TValue)
     // B: TValue
@@ -112,6 +123,22 @@ enum class IrCmd : uint8_t
     // A: double
     UNM_NUM,
 
+    // Add/Sub/Mul/Div two vectors, component-wise
+    // A, B: TValue (vector)
+    // Tag component of the result is undefined, TAG_VECTOR has to be used before the result is stored
+    ADD_VEC,
+    SUB_VEC,
+    MUL_VEC,
+    DIV_VEC,
+
+    // Negate a vector
+    // A: TValue (vector)
+    UNM_VEC,
+
+    // Set the vector tag in a TValue produced by vector arithmetic
+    // A: TValue
+    TAG_VECTOR,
+
     // Compute Luau 'not' operation on destructured TValue
     // A: tag
     // B: double
@@ -187,6 +214,10 @@ enum class IrCmd : uint8_t
     // A: int
     INT_TO_NUM,
 
+    // Convert a double number into a vector with all components set to that number
+    // A: double
+    NUM_TO_VEC,
+
     // Adjust stack top (L->top) to point at 'B' TValues *after* the specified register
     // This is used to return muliple values
     // A: Rn
@@ -227,6 +258,33 @@ enum class IrCmd : uint8_t
     // B: unsigned int (import path)
     GET_IMPORT,
 
+    // Lookup a string key in a table and the chain of its __index tables using the polymorphic inline cache of the instruction
+    // A: unsigned int (bytecode instruction index)
+    // B: Rn (where to store the result)
+    // C: Rn (table)
+    // D: Kn (key), or none when the instruction belongs to an inlined function
+    // E: unsigned int (inline cache index)
+    // F: block (fallback, when the table isn't a table or the lookup can't be completed without calling metamethods)
+    GET_FIELD_CACHED,
+
+    // Store a value into an existing string key of a table using the polymorphic inline cache of the instruction
+    // A: unsigned int (bytecode instruction index)
+    // B: Rn (value to store)
+    // C: Rn (table)
+    // D: Kn (key)
+    // E: unsigned int (inline cache index)
+    // F: block (fallback, when the key is absent or the table is read-only)
+    SET_FIELD_CACHED,
+
+    // Lookup a method like GET_FIELD_CACHED, storing the function into target register and the table into target register + 1
+    // A: unsigned int (bytecode instruction index)
+    // B: Rn (target)
+    // C: Rn (source)
+    // D: Kn (name)
+    // E: unsigned int (inline cache index)
+    // F: block (fallback, also taken when the method is nil)
+    GET_METHOD_CACHED,
+
     // Concatenate multiple TValues into a string
     // A: Rn (value start)
     // B: unsigned int (number of registers to go over)
@@ -283,10 +341,17 @@ enum class IrCmd : uint8_t
     // C: block
     CHECK_SLOT_MATCH,
 
+    // Guard against a closure not being an instance of the function that the call instruction called while it was profiled
+    // A: pointer (Closure)
+    // B: unsigned int (pcpos)
+    // C: block
+    CHECK_CALL_TARGET,
+
     // Special operations
 
     // Check interrupt handler
     // A: unsigned int (pcpos)
+    // B: block (optional, where execution continues after the handler has been called)
     INTERRUPT,
 
     // Check and run GC assist if necessary
@@ -310,6 +375,10 @@ enum class IrCmd : uint8_t
     // A: unsigned int (pcpos)
     SET_SAVEDPC,
 
+    // Leave native code and continue execution in the interpreter from the specified instruction
+    // A: unsigned int (pcpos)
+    EXIT_TO_VM,
+
     // Close open upvalues for registers at specified index or higher
     // A: Rn (starting register index)
     CLOSE_UPVALS,
@@ -604,6 +673,20 @@ struct IrBlock
     Label label;
 };
 
+// Control flow graph of the function, computed by 'computeCfgInfo'
+struct CfgInfo
+{
+    // Predecessors and successors of all blocks are stored in single arrays, offsets point to the first entry of each block
+    std::vector<uint32_t> predecessors;
+    std::vector<uint32_t> predecessorsOffsets;
+
+    std::vector<uint32_t> successors;
+    std::vector<uint32_t> successorsOffsets;
+
+    // VM registers captured by reference in closures created by the function
+    std::bitset<256> captured;
+};
+
 struct BytecodeMapping
 {
     uint32_t irLocation;
@@ -618,6 +701,17 @@ struct IrFunction
 
     std::vector<BytecodeMapping> bcMapping;
 
+    // Number of inline caches referenced by the *_CACHED instructions
+    uint32_t inlineCacheCount = 0;
+
+    // Function that contains the bytecode instruction of each inline cache, which differs from 'proto' for instructions of inlined calls
+    std::vector<Proto*> inlineCacheProtos;
+
+    // Number of call instructions that were translated together with the function they call
+    uint32_t inlinedCallCount = 0;
+
+    CfgInfo cfg;
+
     Proto* proto = nullptr;
 
     IrBlock& blockOp(IrOp op)
@@ -755,6 +849,13 @@ struct IrFunction
         LUAU_ASSERT(&block >= blocks.data() && &block <= blocks.data() + blocks.size());
         return uint32_t(&block - blocks.data());
     }
+
+    uint32_t getInstIndex(const IrInst& inst)
+    {
+        // Can only be called with instructions from our vector
+        LUAU_ASSERT(&inst >= instructions.data() && &inst <= instructions.data() + instructions.size());
+        return uint32_t(&inst - instructions.data());
+    }
 };
 
 } // namespace CodeGen
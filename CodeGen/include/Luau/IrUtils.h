@@ -104,6 +104,7 @@ inline bool isBlockTerminator(IrCmd cmd)
     case IrCmd::LOP_FORGLOOP_FALLBACK:
     case IrCmd::LOP_FORGPREP_XNEXT_FALLBACK:
     case IrCmd::FALLBACK_FORGPREP:
+    case IrCmd::EXIT_TO_VM:
         return true;
     default:
         break;
@@ -120,6 +121,7 @@ inline bool hasResult(IrCmd cmd)
     case IrCmd::LOAD_POINTER:
     case IrCmd::LOAD_DOUBLE:
     case IrCmd::LOAD_INT:
+    case IrCmd::LOAD_FLOAT:
     case IrCmd::LOAD_TVALUE:
     case IrCmd::LOAD_NODE_VALUE_TV:
     case IrCmd::LOAD_ENV:
@@ -134,12 +136,19 @@ inline bool hasResult(IrCmd cmd)
     case IrCmd::MOD_NUM:
     case IrCmd::POW_NUM:
     case IrCmd::UNM_NUM:
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    case IrCmd::UNM_VEC:
+    case IrCmd::TAG_VECTOR:
     case IrCmd::NOT_ANY:
     case IrCmd::TABLE_LEN:
     case IrCmd::NEW_TABLE:
     case IrCmd::DUP_TABLE:
     case IrCmd::NUM_TO_INDEX:
     case IrCmd::INT_TO_NUM:
+    case IrCmd::NUM_TO_VEC:
     case IrCmd::SUBSTITUTE:
         return true;
     default:
@@ -156,6 +165,77 @@ inline bool hasSideEffects(IrCmd cmd)
     return !hasResult(cmd);
 }
 
+// Instructions that may call into the runtime or use fixed registers as a part of their lowering
+// Values that are kept in registers across such instructions have to be preserved elsewhere
+inline bool performsCall(IrCmd cmd)
+{
+    switch (cmd)
+    {
+    case IrCmd::NOP:
+    case IrCmd::LOAD_TAG:
+    case IrCmd::LOAD_POINTER:
+    case IrCmd::LOAD_DOUBLE:
+    case IrCmd::LOAD_INT:
+    case IrCmd::LOAD_FLOAT:
+    case IrCmd::LOAD_TVALUE:
+    case IrCmd::LOAD_NODE_VALUE_TV:
+    case IrCmd::LOAD_ENV:
+    case IrCmd::GET_ARR_ADDR:
+    case IrCmd::GET_SLOT_NODE_ADDR:
+    case IrCmd::STORE_TAG:
+    case IrCmd::STORE_POINTER:
+    case IrCmd::STORE_DOUBLE:
+    case IrCmd::STORE_INT:
+    case IrCmd::STORE_VECTOR:
+    case IrCmd::STORE_TVALUE:
+    case IrCmd::STORE_NODE_VALUE_TV:
+    case IrCmd::ADD_INT:
+    case IrCmd::SUB_INT:
+    case IrCmd::ADD_NUM:
+    case IrCmd::SUB_NUM:
+    case IrCmd::MUL_NUM:
+    case IrCmd::DIV_NUM:
+    case IrCmd::MOD_NUM:
+    case IrCmd::UNM_NUM:
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    case IrCmd::UNM_VEC:
+    case IrCmd::TAG_VECTOR:
+    case IrCmd::NOT_ANY:
+    case IrCmd::JUMP:
+    case IrCmd::JUMP_IF_TRUTHY:
+    case IrCmd::JUMP_IF_FALSY:
+    case IrCmd::JUMP_EQ_TAG:
+    case IrCmd::JUMP_EQ_INT:
+    case IrCmd::JUMP_EQ_POINTER:
+    case IrCmd::JUMP_CMP_NUM:
+    case IrCmd::NUM_TO_INDEX:
+    case IrCmd::INT_TO_NUM:
+    case IrCmd::NUM_TO_VEC:
+    case IrCmd::ADJUST_STACK_TO_REG:
+    case IrCmd::ADJUST_STACK_TO_TOP:
+    case IrCmd::GET_UPVALUE:
+    case IrCmd::CHECK_TAG:
+    case IrCmd::CHECK_READONLY:
+    case IrCmd::CHECK_NO_METATABLE:
+    case IrCmd::CHECK_SAFE_ENV:
+    case IrCmd::CHECK_ARRAY_SIZE:
+    case IrCmd::CHECK_SLOT_MATCH:
+    case IrCmd::CHECK_CALL_TARGET:
+    case IrCmd::SET_SAVEDPC:
+    case IrCmd::CAPTURE:
+    case IrCmd::SUBSTITUTE:
+        return false;
+    default:
+        break;
+    }
+
+    // Everything else is assumed to call into the runtime
+    return true;
+}
+
 inline bool isPseudo(IrCmd cmd)
 {
     // Instructions that are used for internal needs and are not a part of final lowering
@@ -12,5 +12,8 @@ struct IrBuilder;
 
 void constPropInBlockChains(IrBuilder& build);
 
+// Propagates knowledge about VM registers across all control flow edges, including loop back edges
+void constPropInFunction(IrBuilder& build);
+
 } // namespace CodeGen
 } // namespace Luau
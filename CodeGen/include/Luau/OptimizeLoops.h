@@ -0,0 +1,18 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/IrData.h"
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+struct IrBuilder;
+
+// Checks guards on VM state that is not modified inside natural loops once in a preheader block that exits to the VM on failure
+// Facts established by the preheader are used by constant propagation to remove the original guards from the loop body
+void hoistLoopInvariantGuards(IrBuilder& build);
+
+} // namespace CodeGen
+} // namespace Luau
@@ -37,7 +37,18 @@ AssemblyBuilderA64::~AssemblyBuilderA64()
 
 void AssemblyBuilderA64::mov(RegisterA64 dst, RegisterA64 src)
 {
-    if (dst == sp || src == sp)
+    if (dst.kind == KindA64::q)
+    {
+        LUAU_ASSERT(src.kind == KindA64::q);
+
+        if (logText)
+            logAppend(" %-12sv%d.16b,v%d.16b\n", "mov", dst.index, src.index);
+
+        // orr dst.16b, src.16b, src.16b
+        place(dst.index | (src.index << 5) | (0b0'1'0'01110'10'1'00000'00011'1 << 10) | (src.index << 16));
+        commit();
+    }
+    else if (dst == sp || src == sp)
         placeR1("mov", dst, src, 0b00'100010'0'000000000000);
     else
         placeSR2("mov", dst, src, 0b01'01010);
@@ -92,6 +103,26 @@ void AssemblyBuilderA64::cmp(RegisterA64 src1, int src2)
     placeI12("cmp", dst, src1, src2, 0b11'10001);
 }
 
+void AssemblyBuilderA64::tst(RegisterA64 src1, RegisterA64 src2)
+{
+    RegisterA64 dst = src1.kind == KindA64::x ? xzr : wzr;
+
+    placeSR3("tst", dst, src1, src2, 0b11'01010);
+}
+
+void AssemblyBuilderA64::csel(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, ConditionA64 cond)
+{
+    placeCS("csel", dst, src1, src2, cond, 0b11010'10'0, 0b00);
+}
+
+void AssemblyBuilderA64::cset(RegisterA64 dst, ConditionA64 cond)
+{
+    RegisterA64 src = dst.kind == KindA64::x ? xzr : wzr;
+
+    // cset is an alias of csinc with inverted condition
+    placeCS("cset", dst, src, src, cond, 0b11010'10'0, 0b01, /* invert= */ 1);
+}
+
 void AssemblyBuilderA64::and_(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2)
 {
     placeSR3("and", dst, src1, src2, 0b00'01010);
@@ -144,65 +175,125 @@ void AssemblyBuilderA64::rbit(RegisterA64 dst, RegisterA64 src)
 
 void AssemblyBuilderA64::ldr(RegisterA64 dst, AddressA64 src)
 {
-    LUAU_ASSERT(dst.kind == KindA64::x || dst.kind == KindA64::w);
+    LUAU_ASSERT(dst.kind == KindA64::x || dst.kind == KindA64::w || dst.kind == KindA64::s || dst.kind == KindA64::d || dst.kind == KindA64::q);
 
-    placeA("ldr", dst, src, 0b11100001, 0b10 | uint8_t(dst.kind == KindA64::x));
+    switch (dst.kind)
+    {
+    case KindA64::w:
+        placeA("ldr", dst, src, 0b11100001, 0b10, 2);
+        break;
+    case KindA64::x:
+        placeA("ldr", dst, src, 0b11100001, 0b11, 3);
+        break;
+    case KindA64::s:
+        placeA("ldr", dst, src, 0b11110001, 0b10, 2);
+        break;
+    case KindA64::d:
+        placeA("ldr", dst, src, 0b11110001, 0b11, 3);
+        break;
+    case KindA64::q:
+        placeA("ldr", dst, src, 0b11110011, 0b00, 4);
+        break;
+    case KindA64::none:
+        LUAU_ASSERT(!"Unexpected register kind");
+    }
 }
 
 void AssemblyBuilderA64::ldrb(RegisterA64 dst, AddressA64 src)
 {
     LUAU_ASSERT(dst.kind == KindA64::w);
 
-    placeA("ldrb", dst, src, 0b11100001, 0b00);
+    placeA("ldrb", dst, src, 0b11100001, 0b00, 0);
 }
 
 void AssemblyBuilderA64::ldrh(RegisterA64 dst, AddressA64 src)
 {
     LUAU_ASSERT(dst.kind == KindA64::w);
 
-    placeA("ldrh", dst, src, 0b11100001, 0b01);
+    placeA("ldrh", dst, src, 0b11100001, 0b01, 1);
 }
 
 void AssemblyBuilderA64::ldrsb(RegisterA64 dst, AddressA64 src)
 {
     LUAU_ASSERT(dst.kind == KindA64::x || dst.kind == KindA64::w);
 
-    placeA("ldrsb", dst, src, 0b11100010 | uint8_t(dst.kind == KindA64::w), 0b00);
+    placeA("ldrsb", dst, src, 0b11100010 | uint8_t(dst.kind == KindA64::w), 0b00, 0);
 }
 
 void AssemblyBuilderA64::ldrsh(RegisterA64 dst, AddressA64 src)
 {
     LUAU_ASSERT(dst.kind == KindA64::x || dst.kind == KindA64::w);
 
-    placeA("ldrsh", dst, src, 0b11100010 | uint8_t(dst.kind == KindA64::w), 0b01);
+    placeA("ldrsh", dst, src, 0b11100010 | uint8_t(dst.kind == KindA64::w), 0b01, 1);
 }
 
 void AssemblyBuilderA64::ldrsw(RegisterA64 dst, AddressA64 src)
 {
     LUAU_ASSERT(dst.kind == KindA64::x);
 
-    placeA("ldrsw", dst, src, 0b11100010, 0b10);
+    placeA("ldrsw", dst, src, 0b11100010, 0b10, 2);
+}
+
+void AssemblyBuilderA64::ldp(RegisterA64 dst1, RegisterA64 dst2, AddressA64 src)
+{
+    LUAU_ASSERT(dst1.kind == KindA64::x || dst1.kind == KindA64::d);
+    LUAU_ASSERT(dst1.kind == dst2.kind);
+
+    if (dst1.kind == KindA64::x)
+        placeP("ldp", dst1, dst2, src, 0b101'0'010'1, 0b10, 3);
+    else
+        placeP("ldp", dst1, dst2, src, 0b101'1'010'1, 0b01, 3);
 }
 
 void AssemblyBuilderA64::str(RegisterA64 src, AddressA64 dst)
 {
-    LUAU_ASSERT(src.kind == KindA64::x || src.kind == KindA64::w);
+    LUAU_ASSERT(src.kind == KindA64::x || src.kind == KindA64::w || src.kind == KindA64::s || src.kind == KindA64::d || src.kind == KindA64::q);
 
-    placeA("str", src, dst, 0b11100000, 0b10 | uint8_t(src.kind == KindA64::x));
+    switch (src.kind)
+    {
+    case KindA64::w:
+        placeA("str", src, dst, 0b11100000, 0b10, 2);
+        break;
+    case KindA64::x:
+        placeA("str", src, dst, 0b11100000, 0b11, 3);
+        break;
+    case KindA64::s:
+        placeA("str", src, dst, 0b11110000, 0b10, 2);
+        break;
+    case KindA64::d:
+        placeA("str", src, dst, 0b11110000, 0b11, 3);
+        break;
+    case KindA64::q:
+        placeA("str", src, dst, 0b11110010, 0b00, 4);
+        break;
+    case KindA64::none:
+        LUAU_ASSERT(!"Unexpected register kind");
+    }
 }
 
 void AssemblyBuilderA64::strb(RegisterA64 src, AddressA64 dst)
 {
     LUAU_ASSERT(src.kind == KindA64::w);
 
-    placeA("strb", src, dst, 0b11100000, 0b00);
+    placeA("strb", src, dst, 0b11100000, 0b00, 0);
 }
 
 void AssemblyBuilderA64::strh(RegisterA64 src, AddressA64 dst)
 {
     LUAU_ASSERT(src.kind == KindA64::w);
 
-    placeA("strh", src, dst, 0b11100000, 0b01);
+    placeA("strh", src, dst, 0b11100000, 0b01, 1);
+}
+
+void AssemblyBuilderA64::stp(RegisterA64 src1, RegisterA64 src2, AddressA64 dst)
+{
+    LUAU_ASSERT(src1.kind == KindA64::x || src1.kind == KindA64::d);
+    LUAU_ASSERT(src1.kind == src2.kind);
+
+    if (src1.kind == KindA64::x)
+        placeP("stp", src1, src2, dst, 0b101'0'010'0, 0b10, 3);
+    else
+        placeP("stp", src1, src2, dst, 0b101'1'010'0, 0b01, 3);
 }
 
 void AssemblyBuilderA64::b(Label& label)
@@ -241,6 +332,192 @@ void AssemblyBuilderA64::ret()
     place0("ret", 0b1101011'0'0'10'11111'0000'0'0'11110'00000);
 }
 
+void AssemblyBuilderA64::fmov(RegisterA64 dst, RegisterA64 src)
+{
+    if (dst.kind == KindA64::d && src.kind == KindA64::d)
+        placeR1("fmov", dst, src, 0b000'11110'01'1'000000'10000);
+    else if (dst.kind == KindA64::d && src.kind == KindA64::x)
+        placeR1("fmov", dst, src, 0b1'00'11110'01'1'00'111'000000);
+    else if (dst.kind == KindA64::x && src.kind == KindA64::d)
+        placeR1("fmov", dst, src, 0b1'00'11110'01'1'00'110'000000);
+    else
+        LUAU_ASSERT(!"Unsupported fmov form");
+}
+
+void AssemblyBuilderA64::fabs(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::d && src.kind == KindA64::d);
+
+    placeR1("fabs", dst, src, 0b000'11110'01'1'000001'10000);
+}
+
+void AssemblyBuilderA64::fadd(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2)
+{
+    if (dst.kind == KindA64::q)
+    {
+        placeVR("fadd", dst, src1, src2, 0b0'1'0'01110'0'0'1, 0b11010'1);
+    }
+    else
+    {
+        LUAU_ASSERT(dst.kind == KindA64::d);
+
+        placeR3("fadd", dst, src1, src2, 0b11110'01'1, 0b0010'10);
+    }
+}
+
+void AssemblyBuilderA64::fdiv(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2)
+{
+    if (dst.kind == KindA64::q)
+    {
+        placeVR("fdiv", dst, src1, src2, 0b0'1'1'01110'0'0'1, 0b11111'1);
+    }
+    else
+    {
+        LUAU_ASSERT(dst.kind == KindA64::d);
+
+        placeR3("fdiv", dst, src1, src2, 0b11110'01'1, 0b0001'10);
+    }
+}
+
+void AssemblyBuilderA64::fmul(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2)
+{
+    if (dst.kind == KindA64::q)
+    {
+        placeVR("fmul", dst, src1, src2, 0b0'1'1'01110'0'0'1, 0b11011'1);
+    }
+    else
+    {
+        LUAU_ASSERT(dst.kind == KindA64::d);
+
+        placeR3("fmul", dst, src1, src2, 0b11110'01'1, 0b0000'10);
+    }
+}
+
+void AssemblyBuilderA64::fneg(RegisterA64 dst, RegisterA64 src)
+{
+    if (dst.kind == KindA64::q)
+    {
+        LUAU_ASSERT(src.kind == KindA64::q);
+
+        placeR1("fneg", dst, src, 0b0'1'1'01110'1'0'10000'01111'10);
+    }
+    else
+    {
+        LUAU_ASSERT(dst.kind == KindA64::d && src.kind == KindA64::d);
+
+        placeR1("fneg", dst, src, 0b000'11110'01'1'000010'10000);
+    }
+}
+
+void AssemblyBuilderA64::fsqrt(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::d && src.kind == KindA64::d);
+
+    placeR1("fsqrt", dst, src, 0b000'11110'01'1'000011'10000);
+}
+
+void AssemblyBuilderA64::fsub(RegisterA64 dst, RegisterA64 src1, RegisterA64 src2)
+{
+    if (dst.kind == KindA64::q)
+    {
+        placeVR("fsub", dst, src1, src2, 0b0'1'0'01110'1'0'1, 0b11010'1);
+    }
+    else
+    {
+        LUAU_ASSERT(dst.kind == KindA64::d);
+
+        placeR3("fsub", dst, src1, src2, 0b11110'01'1, 0b0011'10);
+    }
+}
+
+void AssemblyBuilderA64::frinta(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::d && src.kind == KindA64::d);
+
+    placeR1("frinta", dst, src, 0b000'11110'01'1'001100'10000);
+}
+
+void AssemblyBuilderA64::frintm(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::d && src.kind == KindA64::d);
+
+    placeR1("frintm", dst, src, 0b000'11110'01'1'001010'10000);
+}
+
+void AssemblyBuilderA64::frintp(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::d && src.kind == KindA64::d);
+
+    placeR1("frintp", dst, src, 0b000'11110'01'1'001001'10000);
+}
+
+void AssemblyBuilderA64::fcvt(RegisterA64 dst, RegisterA64 src)
+{
+    if (dst.kind == KindA64::d && src.kind == KindA64::s)
+        placeR1("fcvt", dst, src, 0b11110'00'1'0001'01'10000);
+    else if (dst.kind == KindA64::s && src.kind == KindA64::d)
+        placeR1("fcvt", dst, src, 0b11110'01'1'0001'00'10000);
+    else
+        LUAU_ASSERT(!"Unsupported fcvt form");
+}
+
+void AssemblyBuilderA64::fcvtzs(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::w || dst.kind == KindA64::x);
+    LUAU_ASSERT(src.kind == KindA64::d);
+
+    // sf bit is added by placeR1 based on destination register kind
+    placeR1("fcvtzs", dst, src, 0b000'11110'01'1'11'000'000000);
+}
+
+void AssemblyBuilderA64::scvtf(RegisterA64 dst, RegisterA64 src)
+{
+    LUAU_ASSERT(dst.kind == KindA64::d);
+    LUAU_ASSERT(src.kind == KindA64::w || src.kind == KindA64::x);
+
+    uint32_t sf = (src.kind == KindA64::x) ? 0b1'00'00000'00'0'00'000'000000 : 0;
+
+    placeR1("scvtf", dst, src, sf | 0b000'11110'01'1'00'010'000000);
+}
+
+void AssemblyBuilderA64::fcmp(RegisterA64 src1, RegisterA64 src2)
+{
+    LUAU_ASSERT(src1.kind == KindA64::d && src2.kind == KindA64::d);
+
+    placeFCMP("fcmp", src1, src2, 0b11110'01'1, 0b00);
+}
+
+void AssemblyBuilderA64::fcmpz(RegisterA64 src)
+{
+    LUAU_ASSERT(src.kind == KindA64::d);
+
+    placeFCMP("fcmp", src, RegisterA64{src.kind, 0}, 0b11110'01'1, 0b01);
+}
+
+void AssemblyBuilderA64::ins_4s(RegisterA64 dst, RegisterA64 src, uint8_t index)
+{
+    LUAU_ASSERT(dst.kind == KindA64::q && src.kind == KindA64::w);
+    LUAU_ASSERT(index < 4);
+
+    if (logText)
+        logAppend(" %-12sv%d.s[%d],w%d\n", "ins", dst.index, index, src.index);
+
+    place(dst.index | (src.index << 5) | (0b0'1'0'01110000'00100'0'0011'1 << 10) | (index << 19));
+    commit();
+}
+
+void AssemblyBuilderA64::dup_4s(RegisterA64 dst, RegisterA64 src, uint8_t index)
+{
+    LUAU_ASSERT(dst.kind == KindA64::q && (src.kind == KindA64::s || src.kind == KindA64::q));
+    LUAU_ASSERT(index < 4);
+
+    if (logText)
+        logAppend(" %-12sv%d.4s,v%d.s[%d]\n", "dup", dst.index, src.index, index);
+
+    place(dst.index | (src.index << 5) | (0b0'1'0'01110000'00100'0'0000'1 << 10) | (index << 19));
+    commit();
+}
+
 void AssemblyBuilderA64::adr(RegisterA64 dst, const void* ptr, size_t size)
 {
     size_t pos = allocateData(size, 4);
@@ -385,7 +662,7 @@ void AssemblyBuilderA64::placeR3(const char* name, RegisterA64 dst, RegisterA64
     if (logText)
         log(name, dst, src1, src2);
 
-    LUAU_ASSERT(dst.kind == KindA64::w || dst.kind == KindA64::x);
+    LUAU_ASSERT(dst.kind == KindA64::w || dst.kind == KindA64::x || dst.kind == KindA64::d);
     LUAU_ASSERT(dst.kind == src1.kind && dst.kind == src2.kind);
 
     uint32_t sf = (dst.kind == KindA64::x) ? 0x80000000 : 0;
@@ -399,15 +676,30 @@ void AssemblyBuilderA64::placeR1(const char* name, RegisterA64 dst, RegisterA64
     if (logText)
         log(name, dst, src);
 
-    LUAU_ASSERT(dst.kind == KindA64::w || dst.kind == KindA64::x || dst == sp);
-    LUAU_ASSERT(dst.kind == src.kind || (dst.kind == KindA64::x && src == sp) || (dst == sp && src.kind == KindA64::x));
+    LUAU_ASSERT(dst.kind == KindA64::w || dst.kind == KindA64::x || dst.kind == KindA64::s || dst.kind == KindA64::d || dst.kind == KindA64::q ||
+                dst == sp);
 
-    uint32_t sf = (dst.kind != KindA64::w) ? 0x80000000 : 0;
+    // Note: SIMD&FP forms can move data between register files, so their kind checks are performed by the caller
+    if (dst.kind != KindA64::d && src.kind != KindA64::d)
+        LUAU_ASSERT(dst.kind == src.kind || (dst.kind == KindA64::x && src == sp) || (dst == sp && src.kind == KindA64::x));
+
+    uint32_t sf = (dst.kind == KindA64::x || dst == sp) ? 0x80000000 : 0;
 
     place(dst.index | (src.index << 5) | (op << 10) | sf);
     commit();
 }
 
+void AssemblyBuilderA64::placeVR(const char* name, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, uint16_t op, uint8_t op2)
+{
+    if (logText)
+        log(name, dst, src1, src2);
+
+    LUAU_ASSERT(dst.kind == KindA64::q && dst.kind == src1.kind && dst.kind == src2.kind);
+
+    place(dst.index | (src1.index << 5) | (op2 << 10) | (src2.index << 16) | (op << 21));
+    commit();
+}
+
 void AssemblyBuilderA64::placeI12(const char* name, RegisterA64 dst, RegisterA64 src1, int src2, uint8_t op)
 {
     if (logText)
@@ -438,7 +730,7 @@ void AssemblyBuilderA64::placeI16(const char* name, RegisterA64 dst, int src, ui
     commit();
 }
 
-void AssemblyBuilderA64::placeA(const char* name, RegisterA64 dst, AddressA64 src, uint8_t op, uint8_t size)
+void AssemblyBuilderA64::placeA(const char* name, RegisterA64 dst, AddressA64 src, uint8_t op, uint8_t size, int sizelog)
 {
     if (logText)
         log(name, dst, src);
@@ -446,8 +738,8 @@ void AssemblyBuilderA64::placeA(const char* name, RegisterA64 dst, AddressA64 sr
     switch (src.kind)
     {
     case AddressKindA64::imm:
-        if (src.data >= 0 && src.data % (1 << size) == 0)
-            place(dst.index | (src.base.index << 5) | ((src.data >> size) << 10) | (op << 22) | (1 << 24) | (size << 30));
+        if (src.data >= 0 && (src.data >> sizelog) < 4096 && src.data % (1 << sizelog) == 0)
+            place(dst.index | (src.base.index << 5) | ((src.data >> sizelog) << 10) | (op << 22) | (1 << 24) | (size << 30));
         else if (src.data >= -256 && src.data <= 255)
             place(dst.index | (src.base.index << 5) | ((src.data & ((1 << 9) - 1)) << 12) | (op << 22) | (size << 30));
         else
@@ -461,6 +753,51 @@ void AssemblyBuilderA64::placeA(const char* name, RegisterA64 dst, AddressA64 sr
     commit();
 }
 
+void AssemblyBuilderA64::placeP(const char* name, RegisterA64 src1, RegisterA64 src2, AddressA64 dst, uint8_t op, uint8_t opc, int sizelog)
+{
+    if (logText)
+        log(name, src1, src2, dst);
+
+    LUAU_ASSERT(dst.kind == AddressKindA64::imm);
+    LUAU_ASSERT(dst.data >= -128 * (1 << sizelog) && dst.data <= 127 * (1 << sizelog));
+    LUAU_ASSERT(dst.data % (1 << sizelog) == 0);
+
+    place(src1.index | (dst.base.index << 5) | (src2.index << 10) | (((dst.data >> sizelog) & 127) << 15) | (op << 22) | (opc << 30));
+    commit();
+}
+
+void AssemblyBuilderA64::placeCS(
+    const char* name, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, ConditionA64 cond, uint8_t op, uint8_t opc, int invert)
+{
+    if (logText)
+        log(name, dst, src1, src2, cond);
+
+    LUAU_ASSERT(dst.kind == KindA64::w || dst.kind == KindA64::x);
+    LUAU_ASSERT(dst.kind == src1.kind && dst.kind == src2.kind);
+    LUAU_ASSERT(cond != ConditionA64::Always);
+
+    uint32_t sf = (dst.kind == KindA64::x) ? 0x80000000 : 0;
+
+    place(dst.index | (src1.index << 5) | (opc << 10) | ((codeForCondition[int(cond)] ^ invert) << 12) | (src2.index << 16) | (op << 21) | sf);
+    commit();
+}
+
+void AssemblyBuilderA64::placeFCMP(const char* name, RegisterA64 src1, RegisterA64 src2, uint8_t op, uint8_t opc)
+{
+    if (logText)
+    {
+        if (opc)
+            log(name, src1, 0);
+        else
+            log(name, src1, src2);
+    }
+
+    LUAU_ASSERT(src1.kind == KindA64::d && src2.kind == KindA64::d);
+
+    place((opc << 3) | (src1.index << 5) | (0b1000 << 10) | (src2.index << 16) | (op << 21));
+    commit();
+}
+
 void AssemblyBuilderA64::placeBC(const char* name, Label& label, uint8_t op, uint8_t cond)
 {
     place(cond | (op << 24));
@@ -626,6 +963,17 @@ void AssemblyBuilderA64::log(const char* opcode, RegisterA64 dst, AddressA64 src
     text.append("\n");
 }
 
+void AssemblyBuilderA64::log(const char* opcode, RegisterA64 dst1, RegisterA64 dst2, AddressA64 src)
+{
+    logAppend(" %-12s", opcode);
+    log(dst1);
+    text.append(",");
+    log(dst2);
+    text.append(",");
+    log(src);
+    text.append("\n");
+}
+
 void AssemblyBuilderA64::log(const char* opcode, RegisterA64 dst, RegisterA64 src)
 {
     logAppend(" %-12s", opcode);
@@ -666,6 +1014,22 @@ void AssemblyBuilderA64::log(const char* opcode, Label label)
     logAppend(" %-12s.L%d\n", opcode, label.id);
 }
 
+void AssemblyBuilderA64::log(const char* opcode, RegisterA64 dst, RegisterA64 src1, RegisterA64 src2, ConditionA64 cond)
+{
+    logAppend(" %-12s", opcode);
+    log(dst);
+    text.append(",");
+    if (src1 != xzr && src1 != wzr)
+    {
+        log(src1);
+        text.append(",");
+        log(src2);
+        text.append(",");
+    }
+    // Condition text is shared with conditional branches, so we skip the 'b.' prefix
+    logAppend("%s\n", textForCondition[int(cond)] + 2);
+}
+
 void AssemblyBuilderA64::log(Label label)
 {
     logAppend(".L%d:\n", label.id);
@@ -689,6 +1053,18 @@ void AssemblyBuilderA64::log(RegisterA64 reg)
             logAppend("x%d", reg.index);
         break;
 
+    case KindA64::s:
+        logAppend("s%d", reg.index);
+        break;
+
+    case KindA64::d:
+        logAppend("d%d", reg.index);
+        break;
+
+    case KindA64::q:
+        logAppend("q%d", reg.index);
+        break;
+
     case KindA64::none:
         if (reg.index == 31)
             text.append("sp");
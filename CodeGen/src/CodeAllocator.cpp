@@ -3,6 +3,8 @@
 
 #include "Luau/Common.h"
 
+#include <algorithm>
+
 #include <string.h>
 
 #if defined(_WIN32)
@@ -54,6 +56,16 @@ static void makePagesExecutable(uint8_t* mem, size_t size)
         LUAU_ASSERT(!"failed to change page protection");
 }
 
+static void makePagesWritable(uint8_t* mem, size_t size)
+{
+    LUAU_ASSERT((uintptr_t(mem) & (kPageSize - 1)) == 0);
+    LUAU_ASSERT(size == alignToPageSize(size));
+
+    DWORD oldProtect;
+    if (VirtualProtect(mem, size, PAGE_READWRITE, &oldProtect) == 0)
+        LUAU_ASSERT(!"failed to change page protection");
+}
+
 static void flushInstructionCache(uint8_t* mem, size_t size)
 {
     if (FlushInstructionCache(GetCurrentProcess(), mem, size) == 0)
@@ -80,6 +92,15 @@ static void makePagesExecutable(uint8_t* mem, size_t size)
         LUAU_ASSERT(!"failed to change page protection");
 }
 
+static void makePagesWritable(uint8_t* mem, size_t size)
+{
+    LUAU_ASSERT((uintptr_t(mem) & (kPageSize - 1)) == 0);
+    LUAU_ASSERT(size == alignToPageSize(size));
+
+    if (mprotect(mem, size, PROT_READ | PROT_WRITE) != 0)
+        LUAU_ASSERT(!"failed to change page protection");
+}
+
 static void flushInstructionCache(uint8_t* mem, size_t size)
 {
     __builtin___clear_cache((char*)mem, (char*)mem + size);
@@ -101,14 +122,8 @@ CodeAllocator::CodeAllocator(size_t blockSize, size_t maxTotalSize)
 
 CodeAllocator::~CodeAllocator()
 {
-    if (destroyBlockUnwindInfo)
-    {
-        for (void* unwindInfo : unwindInfos)
-            destroyBlockUnwindInfo(context, unwindInfo);
-    }
-
-    for (uint8_t* block : blocks)
-        freePages(block, blockSize);
+    while (!blocks.empty())
+        releaseBlock(blocks.size() - 1);
 }
 
 bool CodeAllocator::allocate(
@@ -123,87 +138,214 @@ bool CodeAllocator::allocate(
     if (totalSize > blockSize - kMaxReservedDataSize)
         return false;
 
+    // Pages freed by previous allocations are reused first, searching for the first range that fits
+    Block* block = nullptr;
+    size_t rangeIndex = 0;
     size_t startOffset = 0;
 
+    for (size_t i = 0; i < blocks.size() && !block; i++)
+    {
+        for (size_t j = 0; j < blocks[i].freeRanges.size(); j++)
+        {
+            const FreeRange& range = blocks[i].freeRanges[j];
+
+            // The first page of the block is shared with unwinding information
+            size_t start = range.offset == 0 ? blocks[i].reservedSize : range.offset;
+
+            if (start + totalSize <= range.offset + range.size)
+            {
+                block = &blocks[i];
+                rangeIndex = j;
+                startOffset = start;
+                break;
+            }
+        }
+    }
+
     // We might need a new block
-    if (totalSize > size_t(blockEnd - blockPos))
+    if (!block)
     {
-        if (!allocateNewBlock(startOffset))
+        if (!allocateNewBlock())
             return false;
 
-        LUAU_ASSERT(totalSize <= size_t(blockEnd - blockPos));
+        block = &blocks.back();
+        rangeIndex = 0;
+        startOffset = block->reservedSize;
+
+        LUAU_ASSERT(block->freeRanges.size() == 1 && startOffset + totalSize <= blockSize);
     }
 
-    LUAU_ASSERT((uintptr_t(blockPos) & (kPageSize - 1)) == 0); // Allocation starts on page boundary
+    FreeRange& range = block->freeRanges[rangeIndex];
+
+    LUAU_ASSERT((range.offset & (kPageSize - 1)) == 0); // Allocation starts on page boundary
 
     size_t dataOffset = startOffset + alignedDataSize - dataSize;
     size_t codeOffset = startOffset + alignedDataSize;
 
     if (dataSize)
-        memcpy(blockPos + dataOffset, data, dataSize);
+        memcpy(block->memory + dataOffset, data, dataSize);
     if (codeSize)
-        memcpy(blockPos + codeOffset, code, codeSize);
+        memcpy(block->memory + codeOffset, code, codeSize);
 
-    size_t pageAlignedSize = alignToPageSize(startOffset + totalSize);
+    size_t pageAlignedSize = alignToPageSize(startOffset + totalSize) - range.offset;
 
-    makePagesExecutable(blockPos, pageAlignedSize);
-    flushInstructionCache(blockPos + codeOffset, codeSize);
+    makePagesExecutable(block->memory + range.offset, pageAlignedSize);
+    flushInstructionCache(block->memory + codeOffset, codeSize);
 
-    result = blockPos + startOffset;
+    result = block->memory + startOffset;
     resultSize = totalSize;
-    resultCodeStart = blockPos + codeOffset;
+    resultCodeStart = block->memory + codeOffset;
 
     // Ensure that future allocations from the block start from a page boundary.
     // This is important since we use W^X, and writing to the previous page would require briefly removing
     // executable bit from it, which may result in access violations if that code is being executed concurrently.
-    if (pageAlignedSize <= size_t(blockEnd - blockPos))
+    if (pageAlignedSize < range.size)
     {
-        blockPos += pageAlignedSize;
-        LUAU_ASSERT((uintptr_t(blockPos) & (kPageSize - 1)) == 0);
-        LUAU_ASSERT(blockPos <= blockEnd);
+        range.offset += pageAlignedSize;
+        range.size -= pageAlignedSize;
     }
     else
     {
-        // Future allocations will need to allocate fresh blocks
-        blockPos = blockEnd;
+        block->freeRanges.erase(block->freeRanges.begin() + rangeIndex);
     }
 
     return true;
 }
 
-bool CodeAllocator::allocateNewBlock(size_t& unwindInfoSize)
+void CodeAllocator::deallocate(uint8_t* result, size_t resultSize)
+{
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        Block& block = blocks[i];
+
+        if (result < block.memory || result >= block.memory + blockSize)
+            continue;
+
+        // Allocation covers all pages it touches, the first page of the block also holds unwinding information
+        size_t offset = size_t(result - block.memory) & ~(kPageSize - 1);
+        size_t size = std::min(alignToPageSize(size_t(result - block.memory) + resultSize), blockSize) - offset;
+
+        // Freed pages can't be executed and are ready to be written to by the next allocation
+        makePagesWritable(block.memory + offset, alignToPageSize(size));
+
+        auto it = std::lower_bound(block.freeRanges.begin(), block.freeRanges.end(), offset, [](const FreeRange& range, size_t offset) {
+            return range.offset < offset;
+        });
+
+        LUAU_ASSERT(it == block.freeRanges.end() || offset + size <= it->offset);
+        LUAU_ASSERT(it == block.freeRanges.begin() || std::prev(it)->offset + std::prev(it)->size <= offset);
+
+        it = block.freeRanges.insert(it, FreeRange{offset, size});
+
+        // Merge with the following and the preceding ranges
+        if (std::next(it) != block.freeRanges.end() && it->offset + it->size == std::next(it)->offset)
+        {
+            it->size += std::next(it)->size;
+            block.freeRanges.erase(std::next(it));
+        }
+
+        if (it != block.freeRanges.begin() && std::prev(it)->offset + std::prev(it)->size == it->offset)
+        {
+            std::prev(it)->size += it->size;
+            it = block.freeRanges.erase(it);
+        }
+
+        if (block.freeRanges.size() == 1 && block.freeRanges[0].offset == 0 && block.freeRanges[0].size == blockSize)
+            releaseBlock(i);
+
+        return;
+    }
+
+    LUAU_ASSERT(!"deallocating memory that doesn't belong to the allocator");
+}
+
+size_t CodeAllocator::getUsedSize() const
+{
+    return blocks.size() * blockSize - getFreeSize();
+}
+
+size_t CodeAllocator::getFreeSize() const
+{
+    size_t result = 0;
+
+    for (const Block& block : blocks)
+    {
+        for (const FreeRange& range : block.freeRanges)
+            result += range.offset == 0 ? range.size - block.reservedSize : range.size;
+    }
+
+    return result;
+}
+
+size_t CodeAllocator::getFragmentedSize() const
+{
+    size_t result = 0;
+
+    for (const Block& block : blocks)
+    {
+        for (const FreeRange& range : block.freeRanges)
+        {
+            // Space at the end of the block is not considered to be fragmented
+            if (range.offset + range.size != blockSize)
+                result += range.offset == 0 ? range.size - block.reservedSize : range.size;
+        }
+    }
+
+    return result;
+}
+
+bool CodeAllocator::allocateNewBlock()
 {
     // Stop allocating once we reach a global limit
     if ((blocks.size() + 1) * blockSize > maxTotalSize)
         return false;
 
-    uint8_t* block = allocatePages(blockSize);
+    uint8_t* memory = allocatePages(blockSize);
 
-    if (!block)
+    if (!memory)
         return false;
 
-    blockPos = block;
-    blockEnd = block + blockSize;
-
-    blocks.push_back(block);
+    Block block;
+    block.memory = memory;
 
     if (createBlockUnwindInfo)
     {
-        void* unwindInfo = createBlockUnwindInfo(context, block, blockSize, unwindInfoSize);
+        size_t unwindInfoSize = 0;
+        void* unwindInfo = createBlockUnwindInfo(context, memory, blockSize, unwindInfoSize);
+
+        if (!unwindInfo)
+        {
+            freePages(memory, blockSize);
+            return false;
+        }
 
         // 'Round up' to preserve alignment of the following data and code
         unwindInfoSize = (unwindInfoSize + (kCodeAlignment - 1)) & ~(kCodeAlignment - 1);
 
         LUAU_ASSERT(unwindInfoSize <= kMaxReservedDataSize);
 
-        if (!unwindInfo)
-            return false;
-
-        unwindInfos.push_back(unwindInfo);
+        block.unwindInfo = unwindInfo;
+        block.reservedSize = unwindInfoSize;
     }
 
+    block.freeRanges.push_back(FreeRange{0, blockSize});
+
+    blocks.push_back(std::move(block));
+
     return true;
 }
 
+void CodeAllocator::releaseBlock(size_t blockIndex)
+{
+    Block& block = blocks[blockIndex];
+
+    if (block.unwindInfo && destroyBlockUnwindInfo)
+        destroyBlockUnwindInfo(context, block.unwindInfo);
+
+    freePages(block.memory, blockSize);
+
+    blocks.erase(blocks.begin() + blockIndex);
+}
+
 } // namespace CodeGen
 } // namespace Luau
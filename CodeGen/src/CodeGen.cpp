@@ -9,6 +9,7 @@
 #include "Luau/IrBuilder.h"
 #include "Luau/OptimizeConstProp.h"
 #include "Luau/OptimizeFinalX64.h"
+#include "Luau/OptimizeLoops.h"
 #include "Luau/UnwindBuilder.h"
 #include "Luau/UnwindBuilderDwarf2.h"
 #include "Luau/UnwindBuilderWin.h"
@@ -18,10 +19,12 @@
 #include "EmitCommonX64.h"
 #include "EmitInstructionX64.h"
 #include "IrLoweringX64.h"
+#include "NativeCache.h"
 #include "NativeState.h"
 
 #include "lapi.h"
 
+#include <algorithm>
 #include <memory>
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -59,6 +62,13 @@ static void assembleHelpers(AssemblyBuilderX64& build, ModuleHelpers& helpers)
     emitContinueCallInVm(build);
 }
 
+static void initInlineCache(InlineCache& cache, Proto* proto, uint32_t pcpos)
+{
+    // Key is the constant referenced by the AUX word of GETTABLEKS, SETTABLEKS and NAMECALL
+    cache.pc = proto->code + pcpos;
+    cache.key = tsvalue(&proto->k[proto->code[pcpos + 1]]);
+}
+
 static NativeProto* assembleFunction(AssemblyBuilderX64& build, NativeState& data, ModuleHelpers& helpers, Proto* proto, AssemblyOptions options)
 {
     NativeProto* result = new NativeProto();
@@ -83,11 +93,22 @@ static NativeProto* assembleFunction(AssemblyBuilderX64& build, NativeState& dat
     Label start = build.setLabel();
 
     IrBuilder builder;
+
+    // Functions that were profiled in the interpreter have their call targets recorded
+    if (NativeProto* profile = getProtoExecData(proto); profile && profile->callTargets)
+    {
+        builder.callTargets.resize(proto->sizecode);
+
+        for (int i = 0; i < proto->sizecode; i++)
+            builder.callTargets[i] = profile->callTargets[i].polymorphic ? nullptr : profile->callTargets[i].proto;
+    }
+
     builder.buildFunctionIr(proto);
 
     if (!FFlag::DebugCodegenNoOpt)
     {
-        constPropInBlockChains(builder);
+        hoistLoopInvariantGuards(builder);
+        constPropInFunction(builder);
     }
 
     optimizeMemoryOperandsX64(builder.function);
@@ -96,6 +117,12 @@ static NativeProto* assembleFunction(AssemblyBuilderX64& build, NativeState& dat
 
     lowering.lower(options);
 
+    if (lowering.hasError())
+    {
+        delete result;
+        return nullptr;
+    }
+
     result->instTargets = new uintptr_t[proto->sizecode];
 
     for (int i = 0; i < proto->sizecode; i++)
@@ -107,6 +134,23 @@ static NativeProto* assembleFunction(AssemblyBuilderX64& build, NativeState& dat
 
     result->location = start.location;
 
+    if (builder.function.inlineCacheCount != 0)
+    {
+        result->inlineCaches = new InlineCache[builder.function.inlineCacheCount];
+        result->inlineCacheCount = builder.function.inlineCacheCount;
+
+        for (const IrInst& inst : builder.function.instructions)
+        {
+            if (inst.cmd == IrCmd::GET_FIELD_CACHED || inst.cmd == IrCmd::SET_FIELD_CACHED || inst.cmd == IrCmd::GET_METHOD_CACHED)
+            {
+                uint32_t index = builder.function.uintOp(inst.e);
+                initInlineCache(result->inlineCaches[index], builder.function.inlineCacheProtos[index], builder.function.uintOp(inst.a));
+            }
+        }
+    }
+
+    data.tieringStats.inlinedCalls += builder.function.inlinedCallCount;
+
     if (build.logText)
         build.logAppend("\n");
 
@@ -116,6 +160,8 @@ static NativeProto* assembleFunction(AssemblyBuilderX64& build, NativeState& dat
 static void destroyNativeProto(NativeProto* nativeProto)
 {
     delete[] nativeProto->instTargets;
+    delete[] nativeProto->inlineCaches;
+    delete[] nativeProto->callTargets;
     delete nativeProto;
 }
 
@@ -124,40 +170,291 @@ static void onCloseState(lua_State* L)
     destroyNativeState(L);
 }
 
+static NativeAllocation* createNativeAllocation(uint8_t* data, size_t size, uint32_t refs)
+{
+    NativeAllocation* allocation = new NativeAllocation();
+    allocation->data = data;
+    allocation->size = size;
+    allocation->refs = refs;
+    return allocation;
+}
+
+static void releaseNativeAllocation(NativeState& data, NativeAllocation* allocation)
+{
+    LUAU_ASSERT(allocation->refs > 0);
+
+    if (--allocation->refs != 0)
+        return;
+
+    data.codeAllocator.deallocate(allocation->data, allocation->size);
+    data.tieringStats.nativeCodeSize -= allocation->size;
+
+    delete allocation;
+}
+
+static void removeCallTargetRef(NativeState& data, CallTarget* target)
+{
+    auto it = data.callTargetRefs.find(target->proto);
+    LUAU_ASSERT(it != data.callTargetRefs.end());
+
+    std::vector<CallTarget*>& refs = it->second;
+    refs.erase(std::find(refs.begin(), refs.end(), target));
+
+    if (refs.empty())
+        data.callTargetRefs.erase(it);
+}
+
+// Called when the profile of a function is destroyed, functions it has called no longer need to update its entries
+static void releaseCallTargets(NativeState& data, NativeProto* nativeProto)
+{
+    if (!nativeProto->callTargets)
+        return;
+
+    for (int i = 0; i < nativeProto->proto->sizecode; i++)
+    {
+        if (nativeProto->callTargets[i].proto)
+            removeCallTargetRef(data, &nativeProto->callTargets[i]);
+    }
+
+    delete[] nativeProto->callTargets;
+    nativeProto->callTargets = nullptr;
+}
+
+// Called when a function can't be tracked anymore, native code that inlined it will perform the call instead
+static void resetCallTargetRefs(NativeState& data, Proto* proto)
+{
+    auto it = data.callTargetRefs.find(proto);
+
+    if (it == data.callTargetRefs.end())
+        return;
+
+    for (CallTarget* target : it->second)
+    {
+        target->proto = nullptr;
+        target->polymorphic = true;
+    }
+
+    data.callTargetRefs.erase(it);
+}
+
+// Remembers the function called by a call instruction of a profiled function running in the interpreter
+static void profileCallTarget(lua_State* L, NativeState& data, Proto* proto)
+{
+    if (L->ci == L->base_ci)
+        return;
+
+    CallInfo* ci = L->ci - 1;
+
+    if (!isLua(ci) || !ci->savedpc)
+        return;
+
+    Proto* caller = clvalue(ci->func)->l.p;
+    NativeProto* nativeProto = getProtoExecData(caller);
+
+    if (!nativeProto || nativeProto->entryTarget)
+        return;
+
+    int pcpos = int(ci->savedpc - caller->code) - 1;
+
+    if (pcpos < 0 || pcpos >= caller->sizecode || LUAU_INSN_OP(caller->code[pcpos]) != LOP_CALL)
+        return;
+
+    if (!nativeProto->callTargets)
+        nativeProto->callTargets = new CallTarget[caller->sizecode];
+
+    CallTarget& target = nativeProto->callTargets[pcpos];
+
+    if (target.polymorphic || target.proto == proto)
+        return;
+
+    if (target.proto)
+    {
+        removeCallTargetRef(data, &target);
+
+        target.proto = nullptr;
+        target.polymorphic = true;
+        return;
+    }
+
+    target.proto = proto;
+    data.callTargetRefs[proto].push_back(&target);
+}
+
 static void onDestroyFunction(lua_State* L, Proto* proto)
 {
     NativeProto* nativeProto = getProtoExecData(proto);
     LUAU_ASSERT(nativeProto->proto == proto);
 
+    NativeState* data = getNativeState(L);
+    LUAU_ASSERT(data);
+
+    if (!nativeProto->entryTarget)
+        data->tieringStats.profiledFunctions--;
+
+    // Function can't be running anymore, so its code can be freed after all other functions compiled together with it
+    if (nativeProto->allocation && data)
+        releaseNativeAllocation(*data, nativeProto->allocation);
+
+    if (data)
+    {
+        releaseCallTargets(*data, nativeProto);
+        resetCallTargetRefs(*data, proto);
+    }
+
     setProtoExecData(proto, nullptr);
     destroyNativeProto(nativeProto);
 }
 
+// Functions that can't be compiled stop being profiled so that the interpreter doesn't call into the tiering callbacks for them
+static void stopProfiling(NativeState& data, Proto* proto)
+{
+    NativeProto* nativeProto = getProtoExecData(proto);
+    LUAU_ASSERT(nativeProto && !nativeProto->entryTarget);
+
+    data.tieringStats.profiledFunctions--;
+
+    releaseCallTargets(data, nativeProto);
+    resetCallTargetRefs(data, proto);
+
+    setProtoExecData(proto, nullptr);
+    destroyNativeProto(nativeProto);
+}
+
+static void compileFunctions(NativeState& data, const std::vector<Proto*>& protos, bool tiered, SerializedModule* serialized = nullptr);
+
+static bool tierUp(lua_State* L, Proto* proto)
+{
+    NativeState* data = getNativeState(L);
+
+    if (!data)
+        return false;
+
+    compileFunctions(*data, {proto}, /* tiered */ true);
+
+    NativeProto* nativeProto = getProtoExecData(proto);
+    return nativeProto && nativeProto->entryTarget;
+}
+
+// Counts a call to a function that is running in the interpreter and compiles it once the call count reaches the threshold
+// Returns true if the function has native code now
+static bool profileCall(lua_State* L, NativeState& data, Proto* proto)
+{
+    NativeProto* nativeProto = getProtoExecData(proto);
+    LUAU_ASSERT(nativeProto && !nativeProto->entryTarget);
+
+    data.tieringStats.profiledCalls++;
+
+    if (++nativeProto->callCount < data.tieringOptions.callThreshold)
+        return false;
+
+    return tierUp(L, proto);
+}
+
+static bool isLoopInterruptInstruction(Instruction insn)
+{
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_JUMPBACK:
+    case LOP_JUMPX:
+    case LOP_FORNLOOP:
+    case LOP_FORGLOOP:
+        return true;
+    default:
+        return false;
+    }
+}
+
 static int onEnter(lua_State* L, Proto* proto)
 {
     if (L->singlestep)
+    {
+        L->ci->flags |= LUA_CALLINFO_INTERPRETED;
         return 1;
+    }
 
     NativeState* data = getNativeState(L);
 
+    bool isCall = !L->ci->savedpc || L->ci->savedpc == proto->code;
+
     if (!L->ci->savedpc)
         L->ci->savedpc = proto->code;
 
+    if (isCall)
+        profileCallTarget(L, *data, proto);
+
+    // Functions that haven't been compiled yet run in the interpreter until they are called often enough
+    if (!getProtoExecData(proto)->entryTarget && !(isCall && profileCall(L, *data, proto)))
+    {
+        L->ci->flags |= LUA_CALLINFO_INTERPRETED;
+        return 1;
+    }
+
+    // Native code relies on knowledge about register types that is carried across loop iterations and through interrupts
+    // Frames that were running in the interpreter could have reached such an instruction on a path native code doesn't have
+    if ((L->ci->flags & LUA_CALLINFO_INTERPRETED) && isLoopInterruptInstruction(*L->ci->savedpc))
+        return 1;
+
     // We will jump into native code through a gateway
     bool (*gate)(lua_State*, Proto*, uintptr_t, NativeContext*) = (bool (*)(lua_State*, Proto*, uintptr_t, NativeContext*))data->context.gateEntry;
 
+    for (;;)
+    {
+        NativeProto* nativeProto = getProtoExecData(proto);
+        uintptr_t target = nativeProto->instTargets[L->ci->savedpc - proto->code];
+
+        // Returns 1 to finish the function in the VM
+        if (!gate(L, proto, target, &data->context))
+            return 0;
+
+        // Native code hands calls to functions that haven't been compiled yet over to the VM, which doesn't call 'enter' for them
+        if (!isLua(L->ci))
+            break;
+
+        Proto* callee = clvalue(L->ci->func)->l.p;
+        NativeProto* calleeData = getProtoExecData(callee);
+
+        if (callee == proto || L->ci->savedpc != callee->code || !calleeData || calleeData->entryTarget || !profileCall(L, *data, callee))
+            break;
+
+        proto = callee;
+    }
+
+    L->ci->flags |= LUA_CALLINFO_INTERPRETED;
+    return 1;
+}
+
+static void onLoop(lua_State* L, Proto* proto)
+{
+    NativeState* data = getNativeState(L);
     NativeProto* nativeProto = getProtoExecData(proto);
-    uintptr_t target = nativeProto->instTargets[L->ci->savedpc - proto->code];
 
-    // Returns 1 to finish the function in the VM
-    return gate(L, proto, target, &data->context);
+    // Compiled functions can still run in the interpreter, but that doesn't need to be counted
+    if (nativeProto->entryTarget)
+        return;
+
+    data->tieringStats.profiledLoopIterations++;
+
+    if (++nativeProto->loopCount < data->tieringOptions.loopThreshold)
+        return;
+
+    // The frame that is running the loop can't enter native code at a back edge and will finish in the interpreter
+    tierUp(L, proto);
 }
 
 static void onSetBreakpoint(lua_State* L, Proto* proto, int instruction)
 {
-    if (!getProtoExecData(proto))
+    NativeProto* nativeProto = getProtoExecData(proto);
+
+    if (!nativeProto)
         return;
 
+    // Functions with breakpoints are never compiled
+    if (!nativeProto->entryTarget)
+    {
+        stopProfiling(*getNativeState(L), proto);
+        return;
+    }
+
     LUAU_ASSERT(!"native breakpoints are not implemented");
 }
 
@@ -224,6 +521,7 @@ void create(lua_State* L)
     ecb->close = onCloseState;
     ecb->destroy = onDestroyFunction;
     ecb->enter = onEnter;
+    ecb->loop = onLoop;
     ecb->setbreakpoint = onSetBreakpoint;
 }
 
@@ -242,20 +540,10 @@ static void gatherFunctions(std::vector<Proto*>& results, Proto* proto)
         gatherFunctions(results, proto->p[i]);
 }
 
-void compile(lua_State* L, int idx)
+// When 'serialized' is provided, the generated code and the locations of functions are stored in it as well
+static void compileFunctions(NativeState& data, const std::vector<Proto*>& protos, bool tiered, SerializedModule* serialized)
 {
-    LUAU_ASSERT(lua_isLfunction(L, idx));
-    const TValue* func = luaA_toobject(L, idx);
-
-    // If initialization has failed, do not compile any functions
-    if (!getNativeState(L))
-        return;
-
     AssemblyBuilderX64 build(/* logText= */ false);
-    NativeState* data = getNativeState(L);
-
-    std::vector<Proto*> protos;
-    gatherFunctions(protos, clvalue(func)->l.p);
 
     ModuleHelpers helpers;
     assembleHelpers(build, helpers);
@@ -263,25 +551,76 @@ void compile(lua_State* L, int idx)
     std::vector<NativeProto*> results;
     results.reserve(protos.size());
 
-    // Skip protos that have been compiled during previous invocations of CodeGen::compile
     for (Proto* p : protos)
-        if (p && getProtoExecData(p) == nullptr)
-            results.push_back(assembleFunction(build, *data, helpers, p, {}));
+    {
+        // Functions that couldn't be lowered are left to the interpreter
+        if (NativeProto* nativeProto = assembleFunction(build, data, helpers, p, {}))
+            results.push_back(nativeProto);
+        else
+        {
+            if (tiered)
+                stopProfiling(data, p);
+
+            data.tieringStats.failedFunctions++;
+        }
+    }
 
-    build.finalize();
+    // Finalization can fail when some of the branch targets are out of range
+    bool success = build.finalize();
+
+    // Nothing to place into executable memory when none of the functions could be compiled
+    if (results.empty())
+        return;
 
     uint8_t* nativeData = nullptr;
     size_t sizeNativeData = 0;
     uint8_t* codeStart = nullptr;
-    if (!data->codeAllocator.allocate(
-            build.data.data(), int(build.data.size()), build.code.data(), int(build.code.size()), nativeData, sizeNativeData, codeStart))
+    if (success && !data.codeAllocator.allocate(build.data.data(), int(build.data.size()), reinterpret_cast<uint8_t*>(build.code.data()),
+                       int(build.code.size() * sizeof(build.code[0])), nativeData, sizeNativeData, codeStart))
+        success = false;
+
+    if (!success)
     {
         for (NativeProto* result : results)
+        {
+            if (tiered)
+                stopProfiling(data, result->proto);
+
             destroyNativeProto(result);
+        }
 
+        data.tieringStats.failedFunctions += results.size();
         return;
     }
 
+    data.tieringStats.nativeCodeSize += sizeNativeData;
+
+    NativeAllocation* allocation = createNativeAllocation(nativeData, sizeNativeData, uint32_t(results.size()));
+
+    if (serialized)
+    {
+        LUAU_ASSERT(!tiered);
+
+        serialized->data.assign(build.data.begin(), build.data.end());
+        serialized->code.assign(reinterpret_cast<uint8_t*>(build.code.data()), reinterpret_cast<uint8_t*>(build.code.data() + build.code.size()));
+
+        for (NativeProto* result : results)
+        {
+            SerializedFunction& function = serialized->functions.emplace_back();
+
+            function.bytecodeId = uint32_t(result->proto->bytecodeid);
+            function.location = result->location;
+            function.instOffsets.assign(result->instTargets, result->instTargets + result->proto->sizecode);
+
+            for (uint32_t i = 0; i < result->inlineCacheCount; i++)
+            {
+                const Instruction* pc = result->inlineCaches[i].pc;
+
+                function.inlineCachePcs.push_back(pc ? uint32_t(pc - result->proto->code) : ~0u);
+            }
+        }
+    }
+
     // Relocate instruction offsets
     for (NativeProto* result : results)
     {
@@ -290,11 +629,269 @@ void compile(lua_State* L, int idx)
 
         LUAU_ASSERT(result->proto->sizecode);
         result->entryTarget = result->instTargets[0];
+        result->allocation = allocation;
     }
 
     // Link native proto objects to Proto; the memory is now managed by VM and will be freed via onDestroyFunction
     for (NativeProto* result : results)
-        setProtoExecData(result->proto, result);
+    {
+        if (tiered)
+        {
+            // Profiled functions keep their execdata object since the VM and the tiering callbacks might be holding on to it
+            NativeProto* profile = getProtoExecData(result->proto);
+
+            profile->instTargets = result->instTargets;
+            profile->location = result->location;
+            profile->inlineCaches = result->inlineCaches;
+            profile->inlineCacheCount = result->inlineCacheCount;
+            profile->allocation = result->allocation;
+            profile->entryTarget = result->entryTarget;
+
+            result->instTargets = nullptr;
+            result->inlineCaches = nullptr;
+            destroyNativeProto(result);
+
+            data.tieringStats.profiledFunctions--;
+            data.tieringStats.tieredFunctions++;
+        }
+        else
+        {
+            setProtoExecData(result->proto, result);
+
+            data.tieringStats.compiledFunctions++;
+        }
+    }
+}
+
+void compile(lua_State* L, int idx)
+{
+    LUAU_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    // If initialization has failed, do not compile any functions
+    if (!getNativeState(L))
+        return;
+
+    NativeState* data = getNativeState(L);
+
+    std::vector<Proto*> protos;
+    gatherFunctions(protos, clvalue(func)->l.p);
+
+    // Skip protos that have been compiled or prepared for profiling during previous invocations of CodeGen::compile
+    std::vector<Proto*> pending;
+
+    for (Proto* p : protos)
+        if (p && getProtoExecData(p) == nullptr)
+            pending.push_back(p);
+
+    if (!data->tieringOptions.enabled)
+    {
+        compileFunctions(*data, pending, /* tiered */ false);
+        return;
+    }
+
+    for (Proto* p : pending)
+    {
+        NativeProto* profile = new NativeProto();
+        profile->proto = p;
+
+        setProtoExecData(p, profile);
+
+        data->tieringStats.profiledFunctions++;
+    }
+}
+
+static uint32_t getSerializedFlags()
+{
+    // Code generation options that change the generated code
+    return FFlag::DebugCodegenNoOpt ? 1 : 0;
+}
+
+std::string compileSerialized(lua_State* L, int idx)
+{
+    LUAU_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    NativeState* data = getNativeState(L);
+
+    if (!data)
+        return std::string();
+
+    std::vector<Proto*> protos;
+    gatherFunctions(protos, clvalue(func)->l.p);
+
+    // Functions are compiled right away even in tiered mode
+    std::vector<Proto*> pending;
+
+    for (Proto* p : protos)
+        if (p && getProtoExecData(p) == nullptr)
+            pending.push_back(p);
+
+    SerializedModule module;
+    module.bytecodeHash = getBytecodeHash(protos);
+    module.target = getHostTarget();
+    module.cpuFeatures = getHostCpuFeatures();
+    module.flags = getSerializedFlags();
+
+    compileFunctions(*data, pending, /* tiered */ false, &module);
+
+    if (module.functions.empty())
+        return std::string();
+
+    return serializeModule(module);
+}
+
+static bool isValidSerializedFunction(const SerializedModule& module, const SerializedFunction& function, const std::vector<Proto*>& protos)
+{
+    if (function.bytecodeId >= protos.size() || !protos[function.bytecodeId])
+        return false;
+
+    Proto* proto = protos[function.bytecodeId];
+
+    if (getProtoExecData(proto) != nullptr || function.instOffsets.size() != size_t(proto->sizecode) || proto->sizecode == 0)
+        return false;
+
+    for (uint32_t offset : function.instOffsets)
+        if (offset >= module.code.size() - function.location)
+            return false;
+
+    for (uint32_t pcpos : function.inlineCachePcs)
+    {
+        if (pcpos == ~0u)
+            continue;
+
+        if (pcpos + 1 >= uint32_t(proto->sizecode))
+            return false;
+
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(proto->code[pcpos]));
+
+        if (op != LOP_GETTABLEKS && op != LOP_SETTABLEKS && op != LOP_NAMECALL)
+            return false;
+
+        uint32_t aux = proto->code[pcpos + 1];
+
+        if (aux >= uint32_t(proto->sizek) || !ttisstring(&proto->k[aux]))
+            return false;
+    }
+
+    return true;
+}
+
+bool loadSerialized(lua_State* L, int idx, const char* serialized, size_t size)
+{
+    LUAU_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    NativeState* data = getNativeState(L);
+
+    if (!data)
+        return false;
+
+    SerializedModule module;
+
+    if (!deserializeModule(module, serialized, size) || module.functions.empty())
+        return false;
+
+    if (module.target != getHostTarget() || module.cpuFeatures != getHostCpuFeatures() || module.flags != getSerializedFlags())
+        return false;
+
+    std::vector<Proto*> protos;
+    gatherFunctions(protos, clvalue(func)->l.p);
+
+    if (module.bytecodeHash != getBytecodeHash(protos))
+        return false;
+
+    std::vector<uint8_t> seen(protos.size());
+
+    for (const SerializedFunction& function : module.functions)
+    {
+        if (!isValidSerializedFunction(module, function, protos) || seen[function.bytecodeId])
+            return false;
+
+        seen[function.bytecodeId] = true;
+    }
+
+    uint8_t* nativeData = nullptr;
+    size_t sizeNativeData = 0;
+    uint8_t* codeStart = nullptr;
+    if (!data->codeAllocator.allocate(
+            module.data.data(), module.data.size(), module.code.data(), module.code.size(), nativeData, sizeNativeData, codeStart))
+        return false;
+
+    data->tieringStats.nativeCodeSize += sizeNativeData;
+
+    NativeAllocation* allocation = createNativeAllocation(nativeData, sizeNativeData, uint32_t(module.functions.size()));
+
+    // Code doesn't need to be patched, only the native proto objects have to be created with absolute instruction locations
+    for (const SerializedFunction& function : module.functions)
+    {
+        Proto* proto = protos[function.bytecodeId];
+
+        NativeProto* result = new NativeProto();
+        result->proto = proto;
+        result->location = function.location;
+
+        result->instTargets = new uintptr_t[proto->sizecode];
+
+        for (int i = 0; i < proto->sizecode; i++)
+            result->instTargets[i] = uintptr_t(codeStart + function.location + function.instOffsets[i]);
+
+        if (!function.inlineCachePcs.empty())
+        {
+            result->inlineCacheCount = uint32_t(function.inlineCachePcs.size());
+            result->inlineCaches = new InlineCache[result->inlineCacheCount];
+
+            for (uint32_t i = 0; i < result->inlineCacheCount; i++)
+                if (function.inlineCachePcs[i] != ~0u)
+                    initInlineCache(result->inlineCaches[i], proto, function.inlineCachePcs[i]);
+        }
+
+        result->entryTarget = result->instTargets[0];
+        result->allocation = allocation;
+
+        setProtoExecData(proto, result);
+
+        data->tieringStats.loadedFunctions++;
+    }
+
+    return true;
+}
+
+void setTieringOptions(lua_State* L, const TieringOptions& options)
+{
+    if (NativeState* data = getNativeState(L))
+        data->tieringOptions = options;
+}
+
+TieringOptions getTieringOptions(lua_State* L)
+{
+    if (NativeState* data = getNativeState(L))
+        return data->tieringOptions;
+
+    return {};
+}
+
+TieringStats getTieringStats(lua_State* L)
+{
+    if (NativeState* data = getNativeState(L))
+        return data->tieringStats;
+
+    return {};
+}
+
+CodeMemoryStats getCodeMemoryStats(lua_State* L)
+{
+    CodeMemoryStats stats;
+
+    if (NativeState* data = getNativeState(L))
+    {
+        stats.totalSize = data->codeAllocator.blocks.size() * data->codeAllocator.blockSize;
+        stats.usedSize = data->codeAllocator.getUsedSize();
+        stats.freeSize = data->codeAllocator.getFreeSize();
+        stats.fragmentedSize = data->codeAllocator.getFragmentedSize();
+    }
+
+    return stats;
 }
 
 std::string getAssembly(lua_State* L, int idx, AssemblyOptions options)
@@ -316,11 +913,12 @@ std::string getAssembly(lua_State* L, int idx, AssemblyOptions options)
     for (Proto* p : protos)
         if (p)
         {
-            NativeProto* nativeProto = assembleFunction(build, data, helpers, p, options);
-            destroyNativeProto(nativeProto);
+            if (NativeProto* nativeProto = assembleFunction(build, data, helpers, p, options))
+                destroyNativeProto(nativeProto);
         }
 
-    build.finalize();
+    if (!build.finalize())
+        return std::string();
 
     if (options.outputBinary)
         return std::string(build.code.begin(), build.code.end()) + std::string(build.data.begin(), build.data.end());
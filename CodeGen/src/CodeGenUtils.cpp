@@ -1,8 +1,12 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #include "CodeGenUtils.h"
 
+#include "CustomExecUtils.h"
+#include "NativeState.h"
+
 #include "ldo.h"
 #include "ltable.h"
+#include "ltm.h"
 
 #include "FallbacksProlog.h"
 
@@ -15,6 +19,10 @@ namespace CodeGen
 
 bool forgLoopNodeIter(lua_State* L, Table* h, int index, TValue* ra)
 {
+    // nodes must not move while they are visited
+    if (h->migration)
+        luaH_finishmigration(L, h);
+
     // then we advance index through the hash portion
     while (unsigned(index - h->sizearray) < unsigned(1 << h->lsizenode))
     {
@@ -126,5 +134,184 @@ void callEpilogC(lua_State* L, int nresults, int n)
     L->top = (nresults == LUA_MULTRET) ? res : cip->top;
 }
 
+static InlineCache& getInlineCache(lua_State* L, int cacheIndex)
+{
+    NativeProto* nativeProto = getProtoExecData(clvalue(L->ci->func)->l.p);
+    LUAU_ASSERT(nativeProto && nativeProto->inlineCaches);
+
+    return nativeProto->inlineCaches[cacheIndex];
+}
+
+// Follows the path recorded in the cache entry, validating that every table on the way still doesn't have the key and still has the same
+// __index table; the entry only provides slot predictions so that a modified table can't produce a stale result
+static const TValue* findCachedEntry(lua_State* L, Table* h, TString* key, const InlineCacheEntry& entry)
+{
+    for (int i = 0; i < entry.depth; i++)
+    {
+        // The key is absent if its main position holds a different key and doesn't have a collision chain
+        // While the table is resized, the key may be in the old hash part instead
+        LuaNode* mp = &h->node[key->hash & (sizenode(h) - 1)];
+
+        if (gnext(mp) != 0 || (ttisstring(gkey(mp)) && tsvalue(gkey(mp)) == key) || h->migration)
+            return nullptr;
+
+        Table* mt = h->metatable;
+
+        if (!mt)
+            return nullptr;
+
+        LuaNode* index = &mt->node[entry.indexSlots[i] & mt->nodemask8];
+
+        if (!ttisstring(gkey(index)) || tsvalue(gkey(index)) != L->global->tmname[TM_INDEX] || !ttistable(gval(index)))
+            return nullptr;
+
+        h = hvalue(gval(index));
+    }
+
+    LuaNode* n = &h->node[entry.slot & h->nodemask8];
+
+    if (ttisstring(gkey(n)) && tsvalue(gkey(n)) == key && !ttisnil(gval(n)))
+        return gval(n);
+
+    return nullptr;
+}
+
+// Looks the key up in the table and its chain of __index tables, recording the path into the cache
+// Returns nullptr if the lookup requires a metamethod call, a nil object if the key is absent from the whole chain
+static const TValue* findAndCache(lua_State* L, Table* h, InlineCache& cache, bool followIndex)
+{
+    InlineCacheEntry entry;
+    entry.valid = true;
+    entry.lsizenode = h->lsizenode;
+    entry.metatable = h->metatable;
+
+    for (Table* t = h;;)
+    {
+        const TValue* res = luaH_getstr(t, cache.key);
+
+        if (!ttisnil(res))
+        {
+            // While the hash part is being resized, res may be in the old node array which the cache doesn't cover
+            int slot = t->migration ? -1 : gval2slot(t, res);
+
+            // Like the slot prediction of the instruction, the cache only covers the first 256 nodes of each table
+            if (slot >= 0 && slot <= 255)
+            {
+                entry.slot = uint8_t(slot);
+
+                // Replace an entry of the same layout and metatable in case its path has been invalidated
+                int replace = cache.nextEntry;
+
+                for (int i = 0; i < kInlineCacheEntries; i++)
+                {
+                    if (cache.entries[i].valid && cache.entries[i].lsizenode == entry.lsizenode && cache.entries[i].metatable == entry.metatable)
+                    {
+                        replace = i;
+                        break;
+                    }
+                }
+
+                if (replace == cache.nextEntry)
+                    cache.nextEntry = uint8_t((cache.nextEntry + 1) % kInlineCacheEntries);
+
+                cache.entries[replace] = entry;
+
+                // Like the interpreter, update the slot prediction of the instruction with the location of the key in the last table
+                VM_PATCH_C(cache.pc, slot);
+            }
+
+            return res;
+        }
+
+        if (!followIndex)
+            return nullptr;
+
+        const TValue* index = fasttm(L, t->metatable, TM_INDEX);
+
+        if (!index)
+            return luaO_nilobject;
+
+        if (!ttistable(index) || entry.depth == kInlineCacheMaxDepth)
+            return nullptr;
+
+        int indexSlot = t->metatable->migration ? -1 : gval2slot(t->metatable, index);
+
+        if (indexSlot < 0 || indexSlot > 255)
+            return nullptr;
+
+        entry.indexSlots[entry.depth++] = uint8_t(indexSlot);
+        t = hvalue(index);
+    }
+}
+
+static const TValue* findField(lua_State* L, Table* h, InlineCache& cache, bool followIndex)
+{
+    for (const InlineCacheEntry& entry : cache.entries)
+    {
+        if (entry.valid && entry.lsizenode == h->lsizenode && entry.metatable == h->metatable)
+        {
+            if (const TValue* res = findCachedEntry(L, h, cache.key, entry))
+                return res;
+
+            break;
+        }
+    }
+
+    return findAndCache(L, h, cache, followIndex);
+}
+
+bool getFieldCached(lua_State* L, StkId ra, StkId rb, int cacheIndex)
+{
+    if (!ttistable(rb))
+        return false;
+
+    const TValue* res = findField(L, hvalue(rb), getInlineCache(L, cacheIndex), /* followIndex */ true);
+
+    if (!res)
+        return false;
+
+    setobj2s(L, ra, res);
+    return true;
+}
+
+bool setFieldCached(lua_State* L, StkId ra, StkId rb, int cacheIndex)
+{
+    if (!ttistable(rb))
+        return false;
+
+    Table* h = hvalue(rb);
+
+    if (h->readonly)
+        return false;
+
+    // Only existing keys can be assigned to without going through __newindex or inserting a new key
+    const TValue* res = findField(L, h, getInlineCache(L, cacheIndex), /* followIndex */ false);
+
+    if (!res || ttisnil(res))
+        return false;
+
+    TValue* slot = const_cast<TValue*>(res);
+    setobj2t(L, slot, ra);
+    luaC_barriert(L, h, ra);
+    return true;
+}
+
+bool getMethodCached(lua_State* L, StkId ra, StkId rb, int cacheIndex)
+{
+    if (!ttistable(rb))
+        return false;
+
+    const TValue* res = findField(L, hvalue(rb), getInlineCache(L, cacheIndex), /* followIndex */ true);
+
+    // Calling a missing method is an error that is reported by the fallback
+    if (!res || ttisnil(res))
+        return false;
+
+    // note: order of copies allows rb to alias ra+1 or ra
+    setobj2s(L, ra + 1, rb);
+    setobj2s(L, ra, res);
+    return true;
+}
+
 } // namespace CodeGen
 } // namespace Luau
@@ -16,5 +16,9 @@ void forgPrepXnextFallback(lua_State* L, TValue* ra, int pc);
 Closure* callProlog(lua_State* L, TValue* ra, StkId argtop, int nresults);
 void callEpilogC(lua_State* L, int nresults, int n);
 
+bool getFieldCached(lua_State* L, StkId ra, StkId rb, int cacheIndex);
+bool setFieldCached(lua_State* L, StkId ra, StkId rb, int cacheIndex);
+bool getMethodCached(lua_State* L, StkId ra, StkId rb, int cacheIndex);
+
 } // namespace CodeGen
 } // namespace Luau
@@ -18,7 +18,8 @@
  * | rcx home space | (unused)
  * | return address |
  * | ... saved non-volatile registers ... <-- rsp + kStackSize + kLocalsSize
- * | unused         | for 16 byte alignment of the stack
+ * | ... spill slots ...                   <-- rsp + kStackSize + 24
+ * | sTemporarySlot |
  * | sCode          |
  * | sClosure       | <-- rsp + kStackSize
  * | argument 6     | <-- rsp + 40
@@ -605,6 +605,7 @@ BuiltinImplResult emitBuiltin(AssemblyBuilderX64& build, int bfid, int nparams,
     switch (bfid)
     {
     case LBF_ASSERT:
+    case LBF_VECTOR:
         // This builtin fast-path was already translated to IR
         return {BuiltinImplType::None, -1};
     case LBF_MATH_FLOOR:
@@ -296,7 +296,7 @@ void emitSetSavedPc(AssemblyBuilderX64& build, int pcpos)
     build.mov(qword[rax + offsetof(CallInfo, savedpc)], rdx);
 }
 
-void emitInterrupt(AssemblyBuilderX64& build, int pcpos)
+static void emitInterruptImpl(AssemblyBuilderX64& build, int pcpos, Label* handled)
 {
     Label skip;
 
@@ -317,7 +317,7 @@ void emitInterrupt(AssemblyBuilderX64& build, int pcpos)
     // Check if we need to exit
     build.mov(al, byte[rState + offsetof(lua_State, status)]);
     build.test(al, al);
-    build.jcc(ConditionX64::Zero, skip);
+    build.jcc(ConditionX64::Zero, handled ? *handled : skip);
 
     build.mov(rax, qword[rState + offsetof(lua_State, ci)]);
     build.sub(qword[rax + offsetof(CallInfo, savedpc)], sizeof(Instruction));
@@ -326,6 +326,16 @@ void emitInterrupt(AssemblyBuilderX64& build, int pcpos)
     build.setLabel(skip);
 }
 
+void emitInterrupt(AssemblyBuilderX64& build, int pcpos)
+{
+    emitInterruptImpl(build, pcpos, nullptr);
+}
+
+void emitInterrupt(AssemblyBuilderX64& build, int pcpos, Label& handled)
+{
+    emitInterruptImpl(build, pcpos, &handled);
+}
+
 void emitFallback(AssemblyBuilderX64& build, NativeState& data, int op, int pcpos)
 {
     if (op == LOP_CAPTURE)
@@ -49,6 +49,9 @@ void emitInstNameCall(AssemblyBuilderX64& build, const Instruction* pc, int pcpo
 
     build.setLabel(secondfpath);
 
+    // tables that are being resized may have the key in the old hash part
+    build.cmp(qword[table + offsetof(Table, migration)], 0);
+    build.jcc(ConditionX64::NotEqual, fallback);
     jumpIfNodeHasNext(build, node, fallback);
     callGetFastTmOrFallback(build, table, TM_INDEX, fallback);
     jumpIfTagIsNot(build, rax, LUA_TTABLE, fallback);
@@ -140,7 +143,11 @@ void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, const Instr
         build.mov(qword[rState + offsetof(lua_State, top)], argi);
         build.setLabel(skipVararg);
 
-        // Check native function data
+        // Check native function data, functions that are profiled for tiered compilation don't have an entry target yet
+        build.test(rax, rax);
+        build.jcc(ConditionX64::Zero, helpers.continueCallInVm);
+
+        build.mov(rax, qword[rax + offsetof(NativeProto, entryTarget)]);
         build.test(rax, rax);
         build.jcc(ConditionX64::Zero, helpers.continueCallInVm);
 
@@ -151,7 +158,7 @@ void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, const Instr
         build.mov(rdx, qword[proto + offsetof(Proto, code)]);
         build.mov(sCode, rdx);
 
-        build.jmp(qword[rax + offsetof(NativeProto, entryTarget)]);
+        build.jmp(rax);
     }
 
     build.setLabel(cFuncCall);
@@ -358,6 +365,8 @@ void emitInstReturn(AssemblyBuilderX64& build, ModuleHelpers& helpers, const Ins
     build.mov(execdata, qword[proto + offsetofProtoExecData]);
     build.test(execdata, execdata);
     build.jcc(ConditionX64::Zero, helpers.exitContinueVm); // Continue in interpreter if function has no native data
+    build.cmp(qword[execdata + offsetof(NativeProto, instTargets)], 0);
+    build.jcc(ConditionX64::Equal, helpers.exitContinueVm); // Or if it hasn't been compiled yet
 
     // Change constants
     build.mov(rConstants, qword[proto + offsetof(Proto, k)]);
@@ -98,7 +98,8 @@ const Instruction* execute_LOP_GETTABLEKS(lua_State* L, const Instruction* pc, S
             // fast-path: value is not in expected slot, but the table lookup doesn't involve metatable
             const TValue* res = luaH_getstr(h, tsvalue(kv));
 
-            if (res != luaO_nilobject)
+            // while the hash part is being resized, res may be in the old node array which slot predictions don't cover
+            if (res != luaO_nilobject && !h->migration)
             {
                 int cachedslot = gval2slot(h, res);
                 // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
@@ -217,9 +218,12 @@ const Instruction* execute_LOP_SETTABLEKS(lua_State* L, const Instruction* pc, S
             VM_PROTECT_PC(); // set may fail
 
             TValue* res = luaH_setstr(L, h, tsvalue(kv));
-            int cachedslot = gval2slot(h, res);
-            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
-            VM_PATCH_C(pc - 2, cachedslot);
+            if (!h->migration)
+            {
+                int cachedslot = gval2slot(h, res);
+                // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                VM_PATCH_C(pc - 2, cachedslot);
+            }
             setobj2t(L, res, ra);
             luaC_barriert(L, h, ra);
             return pc;
@@ -336,7 +340,8 @@ const Instruction* execute_LOP_NAMECALL(lua_State* L, const Instruction* pc, Stk
             setobj2s(L, ra, gval(n));
         }
         // fast-path: key is absent from the base, table has an __index table, and it has the result in the expected slot
-        else if (gnext(n) == 0 && (mt = fasttm(L, hvalue(rb)->metatable, TM_INDEX)) && ttistable(mt) &&
+        // note: tables that are being resized may have the key in the old hash part
+        else if (gnext(n) == 0 && !h->migration && (mt = fasttm(L, hvalue(rb)->metatable, TM_INDEX)) && ttistable(mt) &&
                  (mtn = &hvalue(mt)->node[LUAU_INSN_C(insn) & hvalue(mt)->nodemask8]) && ttisstring(gkey(mtn)) && tsvalue(gkey(mtn)) == tsvalue(kv) &&
                  !ttisnil(gval(mtn)))
         {
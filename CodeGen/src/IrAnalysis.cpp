@@ -4,6 +4,8 @@
 #include "Luau/IrData.h"
 #include "Luau/IrUtils.h"
 
+#include <algorithm>
+
 #include <stddef.h>
 
 namespace Luau
@@ -73,5 +75,273 @@ void updateLastUseLocations(IrFunction& function)
     }
 }
 
+std::vector<uint8_t> findValuesLiveAcrossCalls(const IrFunction& function, const std::vector<uint32_t>& sortedBlocks)
+{
+    const std::vector<IrInst>& instructions = function.instructions;
+
+    // Register allocation is performed in lowering order, so live ranges are measured in positions of that order
+    std::vector<uint32_t> positions(instructions.size(), ~0u);
+    std::vector<uint32_t> callPositions;
+
+    uint32_t position = 0;
+
+    for (uint32_t blockIdx : sortedBlocks)
+    {
+        const IrBlock& block = function.blocks[blockIdx];
+
+        if (block.kind == IrBlockKind::Dead)
+            continue;
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            positions[index] = position;
+
+            if (performsCall(instructions[index].cmd))
+                callPositions.push_back(position);
+
+            position++;
+        }
+    }
+
+    std::vector<uint8_t> result(instructions.size(), false);
+
+    for (size_t index = 0; index < instructions.size(); ++index)
+    {
+        const IrInst& inst = instructions[index];
+
+        if (!hasResult(inst.cmd) || inst.useCount == 0 || positions[index] == ~0u)
+            continue;
+
+        // Registers of values that have their last use in code that is never lowered are never freed, but there is no need to preserve them
+        uint32_t lastUsePosition = positions[inst.lastUse];
+
+        if (lastUsePosition == ~0u)
+            continue;
+
+        // Check if there is a call strictly between the definition and the last use
+        auto it = std::upper_bound(callPositions.begin(), callPositions.end(), positions[index]);
+
+        if (it != callPositions.end() && *it < lastUsePosition)
+            result[index] = true;
+    }
+
+    return result;
+}
+
+void computeCfgInfo(IrFunction& function)
+{
+    CfgInfo& info = function.cfg;
+
+    info.predecessors.clear();
+    info.predecessorsOffsets.clear();
+    info.successors.clear();
+    info.successorsOffsets.clear();
+    info.captured.reset();
+
+    std::vector<uint32_t> predecessorCounts(function.blocks.size(), 0);
+
+    for (size_t blockIdx = 0; blockIdx < function.blocks.size(); blockIdx++)
+    {
+        const IrBlock& block = function.blocks[blockIdx];
+
+        info.successorsOffsets.push_back(uint32_t(info.successors.size()));
+
+        if (block.kind == IrBlockKind::Dead)
+            continue;
+
+        size_t first = info.successors.size();
+
+        auto checkOp = [&](IrOp op) {
+            if (op.kind != IrOpKind::Block)
+                return;
+
+            // Same block can be used by multiple instructions (or even multiple operands of the same instruction)
+            if (std::find(info.successors.begin() + first, info.successors.end(), op.index) != info.successors.end())
+                return;
+
+            info.successors.push_back(op.index);
+            predecessorCounts[op.index]++;
+        };
+
+        for (uint32_t instIdx = block.start; instIdx <= block.finish; instIdx++)
+        {
+            IrInst& inst = function.instructions[instIdx];
+
+            checkOp(inst.a);
+            checkOp(inst.b);
+            checkOp(inst.c);
+            checkOp(inst.d);
+            checkOp(inst.e);
+            checkOp(inst.f);
+
+            if (inst.cmd == IrCmd::CAPTURE && inst.a.kind == IrOpKind::VmReg && function.boolOp(inst.b))
+                info.captured.set(inst.a.index);
+        }
+    }
+
+    uint32_t offset = 0;
+
+    for (uint32_t count : predecessorCounts)
+    {
+        info.predecessorsOffsets.push_back(offset);
+        offset += count;
+    }
+
+    info.predecessors.resize(offset);
+
+    std::vector<uint32_t> positions = info.predecessorsOffsets;
+
+    for (size_t blockIdx = 0; blockIdx < function.blocks.size(); blockIdx++)
+    {
+        for (uint32_t successor : successors(info, uint32_t(blockIdx)))
+            info.predecessors[positions[successor]++] = uint32_t(blockIdx);
+    }
+}
+
+static BlockIteratorWrapper getBlockRange(const std::vector<uint32_t>& data, const std::vector<uint32_t>& offsets, uint32_t blockIdx)
+{
+    LUAU_ASSERT(blockIdx < offsets.size());
+
+    uint32_t start = offsets[blockIdx];
+    uint32_t end = blockIdx + 1 < offsets.size() ? offsets[blockIdx + 1] : uint32_t(data.size());
+
+    return BlockIteratorWrapper{data.data() + start, data.data() + end};
+}
+
+BlockIteratorWrapper predecessors(const CfgInfo& cfg, uint32_t blockIdx)
+{
+    return getBlockRange(cfg.predecessors, cfg.predecessorsOffsets, blockIdx);
+}
+
+BlockIteratorWrapper successors(const CfgInfo& cfg, uint32_t blockIdx)
+{
+    return getBlockRange(cfg.successors, cfg.successorsOffsets, blockIdx);
+}
+
+std::vector<uint32_t> getReversePostorder(const IrFunction& function)
+{
+    const CfgInfo& cfg = function.cfg;
+    LUAU_ASSERT(cfg.successorsOffsets.size() == function.blocks.size());
+
+    std::vector<uint32_t> postorder;
+    postorder.reserve(function.blocks.size());
+
+    std::vector<uint8_t> visited(function.blocks.size(), false);
+
+    // Depth-first traversal with an explicit stack of blocks and the position of the next successor to visit
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+    // Traversal starts at the function entry, which can also be a target of a loop back edge, and then at other blocks without predecessors
+    for (size_t root = 0; root < function.blocks.size(); root++)
+    {
+        if (function.blocks[root].kind == IrBlockKind::Dead || visited[root] || (root != 0 && !predecessors(cfg, uint32_t(root)).empty()))
+            continue;
+
+        visited[root] = true;
+        stack.push_back({uint32_t(root), 0});
+
+        while (!stack.empty())
+        {
+            auto& [blockIdx, next] = stack.back();
+            BlockIteratorWrapper succ = successors(cfg, blockIdx);
+
+            if (next < succ.size())
+            {
+                uint32_t target = succ.begin()[next++];
+
+                if (!visited[target])
+                {
+                    visited[target] = true;
+                    stack.push_back({target, 0});
+                }
+            }
+            else
+            {
+                postorder.push_back(blockIdx);
+                stack.pop_back();
+            }
+        }
+    }
+
+    std::reverse(postorder.begin(), postorder.end());
+    return postorder;
+}
+
+std::vector<uint32_t> getImmediateDominators(const IrFunction& function, const std::vector<uint32_t>& order)
+{
+    const CfgInfo& cfg = function.cfg;
+
+    std::vector<int> position(function.blocks.size(), -1);
+
+    for (size_t i = 0; i < order.size(); i++)
+        position[order[i]] = int(i);
+
+    // Dominators are found over positions in the order, where -1 is a virtual root that dominates all starting blocks
+    constexpr int kVirtualRoot = -1;
+    constexpr int kUnknown = -2;
+
+    std::vector<int> idom(order.size(), kUnknown);
+
+    auto intersect = [&](int a, int b) {
+        while (a != b)
+        {
+            while (a > b)
+                a = idom[a];
+
+            while (b > a)
+                b = idom[b];
+        }
+
+        return a;
+    };
+
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            uint32_t blockIdx = order[i];
+            int newIdom = kUnknown;
+
+            if (blockIdx == 0 || predecessors(cfg, blockIdx).empty())
+            {
+                newIdom = kVirtualRoot;
+            }
+            else
+            {
+                for (uint32_t predIdx : predecessors(cfg, blockIdx))
+                {
+                    int pred = position[predIdx];
+
+                    // Predecessors that are not reachable or haven't been processed yet are skipped
+                    if (pred < 0 || idom[pred] == kUnknown)
+                        continue;
+
+                    newIdom = newIdom == kUnknown ? pred : intersect(pred, newIdom);
+                }
+            }
+
+            if (idom[i] != newIdom)
+            {
+                idom[i] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<uint32_t> result(function.blocks.size(), ~0u);
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (idom[i] >= 0)
+            result[order[i]] = order[idom[i]];
+    }
+
+    return result;
+}
+
 } // namespace CodeGen
 } // namespace Luau
@@ -126,6 +126,13 @@ void IrBuilder::translateInst(LuauOpcode op, const Instruction* pc, int i)
         translateInstSetGlobal(*this, pc, i);
         break;
     case LOP_CALL:
+        // Calls that are a fallback of a builtin are not expected to reach a Luau function
+        if (!activeFastcallFallback && size_t(i) < callTargets.size() && callTargets[i] && translateInlinedCall(*this, pc, i, callTargets[i]))
+        {
+            function.inlinedCallCount++;
+            break;
+        }
+
         inst(IrCmd::LOP_CALL, constUint(i), vmReg(LUAU_INSN_A(*pc)), constInt(LUAU_INSN_B(*pc) - 1), constInt(LUAU_INSN_C(*pc) - 1));
 
         if (activeFastcallFallback)
@@ -373,9 +380,15 @@ void IrBuilder::translateInst(LuauOpcode op, const Instruction* pc, int i)
         IrOp next = blockAtInst(i + getOpLength(LOP_NAMECALL));
         IrOp fallback = block(IrBlockKind::Fallback);
 
+        IrOp slowpath = block(IrBlockKind::Fallback);
+
         inst(IrCmd::LOP_NAMECALL, constUint(i), vmReg(LUAU_INSN_A(*pc)), vmReg(LUAU_INSN_B(*pc)), next, fallback);
 
         beginBlock(fallback);
+        inst(IrCmd::GET_METHOD_CACHED, constUint(i), vmReg(LUAU_INSN_A(*pc)), vmReg(LUAU_INSN_B(*pc)), vmConst(pc[1]), inlineCache(), slowpath);
+        inst(IrCmd::JUMP, next);
+
+        beginBlock(slowpath);
         inst(IrCmd::FALLBACK_NAMECALL, constUint(i), vmReg(LUAU_INSN_A(*pc)), vmReg(LUAU_INSN_B(*pc)), vmConst(pc[1]));
         inst(IrCmd::JUMP, next);
 
@@ -559,5 +572,11 @@ IrOp IrBuilder::vmUpvalue(uint8_t index)
     return {IrOpKind::VmUpvalue, index};
 }
 
+IrOp IrBuilder::inlineCache(Proto* owner)
+{
+    function.inlineCacheProtos.push_back(owner ? owner : function.proto);
+    return constUint(function.inlineCacheCount++);
+}
+
 } // namespace CodeGen
 } // namespace Luau
@@ -80,6 +80,8 @@ const char* getCmdName(IrCmd cmd)
         return "LOAD_DOUBLE";
     case IrCmd::LOAD_INT:
         return "LOAD_INT";
+    case IrCmd::LOAD_FLOAT:
+        return "LOAD_FLOAT";
     case IrCmd::LOAD_TVALUE:
         return "LOAD_TVALUE";
     case IrCmd::LOAD_NODE_VALUE_TV:
@@ -98,6 +100,8 @@ const char* getCmdName(IrCmd cmd)
         return "STORE_DOUBLE";
     case IrCmd::STORE_INT:
         return "STORE_INT";
+    case IrCmd::STORE_VECTOR:
+        return "STORE_VECTOR";
     case IrCmd::STORE_TVALUE:
         return "STORE_TVALUE";
     case IrCmd::STORE_NODE_VALUE_TV:
@@ -120,6 +124,18 @@ const char* getCmdName(IrCmd cmd)
         return "POW_NUM";
     case IrCmd::UNM_NUM:
         return "UNM_NUM";
+    case IrCmd::ADD_VEC:
+        return "ADD_VEC";
+    case IrCmd::SUB_VEC:
+        return "SUB_VEC";
+    case IrCmd::MUL_VEC:
+        return "MUL_VEC";
+    case IrCmd::DIV_VEC:
+        return "DIV_VEC";
+    case IrCmd::UNM_VEC:
+        return "UNM_VEC";
+    case IrCmd::TAG_VECTOR:
+        return "TAG_VECTOR";
     case IrCmd::NOT_ANY:
         return "NOT_ANY";
     case IrCmd::JUMP:
@@ -148,6 +164,8 @@ const char* getCmdName(IrCmd cmd)
         return "NUM_TO_INDEX";
     case IrCmd::INT_TO_NUM:
         return "INT_TO_NUM";
+    case IrCmd::NUM_TO_VEC:
+        return "NUM_TO_VEC";
     case IrCmd::ADJUST_STACK_TO_REG:
         return "ADJUST_STACK_TO_REG";
     case IrCmd::ADJUST_STACK_TO_TOP:
@@ -162,6 +180,12 @@ const char* getCmdName(IrCmd cmd)
         return "SET_TABLE";
     case IrCmd::GET_IMPORT:
         return "GET_IMPORT";
+    case IrCmd::GET_FIELD_CACHED:
+        return "GET_FIELD_CACHED";
+    case IrCmd::SET_FIELD_CACHED:
+        return "SET_FIELD_CACHED";
+    case IrCmd::GET_METHOD_CACHED:
+        return "GET_METHOD_CACHED";
     case IrCmd::CONCAT:
         return "CONCAT";
     case IrCmd::GET_UPVALUE:
@@ -182,6 +206,8 @@ const char* getCmdName(IrCmd cmd)
         return "CHECK_ARRAY_SIZE";
     case IrCmd::CHECK_SLOT_MATCH:
         return "CHECK_SLOT_MATCH";
+    case IrCmd::CHECK_CALL_TARGET:
+        return "CHECK_CALL_TARGET";
     case IrCmd::INTERRUPT:
         return "INTERRUPT";
     case IrCmd::CHECK_GC:
@@ -194,6 +220,8 @@ const char* getCmdName(IrCmd cmd)
         return "BARRIER_TABLE_FORWARD";
     case IrCmd::SET_SAVEDPC:
         return "SET_SAVEDPC";
+    case IrCmd::EXIT_TO_VM:
+        return "EXIT_TO_VM";
     case IrCmd::CLOSE_UPVALS:
         return "CLOSE_UPVALS";
     case IrCmd::CAPTURE:
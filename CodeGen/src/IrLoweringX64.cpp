@@ -7,6 +7,7 @@
 #include "Luau/IrDump.h"
 #include "Luau/IrUtils.h"
 
+#include "CustomExecUtils.h"
 #include "EmitBuiltinsX64.h"
 #include "EmitCommonX64.h"
 #include "EmitInstructionX64.h"
@@ -27,7 +28,7 @@ IrLoweringX64::IrLoweringX64(AssemblyBuilderX64& build, ModuleHelpers& helpers,
     , data(data)
     , proto(proto)
     , function(function)
-    , regs(function)
+    , regs(build, function)
 {
     // In order to allocate registers during lowering, we need to know where instruction results are last used
     updateLastUseLocations(function);
@@ -53,6 +54,9 @@ void IrLoweringX64::lower(AssemblyOptions options)
         return a.start < b.start;
     });
 
+    // Values that are live across calls are preserved on the stack, which depends on the order of lowering
+    regs.liveAcrossCalls = findValuesLiveAcrossCalls(function, sortedBlocks);
+
     DenseHashMap<uint32_t, uint32_t> bcLocations{~0u};
 
     // Create keys for IR assembly locations that original bytecode instruction are interested in
@@ -148,11 +152,21 @@ void IrLoweringX64::lower(AssemblyOptions options)
 
             IrBlock& next = i + 1 < sortedBlocks.size() ? function.blocks[sortedBlocks[i + 1]] : dummy;
 
+            regs.setCurrentInstruction(block, index);
+            regs.restoreOperands(inst);
+
             lowerInst(inst, index, next);
 
+            regs.preserveIfLiveAcrossCalls(inst, index);
+
+            if (performsCall(inst.cmd))
+                regs.releasePreservedRegs(index);
+
             regs.freeLastUseRegs(inst, index);
         }
 
+        regs.releaseRestoredRegs();
+
         if (options.includeIr)
             build.logAppend("#\n");
     }
@@ -178,7 +192,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
     switch (inst.cmd)
     {
     case IrCmd::LOAD_TAG:
-        inst.regX64 = regs.allocGprReg(SizeX64::dword);
+        inst.regX64 = regs.allocGprReg(SizeX64::dword, index);
 
         if (inst.a.kind == IrOpKind::VmReg)
             build.mov(inst.regX64, luauRegTag(inst.a.index));
@@ -192,7 +206,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
             LUAU_ASSERT(!"Unsupported instruction form");
         break;
     case IrCmd::LOAD_POINTER:
-        inst.regX64 = regs.allocGprReg(SizeX64::qword);
+        inst.regX64 = regs.allocGprReg(SizeX64::qword, index);
 
         if (inst.a.kind == IrOpKind::VmReg)
             build.mov(inst.regX64, luauRegValue(inst.a.index));
@@ -202,7 +216,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
             LUAU_ASSERT(!"Unsupported instruction form");
         break;
     case IrCmd::LOAD_DOUBLE:
-        inst.regX64 = regs.allocXmmReg();
+        inst.regX64 = regs.allocXmmReg(index);
 
         if (inst.a.kind == IrOpKind::VmReg)
             build.vmovsd(inst.regX64, luauRegValue(inst.a.index));
@@ -214,12 +228,22 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
     case IrCmd::LOAD_INT:
         LUAU_ASSERT(inst.a.kind == IrOpKind::VmReg);
 
-        inst.regX64 = regs.allocGprReg(SizeX64::dword);
+        inst.regX64 = regs.allocGprReg(SizeX64::dword, index);
 
         build.mov(inst.regX64, luauRegValueInt(inst.a.index));
         break;
+    case IrCmd::LOAD_FLOAT:
+        inst.regX64 = regs.allocXmmReg(index);
+
+        if (inst.a.kind == IrOpKind::VmReg)
+            build.vcvtss2sd(inst.regX64, inst.regX64, dword[rBase + inst.a.index * sizeof(TValue) + intOp(inst.b)]);
+        else if (inst.a.kind == IrOpKind::VmConst)
+            build.vcvtss2sd(inst.regX64, inst.regX64, dword[rConstants + inst.a.index * sizeof(TValue) + intOp(inst.b)]);
+        else
+            LUAU_ASSERT(!"Unsupported instruction form");
+        break;
     case IrCmd::LOAD_TVALUE:
-        inst.regX64 = regs.allocXmmReg();
+        inst.regX64 = regs.allocXmmReg(index);
 
         if (inst.a.kind == IrOpKind::VmReg)
             build.vmovups(inst.regX64, luauReg(inst.a.index));
@@ -231,12 +255,12 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
             LUAU_ASSERT(!"Unsupported instruction form");
         break;
     case IrCmd::LOAD_NODE_VALUE_TV:
-        inst.regX64 = regs.allocXmmReg();
+        inst.regX64 = regs.allocXmmReg(index);
 
         build.vmovups(inst.regX64, luauNodeValue(regOp(inst.a)));
         break;
     case IrCmd::LOAD_ENV:
-        inst.regX64 = regs.allocGprReg(SizeX64::qword);
+        inst.regX64 = regs.allocGprReg(SizeX64::qword, index);
 
         build.mov(inst.regX64, sClosure);
         build.mov(inst.regX64, qword[inst.regX64 + offsetof(Closure, env)]);
@@ -268,7 +292,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
         break;
     case IrCmd::GET_SLOT_NODE_ADDR:
     {
-        inst.regX64 = regs.allocGprReg(SizeX64::qword);
+        inst.regX64 = regs.allocGprReg(SizeX64::qword, index);
 
         ScopedRegX64 tmp{regs, SizeX64::qword};
 
@@ -319,6 +343,21 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
             LUAU_ASSERT(!"Unsupported instruction form");
         break;
     }
+    case IrCmd::STORE_VECTOR:
+    {
+        LUAU_ASSERT(inst.a.kind == IrOpKind::VmReg);
+
+        ScopedRegX64 tmp{regs, SizeX64::xmmword};
+
+        IrOp components[] = {inst.b, inst.c, inst.d};
+
+        for (int i = 0; i < 3; i++)
+        {
+            build.vcvtsd2ss(tmp.reg, tmp.reg, memRegDoubleOp(components[i]));
+            build.vmovss(dword[rBase + inst.a.index * sizeof(TValue) + i * sizeof(float)], tmp.reg);
+        }
+        break;
+    }
     case IrCmd::STORE_TVALUE:
         if (inst.a.kind == IrOpKind::VmReg)
             build.vmovups(luauReg(inst.a.index), regOp(inst.b));
@@ -414,7 +453,20 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
     {
         inst.regX64 = regs.allocXmmRegOrReuse(index, {inst.a, inst.b});
 
-        RegisterX64 lhs = regOp(inst.a);
+        ScopedRegX64 optLhsTmp{regs};
+        RegisterX64 lhs;
+
+        if (inst.a.kind == IrOpKind::Constant)
+        {
+            optLhsTmp.alloc(SizeX64::xmmword);
+
+            build.vmovsd(optLhsTmp.reg, memRegDoubleOp(inst.a));
+            lhs = optLhsTmp.reg;
+        }
+        else
+        {
+            lhs = regOp(inst.a);
+        }
 
         if (inst.b.kind == IrOpKind::Inst)
         {
@@ -458,14 +510,30 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
 
         if (inst.b.kind == IrOpKind::Inst)
         {
-            // TODO: this doesn't happen with current local-only register allocation, but has to be handled in the future
-            LUAU_ASSERT(regOp(inst.b) != xmm0);
+            RegisterX64 rhs = regOp(inst.b);
 
-            if (lhs != xmm0)
+            // Arguments are moved in the order that doesn't overwrite the other source
+            if (lhs == xmm1 && rhs == xmm0)
+            {
+                build.vmovsd(qword[sTemporarySlot + 0], rhs);
+                build.vmovsd(xmm0, lhs, lhs);
+                build.vmovsd(xmm1, qword[sTemporarySlot + 0]);
+            }
+            else if (lhs == xmm1)
+            {
                 build.vmovsd(xmm0, lhs, lhs);
 
-            if (regOp(inst.b) != xmm1)
-                build.vmovsd(xmm1, regOp(inst.b), regOp(inst.b));
+                if (rhs != xmm1)
+                    build.vmovsd(xmm1, rhs, rhs);
+            }
+            else
+            {
+                if (rhs != xmm1)
+                    build.vmovsd(xmm1, rhs, rhs);
+
+                if (lhs != xmm0)
+                    build.vmovsd(xmm0, lhs, lhs);
+            }
 
             build.call(qword[rNativeContext + offsetof(NativeContext, libm_pow)]);
 
@@ -535,6 +603,40 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
 
         break;
     }
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    {
+        inst.regX64 = regs.allocXmmRegOrReuse(index, {inst.a, inst.b});
+
+        ScopedRegX64 tmp1{regs};
+        ScopedRegX64 tmp2{regs};
+
+        RegisterX64 lhs = vecOp(inst.a, tmp1);
+        RegisterX64 rhs = inst.a.kind == inst.b.kind && inst.a.index == inst.b.index ? lhs : vecOp(inst.b, tmp2);
+
+        if (inst.cmd == IrCmd::ADD_VEC)
+            build.vaddps(inst.regX64, lhs, rhs);
+        else if (inst.cmd == IrCmd::SUB_VEC)
+            build.vsubps(inst.regX64, lhs, rhs);
+        else if (inst.cmd == IrCmd::MUL_VEC)
+            build.vmulps(inst.regX64, lhs, rhs);
+        else
+            build.vdivps(inst.regX64, lhs, rhs);
+        break;
+    }
+    case IrCmd::UNM_VEC:
+        inst.regX64 = regs.allocXmmRegOrReuse(index, {inst.a});
+
+        // Tag component is flipped as well, but it doesn't go through the floating-point unit and is replaced later
+        build.vxorps(inst.regX64, regOp(inst.a), build.f32x4(-0.0f, -0.0f, -0.0f, -0.0f));
+        break;
+    case IrCmd::TAG_VECTOR:
+        inst.regX64 = regs.allocXmmRegOrReuse(index, {inst.a});
+
+        build.vpinsrd(inst.regX64, regOp(inst.a), vectorTagOp(), 3);
+        break;
     case IrCmd::NOT_ANY:
     {
         // TODO: if we have a single user which is a STORE_INT, we are missing the opportunity to write directly to target
@@ -641,14 +743,14 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
         break;
     }
     case IrCmd::TABLE_LEN:
-        inst.regX64 = regs.allocXmmReg();
+        inst.regX64 = regs.allocXmmReg(index);
 
         build.mov(rArg1, regOp(inst.a));
         build.call(qword[rNativeContext + offsetof(NativeContext, luaH_getn)]);
         build.vcvtsi2sd(inst.regX64, inst.regX64, eax);
         break;
     case IrCmd::NEW_TABLE:
-        inst.regX64 = regs.allocGprReg(SizeX64::qword);
+        inst.regX64 = regs.allocGprReg(SizeX64::qword, index);
 
         build.mov(rArg1, rState);
         build.mov(dwordReg(rArg2), uintOp(inst.a));
@@ -659,7 +761,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
             build.mov(inst.regX64, rax);
         break;
     case IrCmd::DUP_TABLE:
-        inst.regX64 = regs.allocGprReg(SizeX64::qword);
+        inst.regX64 = regs.allocGprReg(SizeX64::qword, index);
 
         // Re-ordered to avoid register conflict
         build.mov(rArg2, regOp(inst.a));
@@ -671,7 +773,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
         break;
     case IrCmd::NUM_TO_INDEX:
     {
-        inst.regX64 = regs.allocGprReg(SizeX64::dword);
+        inst.regX64 = regs.allocGprReg(SizeX64::dword, index);
 
         ScopedRegX64 tmp{regs, SizeX64::xmmword};
 
@@ -679,10 +781,25 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
         break;
     }
     case IrCmd::INT_TO_NUM:
-        inst.regX64 = regs.allocXmmReg();
+        inst.regX64 = regs.allocXmmReg(index);
 
         build.vcvtsi2sd(inst.regX64, inst.regX64, regOp(inst.a));
         break;
+    case IrCmd::NUM_TO_VEC:
+        inst.regX64 = regs.allocXmmRegOrReuse(index, {inst.a});
+
+        if (inst.a.kind == IrOpKind::Constant)
+        {
+            float value = float(doubleOp(inst.a));
+
+            build.vmovups(inst.regX64, build.f32x4(value, value, value, value));
+        }
+        else
+        {
+            build.vcvtsd2ss(inst.regX64, inst.regX64, memRegDoubleOp(inst.a));
+            build.vshufps(inst.regX64, inst.regX64, inst.regX64, 0);
+        }
+        break;
     case IrCmd::ADJUST_STACK_TO_REG:
     {
         LUAU_ASSERT(inst.a.kind == IrOpKind::VmReg);
@@ -775,6 +892,27 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
 
         emitInstGetImportFallback(build, inst.a.index, uintOp(inst.b));
         break;
+    case IrCmd::GET_FIELD_CACHED:
+    case IrCmd::SET_FIELD_CACHED:
+    case IrCmd::GET_METHOD_CACHED:
+        LUAU_ASSERT(inst.b.kind == IrOpKind::VmReg);
+        LUAU_ASSERT(inst.c.kind == IrOpKind::VmReg);
+
+        build.mov(rArg1, rState);
+        build.lea(rArg2, luauRegAddress(inst.b.index));
+        build.lea(rArg3, luauRegAddress(inst.c.index));
+        build.mov(dwordReg(rArg4), uintOp(inst.e));
+
+        if (inst.cmd == IrCmd::GET_FIELD_CACHED)
+            build.call(qword[rNativeContext + offsetof(NativeContext, getFieldCached)]);
+        else if (inst.cmd == IrCmd::SET_FIELD_CACHED)
+            build.call(qword[rNativeContext + offsetof(NativeContext, setFieldCached)]);
+        else
+            build.call(qword[rNativeContext + offsetof(NativeContext, getMethodCached)]);
+
+        build.test(al, al);
+        build.jcc(ConditionX64::Zero, labelOp(inst.f));
+        break;
     case IrCmd::CONCAT:
         LUAU_ASSERT(inst.a.kind == IrOpKind::VmReg);
 
@@ -888,8 +1026,31 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
         jumpIfNodeKeyNotInExpectedSlot(build, tmp.reg, regOp(inst.a), luauConstantValue(inst.b.index), labelOp(inst.c));
         break;
     }
+    case IrCmd::CHECK_CALL_TARGET:
+    {
+        NativeProto* nativeProto = getProtoExecData(proto);
+        LUAU_ASSERT(nativeProto && nativeProto->callTargets);
+
+        // Function is read from the profile entry at runtime since the entry is reset when the function is destroyed
+        CallTarget* target = &nativeProto->callTargets[uintOp(inst.b)];
+
+        ScopedRegX64 tmp1{regs, SizeX64::qword};
+        ScopedRegX64 tmp2{regs, SizeX64::qword};
+
+        build.cmp(byte[regOp(inst.a) + offsetof(Closure, isC)], 0);
+        build.jcc(ConditionX64::NotEqual, labelOp(inst.c));
+
+        build.mov(tmp1.reg, build.i64(int64_t(uintptr_t(target))));
+        build.mov(tmp2.reg, qword[regOp(inst.a) + offsetof(Closure, l.p)]);
+        build.cmp(tmp2.reg, qword[tmp1.reg + offsetof(CallTarget, proto)]);
+        build.jcc(ConditionX64::NotEqual, labelOp(inst.c));
+        break;
+    }
     case IrCmd::INTERRUPT:
-        emitInterrupt(build, uintOp(inst.a));
+        if (inst.b.kind != IrOpKind::None)
+            emitInterrupt(build, uintOp(inst.a), labelOp(inst.b));
+        else
+            emitInterrupt(build, uintOp(inst.a));
         break;
     case IrCmd::CHECK_GC:
     {
@@ -940,6 +1101,10 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
         build.mov(qword[tmp1.reg + offsetof(CallInfo, savedpc)], tmp2.reg);
         break;
     }
+    case IrCmd::EXIT_TO_VM:
+        emitSetSavedPc(build, uintOp(inst.a));
+        build.jmp(helpers.exitContinueVm);
+        break;
     case IrCmd::CLOSE_UPVALS:
     {
         LUAU_ASSERT(inst.a.kind == IrOpKind::VmReg);
@@ -1132,6 +1297,12 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, IrBlock& next)
     }
 }
 
+bool IrLoweringX64::hasError() const
+{
+    // If register allocator had to use more stack slots than we have available, this function can't run natively
+    return regs.maxUsedSlot > kSpillSlots;
+}
+
 bool IrLoweringX64::isFallthroughBlock(IrBlock target, IrBlock next)
 {
     return target.start == next.start;
@@ -1179,9 +1350,40 @@ OperandX64 IrLoweringX64::memRegTagOp(IrOp op) const
     return noreg;
 }
 
+OperandX64 IrLoweringX64::vectorAndMaskOp()
+{
+    if (vectorAndMask.cat != CategoryX64::mem)
+        vectorAndMask = build.u32x4(~0u, ~0u, ~0u, 0);
+
+    return vectorAndMask;
+}
+
+OperandX64 IrLoweringX64::vectorTagOp()
+{
+    if (vectorTag.cat != CategoryX64::mem)
+        vectorTag = build.i32(LUA_TVECTOR);
+
+    return vectorTag;
+}
+
+RegisterX64 IrLoweringX64::vecOp(IrOp op, ScopedRegX64& tmp)
+{
+    IrInst& source = function.instOp(op);
+
+    // Values created from numbers don't have a tag component
+    if (source.cmd == IrCmd::NUM_TO_VEC)
+        return regOp(op);
+
+    tmp.alloc(SizeX64::xmmword);
+    build.vandps(tmp.reg, regOp(op), vectorAndMaskOp());
+    return tmp.reg;
+}
+
 RegisterX64 IrLoweringX64::regOp(IrOp op) const
 {
-    return function.instOp(op).regX64;
+    IrInst& inst = function.instOp(op);
+    LUAU_ASSERT(inst.regX64 != noreg);
+    return inst.regX64;
 }
 
 IrConst IrLoweringX64::constOp(IrOp op) const
@@ -28,6 +28,8 @@ struct IrLoweringX64
 
     void lowerInst(IrInst& inst, uint32_t index, IrBlock& next);
 
+    bool hasError() const;
+
     bool isFallthroughBlock(IrBlock target, IrBlock next);
     void jumpOrFallthrough(IrBlock& target, IrBlock& next);
 
@@ -36,6 +38,12 @@ struct IrLoweringX64
     OperandX64 memRegTagOp(IrOp op) const;
     RegisterX64 regOp(IrOp op) const;
 
+    // Constants shared by vector instructions of the function
+    // The mask clears the component past the vector size (where TValue tag is stored) before arithmetic to avoid slow denormal operations
+    OperandX64 vectorAndMaskOp();
+    OperandX64 vectorTagOp();
+    RegisterX64 vecOp(IrOp op, ScopedRegX64& tmp);
+
     IrConst constOp(IrOp op) const;
     uint8_t tagOp(IrOp op) const;
     bool boolOp(IrOp op) const;
@@ -56,6 +64,9 @@ struct IrLoweringX64
     IrFunction& function;
 
     IrRegAllocX64 regs;
+
+    OperandX64 vectorAndMask = noreg;
+    OperandX64 vectorTag = noreg;
 };
 
 } // namespace CodeGen
@@ -22,14 +22,23 @@ namespace CodeGen
 
 static const RegisterX64 kGprAllocOrder[] = {rax, rdx, rcx, rbx, rsi, rdi, r8, r9, r10, r11};
 
-IrRegAllocX64::IrRegAllocX64(IrFunction& function)
-    : function(function)
+static OperandX64 spillSlotOp(unsigned stackSlot)
+{
+    return sSpillArea + int(stackSlot * 8);
+}
+
+IrRegAllocX64::IrRegAllocX64(AssemblyBuilderX64& build, IrFunction& function)
+    : build(build)
+    , function(function)
 {
     freeGprMap.fill(true);
     freeXmmMap.fill(true);
+
+    gprInstUsers.fill(kInvalidInstIdx);
+    xmmInstUsers.fill(kInvalidInstIdx);
 }
 
-RegisterX64 IrRegAllocX64::allocGprReg(SizeX64 preferredSize)
+RegisterX64 IrRegAllocX64::allocGprReg(SizeX64 preferredSize, uint32_t instIdx)
 {
     LUAU_ASSERT(
         preferredSize == SizeX64::byte || preferredSize == SizeX64::word || preferredSize == SizeX64::dword || preferredSize == SizeX64::qword);
@@ -39,30 +48,43 @@ RegisterX64 IrRegAllocX64::allocGprReg(SizeX64 preferredSize)
         if (freeGprMap[reg.index])
         {
             freeGprMap[reg.index] = false;
+            gprInstUsers[reg.index] = instIdx;
             return RegisterX64{preferredSize, reg.index};
         }
     }
 
+    // If all registers are taken, value with the furthest next use is moved to the stack
+    RegisterX64 reg = spillAndTakeReg(/* xmm */ false, instIdx);
+
+    if (reg != noreg)
+        return RegisterX64{preferredSize, reg.index};
+
     LUAU_ASSERT(!"Out of GPR registers to allocate");
     return noreg;
 }
 
-RegisterX64 IrRegAllocX64::allocXmmReg()
+RegisterX64 IrRegAllocX64::allocXmmReg(uint32_t instIdx)
 {
     for (size_t i = 0; i < freeXmmMap.size(); ++i)
     {
         if (freeXmmMap[i])
         {
             freeXmmMap[i] = false;
+            xmmInstUsers[i] = instIdx;
             return RegisterX64{SizeX64::xmmword, uint8_t(i)};
         }
     }
 
+    RegisterX64 reg = spillAndTakeReg(/* xmm */ true, instIdx);
+
+    if (reg != noreg)
+        return reg;
+
     LUAU_ASSERT(!"Out of XMM registers to allocate");
     return noreg;
 }
 
-RegisterX64 IrRegAllocX64::allocGprRegOrReuse(SizeX64 preferredSize, uint32_t index, std::initializer_list<IrOp> oprefs)
+RegisterX64 IrRegAllocX64::allocGprRegOrReuse(SizeX64 preferredSize, uint32_t instIdx, std::initializer_list<IrOp> oprefs)
 {
     for (IrOp op : oprefs)
     {
@@ -71,20 +93,21 @@ RegisterX64 IrRegAllocX64::allocGprRegOrReuse(SizeX64 preferredSize, uint32_t in
 
         IrInst& source = function.instructions[op.index];
 
-        if (source.lastUse == index && !source.reusedReg)
+        if (source.lastUse == instIdx && !source.reusedReg)
         {
             LUAU_ASSERT(source.regX64.size != SizeX64::xmmword);
             LUAU_ASSERT(source.regX64 != noreg);
 
             source.reusedReg = true;
+            gprInstUsers[source.regX64.index] = instIdx;
             return RegisterX64{preferredSize, source.regX64.index};
         }
     }
 
-    return allocGprReg(preferredSize);
+    return allocGprReg(preferredSize, instIdx);
 }
 
-RegisterX64 IrRegAllocX64::allocXmmRegOrReuse(uint32_t index, std::initializer_list<IrOp> oprefs)
+RegisterX64 IrRegAllocX64::allocXmmRegOrReuse(uint32_t instIdx, std::initializer_list<IrOp> oprefs)
 {
     for (IrOp op : oprefs)
     {
@@ -93,17 +116,18 @@ RegisterX64 IrRegAllocX64::allocXmmRegOrReuse(uint32_t index, std::initializer_l
 
         IrInst& source = function.instructions[op.index];
 
-        if (source.lastUse == index && !source.reusedReg)
+        if (source.lastUse == instIdx && !source.reusedReg)
         {
             LUAU_ASSERT(source.regX64.size == SizeX64::xmmword);
             LUAU_ASSERT(source.regX64 != noreg);
 
             source.reusedReg = true;
+            xmmInstUsers[source.regX64.index] = instIdx;
             return source.regX64;
         }
     }
 
-    return allocXmmReg();
+    return allocXmmReg(instIdx);
 }
 
 void IrRegAllocX64::freeReg(RegisterX64 reg)
@@ -112,18 +136,26 @@ void IrRegAllocX64::freeReg(RegisterX64 reg)
     {
         LUAU_ASSERT(!freeXmmMap[reg.index]);
         freeXmmMap[reg.index] = true;
+        xmmInstUsers[reg.index] = kInvalidInstIdx;
     }
     else
     {
         LUAU_ASSERT(!freeGprMap[reg.index]);
         freeGprMap[reg.index] = true;
+        gprInstUsers[reg.index] = kInvalidInstIdx;
     }
 }
 
-void IrRegAllocX64::freeLastUseReg(IrInst& target, uint32_t index)
+void IrRegAllocX64::freeLastUseReg(IrInst& target, uint32_t instIdx)
 {
-    if (target.lastUse == index && !target.reusedReg)
+    if (target.lastUse == instIdx)
     {
+        // Stack slot is released even if the register was reused by the current instruction
+        freeSpill(function.getInstIndex(target));
+
+        if (target.reusedReg)
+            return;
+
         // Register might have already been freed if it had multiple uses inside a single instruction
         if (target.regX64 == noreg)
             return;
@@ -133,11 +165,61 @@ void IrRegAllocX64::freeLastUseReg(IrInst& target, uint32_t index)
     }
 }
 
-void IrRegAllocX64::freeLastUseRegs(const IrInst& inst, uint32_t index)
+void IrRegAllocX64::freeLastUseRegs(const IrInst& inst, uint32_t instIdx)
 {
-    auto checkOp = [this, index](IrOp op) {
+    auto checkOp = [this, instIdx](IrOp op) {
         if (op.kind == IrOpKind::Inst)
-            freeLastUseReg(function.instructions[op.index], index);
+            freeLastUseReg(function.instructions[op.index], instIdx);
+    };
+
+    checkOp(inst.a);
+    checkOp(inst.b);
+    checkOp(inst.c);
+    checkOp(inst.d);
+    checkOp(inst.e);
+    checkOp(inst.f);
+}
+
+void IrRegAllocX64::setCurrentInstruction(const IrBlock& block, uint32_t instIdx)
+{
+    currInstIdx = instIdx;
+    currBlockFinish = block.finish;
+}
+
+void IrRegAllocX64::preserveIfLiveAcrossCalls(IrInst& inst, uint32_t instIdx)
+{
+    if (instIdx >= liveAcrossCalls.size() || !liveAcrossCalls[instIdx])
+        return;
+
+    if (inst.regX64 == noreg || hasSpill(instIdx))
+        return;
+
+    spill(inst, instIdx);
+}
+
+void IrRegAllocX64::releasePreservedRegs(uint32_t instIdx)
+{
+    for (IrSpillX64& s : spills)
+    {
+        IrInst& inst = function.instructions[s.instIdx];
+
+        if (s.instIdx == instIdx || inst.lastUse <= instIdx || inst.regX64 == noreg)
+            continue;
+
+        freeReg(inst.regX64);
+        inst.regX64 = noreg;
+        s.restored = false;
+    }
+}
+
+void IrRegAllocX64::restoreOperands(const IrInst& inst)
+{
+    auto checkOp = [this](IrOp op) {
+        if (op.kind != IrOpKind::Inst || function.instructions[op.index].regX64 != noreg)
+            return;
+
+        if (IrSpillX64* s = findSpill(op.index))
+            restore(*s);
     };
 
     checkOp(inst.a);
@@ -148,28 +230,230 @@ void IrRegAllocX64::freeLastUseRegs(const IrInst& inst, uint32_t index)
     checkOp(inst.f);
 }
 
+void IrRegAllocX64::releaseRestoredRegs()
+{
+    for (IrSpillX64& s : spills)
+    {
+        IrInst& inst = function.instructions[s.instIdx];
+
+        if (!s.restored || inst.regX64 == noreg)
+            continue;
+
+        freeReg(inst.regX64);
+        inst.regX64 = noreg;
+        s.restored = false;
+    }
+}
+
+bool IrRegAllocX64::hasSpill(uint32_t instIdx) const
+{
+    for (const IrSpillX64& s : spills)
+    {
+        if (s.instIdx == instIdx)
+            return true;
+    }
+
+    return false;
+}
+
+RegisterX64 IrRegAllocX64::spillAndTakeReg(bool xmm, uint32_t instIdx)
+{
+    std::array<uint32_t, 16>& users = xmm ? xmmInstUsers : gprInstUsers;
+
+    uint32_t candidate = kInvalidInstIdx;
+
+    for (uint32_t user : users)
+    {
+        // Temporary registers and registers of the current instruction can't be taken away
+        if (user == kInvalidInstIdx || user == currInstIdx || isOperandOfCurrentInst(user))
+            continue;
+
+        const IrInst& inst = function.instructions[user];
+
+        // A value can be moved to the stack at any point only if it was stored there at the definition
+        // Otherwise, all of the remaining uses have to be in the current block, so that they all observe the spill
+        if (!hasSpill(user) && inst.lastUse > currBlockFinish)
+            continue;
+
+        if (candidate == kInvalidInstIdx || inst.lastUse > function.instructions[candidate].lastUse)
+            candidate = user;
+    }
+
+    if (candidate == kInvalidInstIdx)
+        return noreg;
+
+    IrInst& inst = function.instructions[candidate];
+
+    if (IrSpillX64* s = findSpill(candidate))
+        s->restored = false;
+    else
+        spill(inst, candidate);
+
+    RegisterX64 reg = inst.regX64;
+    inst.regX64 = noreg;
+
+    users[reg.index] = instIdx;
+    return reg;
+}
+
+unsigned IrRegAllocX64::allocSpillSlot(bool twoSlots)
+{
+    unsigned count = twoSlots ? 2 : 1;
+
+    for (unsigned i = 0; i + count <= usedSpillSlots.size(); ++i)
+    {
+        if (usedSpillSlots.test(i) || (twoSlots && usedSpillSlots.test(i + 1)))
+            continue;
+
+        usedSpillSlots.set(i);
+
+        if (twoSlots)
+            usedSpillSlots.set(i + 1);
+
+        // Lowering reports an error if more slots were required than available on the stack
+        maxUsedSlot = std::max(maxUsedSlot, i + count);
+        return i;
+    }
+
+    LUAU_ASSERT(!"Out of stack slots to allocate");
+    maxUsedSlot = unsigned(usedSpillSlots.size()) + 1;
+    return 0;
+}
+
+void IrRegAllocX64::spill(IrInst& inst, uint32_t instIdx)
+{
+    LUAU_ASSERT(inst.regX64 != noreg);
+    LUAU_ASSERT(!hasSpill(instIdx));
+
+    IrSpillX64 s;
+    s.instIdx = instIdx;
+    s.originalLoc = inst.regX64;
+
+    if (inst.regX64.size == SizeX64::xmmword)
+    {
+        s.stackSlot = allocSpillSlot(/* twoSlots */ true);
+        build.vmovups(xmmword[spillSlotOp(s.stackSlot)], inst.regX64);
+    }
+    else
+    {
+        s.stackSlot = allocSpillSlot(/* twoSlots */ false);
+        build.mov(qword[spillSlotOp(s.stackSlot)], qwordReg(inst.regX64));
+    }
+
+    spills.push_back(s);
+}
+
+void IrRegAllocX64::restore(IrSpillX64& s)
+{
+    IrInst& inst = function.instructions[s.instIdx];
+    LUAU_ASSERT(inst.regX64 == noreg);
+
+    // Spill record can be moved when a new register is allocated, so the data has to be read out first
+    uint32_t instIdx = s.instIdx;
+    RegisterX64 originalLoc = s.originalLoc;
+    unsigned stackSlot = s.stackSlot;
+
+    RegisterX64 reg;
+
+    if (originalLoc.size == SizeX64::xmmword)
+    {
+        reg = allocXmmReg(instIdx);
+        build.vmovups(reg, xmmword[spillSlotOp(stackSlot)]);
+    }
+    else
+    {
+        reg = allocGprReg(originalLoc.size, instIdx);
+        build.mov(qwordReg(reg), qword[spillSlotOp(stackSlot)]);
+    }
+
+    inst.regX64 = reg;
+
+    if (IrSpillX64* restored = findSpill(instIdx))
+        restored->restored = true;
+}
+
+IrSpillX64* IrRegAllocX64::findSpill(uint32_t instIdx)
+{
+    for (IrSpillX64& s : spills)
+    {
+        if (s.instIdx == instIdx)
+            return &s;
+    }
+
+    return nullptr;
+}
+
+void IrRegAllocX64::freeSpill(uint32_t instIdx)
+{
+    for (size_t i = 0; i < spills.size(); ++i)
+    {
+        IrSpillX64& s = spills[i];
+
+        if (s.instIdx != instIdx)
+            continue;
+
+        usedSpillSlots.reset(s.stackSlot);
+
+        if (s.originalLoc.size == SizeX64::xmmword)
+            usedSpillSlots.reset(s.stackSlot + 1);
+
+        spills[i] = spills.back();
+        spills.pop_back();
+        return;
+    }
+}
+
+bool IrRegAllocX64::isOperandOfCurrentInst(uint32_t instIdx) const
+{
+    if (currInstIdx == kInvalidInstIdx)
+        return false;
+
+    const IrInst& inst = function.instructions[currInstIdx];
+
+    auto isOp = [instIdx](IrOp op) {
+        return op.kind == IrOpKind::Inst && op.index == instIdx;
+    };
+
+    return isOp(inst.a) || isOp(inst.b) || isOp(inst.c) || isOp(inst.d) || isOp(inst.e) || isOp(inst.f);
+}
+
 ScopedRegX64::ScopedRegX64(IrRegAllocX64& owner, SizeX64 size)
     : owner(owner)
 {
     if (size == SizeX64::xmmword)
-        reg = owner.allocXmmReg();
+        reg = owner.allocXmmReg(kInvalidInstIdx);
     else
-        reg = owner.allocGprReg(size);
+        reg = owner.allocGprReg(size, kInvalidInstIdx);
 }
 
-
 ScopedRegX64::ScopedRegX64(IrRegAllocX64& owner, RegisterX64 reg)
     : owner(owner)
     , reg(reg)
 {
 }
 
+ScopedRegX64::ScopedRegX64(IrRegAllocX64& owner)
+    : owner(owner)
+    , reg(noreg)
+{
+}
+
 ScopedRegX64::~ScopedRegX64()
 {
     if (reg != noreg)
         owner.freeReg(reg);
 }
 
+void ScopedRegX64::alloc(SizeX64 size)
+{
+    LUAU_ASSERT(reg == noreg);
+
+    if (size == SizeX64::xmmword)
+        reg = owner.allocXmmReg(kInvalidInstIdx);
+    else
+        reg = owner.allocGprReg(size, kInvalidInstIdx);
+}
+
 void ScopedRegX64::free()
 {
     LUAU_ASSERT(reg != noreg);
@@ -1,46 +1,108 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include "Luau/AssemblyBuilderX64.h"
 #include "Luau/IrData.h"
 #include "Luau/RegisterX64.h"
 
 #include <array>
+#include <bitset>
 #include <initializer_list>
+#include <vector>
 
 namespace Luau
 {
 namespace CodeGen
 {
 
+constexpr uint32_t kInvalidInstIdx = ~0u;
+
+struct IrSpillX64
+{
+    uint32_t instIdx = 0;
+    RegisterX64 originalLoc = noreg;
+
+    // Index of the first 8 byte stack slot; values in xmm registers take two slots
+    unsigned stackSlot = 0;
+
+    // Value was loaded back into a register that is only valid until the end of the current block
+    bool restored = false;
+};
+
 struct IrRegAllocX64
 {
-    IrRegAllocX64(IrFunction& function);
+    IrRegAllocX64(AssemblyBuilderX64& build, IrFunction& function);
 
-    RegisterX64 allocGprReg(SizeX64 preferredSize);
-    RegisterX64 allocXmmReg();
+    // Instruction index is used to track register owner, temporary registers should use kInvalidInstIdx
+    RegisterX64 allocGprReg(SizeX64 preferredSize, uint32_t instIdx);
+    RegisterX64 allocXmmReg(uint32_t instIdx);
 
-    RegisterX64 allocGprRegOrReuse(SizeX64 preferredSize, uint32_t index, std::initializer_list<IrOp> oprefs);
-    RegisterX64 allocXmmRegOrReuse(uint32_t index, std::initializer_list<IrOp> oprefs);
+    RegisterX64 allocGprRegOrReuse(SizeX64 preferredSize, uint32_t instIdx, std::initializer_list<IrOp> oprefs);
+    RegisterX64 allocXmmRegOrReuse(uint32_t instIdx, std::initializer_list<IrOp> oprefs);
 
     void freeReg(RegisterX64 reg);
-    void freeLastUseReg(IrInst& target, uint32_t index);
-    void freeLastUseRegs(const IrInst& inst, uint32_t index);
+    void freeLastUseReg(IrInst& target, uint32_t instIdx);
+    void freeLastUseRegs(const IrInst& inst, uint32_t instIdx);
+
+    // Lowering has to report the position it's at, so that operands of the current instruction are never spilled to free up a register
+    void setCurrentInstruction(const IrBlock& block, uint32_t instIdx);
+
+    // Values that are live across calls are stored to the stack right after they are computed
+    void preserveIfLiveAcrossCalls(IrInst& inst, uint32_t instIdx);
+
+    // After an instruction that performs a call, registers of preserved values are considered to be clobbered
+    void releasePreservedRegs(uint32_t instIdx);
+
+    // Spilled operands are loaded back before the instruction that uses them is lowered
+    void restoreOperands(const IrInst& inst);
 
+    // Restored values can't stay in registers after the block end, because other paths into the successors didn't restore them
+    void releaseRestoredRegs();
+
+    bool hasSpill(uint32_t instIdx) const;
+
+    AssemblyBuilderX64& build;
     IrFunction& function;
 
     std::array<bool, 16> freeGprMap;
     std::array<bool, 16> freeXmmMap;
+
+    std::array<uint32_t, 16> gprInstUsers;
+    std::array<uint32_t, 16> xmmInstUsers;
+
+    std::vector<uint8_t> liveAcrossCalls;
+
+    std::vector<IrSpillX64> spills;
+    std::bitset<256> usedSpillSlots;
+    unsigned maxUsedSlot = 0;
+
+    uint32_t currInstIdx = kInvalidInstIdx;
+    uint32_t currBlockFinish = kInvalidInstIdx;
+
+private:
+    RegisterX64 spillAndTakeReg(bool xmm, uint32_t instIdx);
+
+    unsigned allocSpillSlot(bool twoSlots);
+    void spill(IrInst& inst, uint32_t instIdx);
+    void restore(IrSpillX64& spill);
+
+    IrSpillX64* findSpill(uint32_t instIdx);
+    void freeSpill(uint32_t instIdx);
+
+    bool isOperandOfCurrentInst(uint32_t instIdx) const;
 };
 
 struct ScopedRegX64
 {
     ScopedRegX64(IrRegAllocX64& owner, SizeX64 size);
     ScopedRegX64(IrRegAllocX64& owner, RegisterX64 reg);
+    ScopedRegX64(IrRegAllocX64& owner);
     ~ScopedRegX64();
 
     ScopedRegX64(const ScopedRegX64&) = delete;
     ScopedRegX64& operator=(const ScopedRegX64&) = delete;
 
+    void alloc(SizeX64 size);
     void free();
 
     IrRegAllocX64& owner;
@@ -25,12 +25,38 @@ BuiltinImplResult translateBuiltinAssert(IrBuilder& build, int nparams, int ra,
     return {BuiltinImplType::UsesFallback, 0};
 }
 
+BuiltinImplResult translateBuiltinVector(IrBuilder& build, int nparams, int ra, int arg, IrOp args, int nresults, IrOp fallback)
+{
+    if (nparams < 3 || nresults > 1)
+        return {BuiltinImplType::None, -1};
+
+    LUAU_ASSERT(LUA_VECTOR_SIZE == 3);
+    LUAU_ASSERT(args.kind == IrOpKind::VmReg);
+
+    IrOp arg2 = build.vmReg(args.index + 1);
+
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(arg)), build.constTag(LUA_TNUMBER), fallback);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, args), build.constTag(LUA_TNUMBER), fallback);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, arg2), build.constTag(LUA_TNUMBER), fallback);
+
+    IrOp x = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(arg));
+    IrOp y = build.inst(IrCmd::LOAD_DOUBLE, args);
+    IrOp z = build.inst(IrCmd::LOAD_DOUBLE, arg2);
+
+    build.inst(IrCmd::STORE_VECTOR, build.vmReg(ra), x, y, z);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(ra), build.constTag(LUA_TVECTOR));
+
+    return {BuiltinImplType::UsesFallback, 1};
+}
+
 BuiltinImplResult translateBuiltin(IrBuilder& build, int bfid, int ra, int arg, IrOp args, int nparams, int nresults, IrOp fallback)
 {
     switch (bfid)
     {
     case LBF_ASSERT:
         return translateBuiltinAssert(build, nparams, ra, arg, args, nresults, fallback);
+    case LBF_VECTOR:
+        return translateBuiltinVector(build, nparams, ra, arg, args, nresults, fallback);
     default:
         return {BuiltinImplType::None, -1};
     }
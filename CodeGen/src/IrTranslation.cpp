@@ -9,6 +9,7 @@
 #include "IrTranslateBuiltins.h"
 
 #include "lobject.h"
+#include "lstate.h"
 #include "ltm.h"
 
 namespace Luau
@@ -91,6 +92,17 @@ void translateInstMove(IrBuilder& build, const Instruction* pc)
     build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), load);
 }
 
+// Interrupt is placed at the end of a block, so that the loop optimization can give it a separate continuation
+static void translateLoopInterrupt(IrBuilder& build, int pcpos)
+{
+    IrOp next = build.block(IrBlockKind::Internal);
+
+    build.inst(IrCmd::INTERRUPT, build.constUint(pcpos));
+    build.inst(IrCmd::JUMP, next);
+
+    build.beginBlock(next);
+}
+
 void translateInstJump(IrBuilder& build, const Instruction* pc, int pcpos)
 {
     build.inst(IrCmd::JUMP, build.blockAtInst(pcpos + 1 + LUAU_INSN_D(*pc)));
@@ -279,18 +291,129 @@ void translateInstJumpxEqS(IrBuilder& build, const Instruction* pc, int pcpos)
         build.beginBlock(next);
 }
 
+static void translateVectorArith(IrBuilder& build, int ra, IrOp vb, IrOp vc, TMS tm, IrOp next)
+{
+    IrOp va;
+
+    switch (tm)
+    {
+    case TM_ADD:
+        va = build.inst(IrCmd::ADD_VEC, vb, vc);
+        break;
+    case TM_SUB:
+        va = build.inst(IrCmd::SUB_VEC, vb, vc);
+        break;
+    case TM_MUL:
+        va = build.inst(IrCmd::MUL_VEC, vb, vc);
+        break;
+    case TM_DIV:
+        va = build.inst(IrCmd::DIV_VEC, vb, vc);
+        break;
+    default:
+        LUAU_ASSERT(!"unsupported vector op");
+    }
+
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), build.inst(IrCmd::TAG_VECTOR, va));
+    build.inst(IrCmd::JUMP, next);
+}
+
+static void translateInstBinaryVector(IrBuilder& build, int ra, int rb, int rc, IrOp opc, TMS tm, IrOp fallback, IrOp next)
+{
+    IrOp tb = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
+
+    // vector op number constant
+    if (rc == -1)
+    {
+        LUAU_ASSERT(tm == TM_MUL || tm == TM_DIV);
+        LUAU_ASSERT(build.function.proto);
+        TValue protok = build.function.proto->k[opc.index];
+
+        LUAU_ASSERT(protok.tt == LUA_TNUMBER);
+
+        build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TVECTOR), fallback);
+
+        IrOp vb = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
+        IrOp vc = build.inst(IrCmd::NUM_TO_VEC, build.constDouble(protok.value.n));
+        translateVectorArith(build, ra, vb, vc, tm, next);
+        return;
+    }
+
+    // vector op vector, the only form supported by addition and subtraction
+    if (tm == TM_ADD || tm == TM_SUB)
+    {
+        build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TVECTOR), fallback);
+
+        IrOp tc = build.inst(IrCmd::LOAD_TAG, build.vmReg(rc));
+        build.inst(IrCmd::CHECK_TAG, tc, build.constTag(LUA_TVECTOR), fallback);
+
+        IrOp vb = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
+        IrOp vc = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rc));
+        translateVectorArith(build, ra, vb, vc, tm, next);
+        return;
+    }
+
+    // Multiplication and division also accept a number on either side
+    IrOp numberLhs = build.block(IrBlockKind::Fallback);
+    IrOp vectorLhs = build.block(IrBlockKind::Fallback);
+    IrOp vectorRhs = build.block(IrBlockKind::Fallback);
+    IrOp numberRhs = build.block(IrBlockKind::Fallback);
+
+    build.inst(IrCmd::JUMP_EQ_TAG, tb, build.constTag(LUA_TNUMBER), numberLhs, vectorLhs);
+
+    build.beginBlock(numberLhs);
+    {
+        IrOp tc = build.inst(IrCmd::LOAD_TAG, build.vmReg(rc));
+        build.inst(IrCmd::CHECK_TAG, tc, build.constTag(LUA_TVECTOR), fallback);
+
+        IrOp vb = build.inst(IrCmd::NUM_TO_VEC, build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(rb)));
+        IrOp vc = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rc));
+        translateVectorArith(build, ra, vb, vc, tm, next);
+    }
+
+    build.beginBlock(vectorLhs);
+    {
+        IrOp tb2 = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
+        build.inst(IrCmd::CHECK_TAG, tb2, build.constTag(LUA_TVECTOR), fallback);
+
+        IrOp tc = build.inst(IrCmd::LOAD_TAG, build.vmReg(rc));
+        build.inst(IrCmd::JUMP_EQ_TAG, tc, build.constTag(LUA_TVECTOR), vectorRhs, numberRhs);
+    }
+
+    build.beginBlock(vectorRhs);
+    {
+        IrOp vb = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
+        IrOp vc = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rc));
+        translateVectorArith(build, ra, vb, vc, tm, next);
+    }
+
+    build.beginBlock(numberRhs);
+    {
+        IrOp tc = build.inst(IrCmd::LOAD_TAG, build.vmReg(rc));
+        build.inst(IrCmd::CHECK_TAG, tc, build.constTag(LUA_TNUMBER), fallback);
+
+        IrOp vb = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
+        IrOp vc = build.inst(IrCmd::NUM_TO_VEC, build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(rc)));
+        translateVectorArith(build, ra, vb, vc, tm, next);
+    }
+}
+
 static void translateInstBinaryNumeric(IrBuilder& build, int ra, int rb, int rc, IrOp opc, int pcpos, TMS tm)
 {
     IrOp fallback = build.block(IrBlockKind::Fallback);
 
+    // Vector arithmetic is handled out of line when operands are not numbers
+    // Only multiplication and division by a number constant can involve a vector
+    bool hasVectorPath = rc == -1 ? (tm == TM_MUL || tm == TM_DIV) : (tm == TM_ADD || tm == TM_SUB || tm == TM_MUL || tm == TM_DIV);
+    IrOp vector = hasVectorPath ? build.block(IrBlockKind::Fallback) : fallback;
+
     // fast-path: number
     IrOp tb = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
-    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TNUMBER), fallback);
+    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TNUMBER), vector);
 
     if (rc != -1 && rc != rb) // TODO: optimization should handle second check, but we'll test it later
     {
         IrOp tc = build.inst(IrCmd::LOAD_TAG, build.vmReg(rc));
-        build.inst(IrCmd::CHECK_TAG, tc, build.constTag(LUA_TNUMBER), fallback);
+        build.inst(IrCmd::CHECK_TAG, tc, build.constTag(LUA_TNUMBER), vector);
     }
 
     IrOp vb = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(rb));
@@ -346,6 +469,12 @@ static void translateInstBinaryNumeric(IrBuilder& build, int ra, int rb, int rc,
     build.inst(IrCmd::SET_SAVEDPC, build.constUint(pcpos + 1));
     build.inst(IrCmd::DO_ARITH, build.vmReg(ra), build.vmReg(rb), opc, build.constInt(tm));
     build.inst(IrCmd::JUMP, next);
+
+    if (hasVectorPath)
+    {
+        build.beginBlock(vector);
+        translateInstBinaryVector(build, ra, rb, rc, opc, tm, fallback, next);
+    }
 }
 
 void translateInstBinary(IrBuilder& build, const Instruction* pc, int pcpos, TMS tm)
@@ -378,9 +507,10 @@ void translateInstMinus(IrBuilder& build, const Instruction* pc, int pcpos)
     int rb = LUAU_INSN_B(*pc);
 
     IrOp fallback = build.block(IrBlockKind::Fallback);
+    IrOp vector = build.block(IrBlockKind::Fallback);
 
     IrOp tb = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
-    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TNUMBER), fallback);
+    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TNUMBER), vector);
 
     // fast-path: number
     IrOp vb = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(rb));
@@ -397,6 +527,18 @@ void translateInstMinus(IrBuilder& build, const Instruction* pc, int pcpos)
     build.inst(IrCmd::SET_SAVEDPC, build.constUint(pcpos + 1));
     build.inst(IrCmd::DO_ARITH, build.vmReg(LUAU_INSN_A(*pc)), build.vmReg(LUAU_INSN_B(*pc)), build.vmReg(LUAU_INSN_B(*pc)), build.constInt(TM_UNM));
     build.inst(IrCmd::JUMP, next);
+
+    // fast-path: vector
+    build.beginBlock(vector);
+
+    IrOp tbv = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
+    build.inst(IrCmd::CHECK_TAG, tbv, build.constTag(LUA_TVECTOR), fallback);
+
+    IrOp vbv = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
+    IrOp vav = build.inst(IrCmd::UNM_VEC, vbv);
+
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), build.inst(IrCmd::TAG_VECTOR, vav));
+    build.inst(IrCmd::JUMP, next);
 }
 
 void translateInstLength(IrBuilder& build, const Instruction* pc, int pcpos)
@@ -593,7 +735,7 @@ void translateInstForNLoop(IrBuilder& build, const Instruction* pc, int pcpos)
     IrOp loopRepeat = build.blockAtInst(getJumpTarget(*pc, pcpos));
     IrOp loopExit = build.blockAtInst(pcpos + getOpLength(LuauOpcode(LUAU_INSN_OP(*pc))));
 
-    build.inst(IrCmd::INTERRUPT, build.constUint(pcpos));
+    translateLoopInterrupt(build, pcpos);
 
     IrOp zero = build.constDouble(0.0);
     IrOp limit = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(ra + 0));
@@ -691,7 +833,7 @@ void translateInstForGLoopIpairs(IrBuilder& build, const Instruction* pc, int pc
 
     IrOp hasElem = build.block(IrBlockKind::Internal);
 
-    build.inst(IrCmd::INTERRUPT, build.constUint(pcpos));
+    translateLoopInterrupt(build, pcpos);
 
     // fast-path: builtin table iteration
     IrOp tagA = build.inst(IrCmd::LOAD_TAG, build.vmReg(ra));
@@ -902,6 +1044,24 @@ void translateInstGetImport(IrBuilder& build, const Instruction* pc, int pcpos)
     build.inst(IrCmd::JUMP, next);
 }
 
+static int getVectorComponentIndex(IrBuilder& build, uint32_t k)
+{
+    LUAU_ASSERT(build.function.proto);
+    TValue protok = build.function.proto->k[k];
+
+    if (!ttisstring(&protok))
+        return -1;
+
+    const char* name = getstr(tsvalue(&protok));
+    int ic = (name[0] | ' ') - 'x';
+
+    // Vectors with a fourth component don't fit in a TValue that can be compiled
+    if (name[1] != '\0' || unsigned(ic) >= 3)
+        return -1;
+
+    return ic;
+}
+
 void translateInstGetTableKS(IrBuilder& build, const Instruction* pc, int pcpos)
 {
     int ra = LUAU_INSN_A(*pc);
@@ -909,9 +1069,14 @@ void translateInstGetTableKS(IrBuilder& build, const Instruction* pc, int pcpos)
     uint32_t aux = pc[1];
 
     IrOp fallback = build.block(IrBlockKind::Fallback);
+    IrOp slowpath = build.block(IrBlockKind::Fallback);
+
+    // Component names use the same case-insensitive match as the interpreter
+    int component = getVectorComponentIndex(build, aux);
+    IrOp vector = component >= 0 ? build.block(IrBlockKind::Fallback) : slowpath;
 
     IrOp tb = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
-    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TTABLE), fallback);
+    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TTABLE), vector);
 
     IrOp vb = build.inst(IrCmd::LOAD_POINTER, build.vmReg(rb));
 
@@ -925,6 +1090,25 @@ void translateInstGetTableKS(IrBuilder& build, const Instruction* pc, int pcpos)
     IrOp next = build.blockAtInst(pcpos + 2);
     FallbackStreamScope scope(build, fallback, next);
 
+    // Lookups that miss the slot predicted by the instruction go through the inline cache before the full fallback
+    build.inst(IrCmd::GET_FIELD_CACHED, build.constUint(pcpos), build.vmReg(ra), build.vmReg(rb), build.vmConst(aux), build.inlineCache(), slowpath);
+    build.inst(IrCmd::JUMP, next);
+
+    if (component >= 0)
+    {
+        build.beginBlock(vector);
+
+        IrOp tbv = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
+        build.inst(IrCmd::CHECK_TAG, tbv, build.constTag(LUA_TVECTOR), slowpath);
+
+        IrOp vc = build.inst(IrCmd::LOAD_FLOAT, build.vmReg(rb), build.constInt(component * sizeof(float)));
+
+        build.inst(IrCmd::STORE_DOUBLE, build.vmReg(ra), vc);
+        build.inst(IrCmd::STORE_TAG, build.vmReg(ra), build.constTag(LUA_TNUMBER));
+        build.inst(IrCmd::JUMP, next);
+    }
+
+    build.beginBlock(slowpath);
     build.inst(IrCmd::FALLBACK_GETTABLEKS, build.constUint(pcpos), build.vmReg(ra), build.vmReg(rb), build.vmConst(aux));
     build.inst(IrCmd::JUMP, next);
 }
@@ -936,16 +1120,17 @@ void translateInstSetTableKS(IrBuilder& build, const Instruction* pc, int pcpos)
     uint32_t aux = pc[1];
 
     IrOp fallback = build.block(IrBlockKind::Fallback);
+    IrOp slowpath = build.block(IrBlockKind::Fallback);
 
     IrOp tb = build.inst(IrCmd::LOAD_TAG, build.vmReg(rb));
-    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TTABLE), fallback);
+    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TTABLE), slowpath);
 
     IrOp vb = build.inst(IrCmd::LOAD_POINTER, build.vmReg(rb));
 
     IrOp addrSlotEl = build.inst(IrCmd::GET_SLOT_NODE_ADDR, vb, build.constUint(pcpos));
 
     build.inst(IrCmd::CHECK_SLOT_MATCH, addrSlotEl, build.vmConst(aux), fallback);
-    build.inst(IrCmd::CHECK_READONLY, vb, fallback);
+    build.inst(IrCmd::CHECK_READONLY, vb, slowpath);
 
     IrOp tva = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(ra));
     build.inst(IrCmd::STORE_NODE_VALUE_TV, addrSlotEl, tva);
@@ -955,6 +1140,10 @@ void translateInstSetTableKS(IrBuilder& build, const Instruction* pc, int pcpos)
     IrOp next = build.blockAtInst(pcpos + 2);
     FallbackStreamScope scope(build, fallback, next);
 
+    build.inst(IrCmd::SET_FIELD_CACHED, build.constUint(pcpos), build.vmReg(ra), build.vmReg(rb), build.vmConst(aux), build.inlineCache(), slowpath);
+    build.inst(IrCmd::JUMP, next);
+
+    build.beginBlock(slowpath);
     build.inst(IrCmd::FALLBACK_SETTABLEKS, build.constUint(pcpos), build.vmReg(ra), build.vmReg(rb), build.vmConst(aux));
     build.inst(IrCmd::JUMP, next);
 }
@@ -1042,5 +1231,335 @@ void translateInstCapture(IrBuilder& build, const Instruction* pc, int pcpos)
     }
 }
 
+// Only functions that are a short sequence of instructions without branches, calls or side effects are inlined
+// When a check fails in the inlined code, the original call is performed instead, which has to observe the same arguments
+constexpr int kInlinedCallMaxInstructions = 32;
+
+constexpr uint8_t kUnknownTag = 0xff;
+
+static bool isInlinedConstant(const TValue* k)
+{
+    return ttisnil(k) || ttisboolean(k) || ttisnumber(k);
+}
+
+static bool canInlineCall(Proto* proto, int ra, int nparams, int nresults, Proto* callee)
+{
+    if (nparams == LUA_MULTRET || nresults == LUA_MULTRET || callee->is_vararg)
+        return false;
+
+    // Inlined function doesn't get a frame of its own, its registers follow the arguments in the stack space of the caller
+    // The space includes EXTRA_STACK slots beyond the frame top, which are only used while calling metamethods
+    if (ra + 1 + callee->maxstacksize > proto->maxstacksize + EXTRA_STACK || ra + 1 + callee->maxstacksize > 255)
+        return false;
+
+    for (int i = 0; i < callee->sizecode && i < kInlinedCallMaxInstructions;)
+    {
+        Instruction insn = callee->code[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        i += getOpLength(op);
+
+        switch (op)
+        {
+        case LOP_NOP:
+            continue;
+        case LOP_RETURN:
+            return LUAU_INSN_B(insn) != 0;
+        case LOP_LOADB:
+            if (LUAU_INSN_C(insn) != 0)
+                return false;
+            break;
+        case LOP_LOADK:
+            if (!isInlinedConstant(&callee->k[LUAU_INSN_D(insn)]))
+                return false;
+            break;
+        case LOP_ADDK:
+        case LOP_SUBK:
+        case LOP_MULK:
+        case LOP_DIVK:
+        case LOP_MODK:
+        case LOP_POWK:
+            if (!ttisnumber(&callee->k[LUAU_INSN_C(insn)]))
+                return false;
+            break;
+        case LOP_LOADNIL:
+        case LOP_LOADN:
+        case LOP_MOVE:
+        case LOP_ADD:
+        case LOP_SUB:
+        case LOP_MUL:
+        case LOP_DIV:
+        case LOP_MOD:
+        case LOP_POW:
+        case LOP_MINUS:
+        case LOP_NOT:
+        case LOP_GETTABLEN:
+        case LOP_GETTABLEKS:
+            break;
+        default:
+            return false;
+        }
+
+        // Parameter registers hold the arguments of the original call
+        if (LUAU_INSN_A(insn) < callee->numparams)
+            return false;
+    }
+
+    return false;
+}
+
+static void translateInlinedConstant(IrBuilder& build, IrOp ra, const TValue* k)
+{
+    if (ttisnumber(k))
+    {
+        build.inst(IrCmd::STORE_DOUBLE, ra, build.constDouble(nvalue(k)));
+        build.inst(IrCmd::STORE_TAG, ra, build.constTag(LUA_TNUMBER));
+    }
+    else if (ttisboolean(k))
+    {
+        build.inst(IrCmd::STORE_INT, ra, build.constInt(bvalue(k)));
+        build.inst(IrCmd::STORE_TAG, ra, build.constTag(LUA_TBOOLEAN));
+    }
+    else
+    {
+        build.inst(IrCmd::STORE_TAG, ra, build.constTag(LUA_TNIL));
+    }
+}
+
+static void translateInlinedArith(IrBuilder& build, IrCmd cmd, IrOp ra, IrOp rb, IrOp opc, IrOp fallback)
+{
+    IrOp tb = build.inst(IrCmd::LOAD_TAG, rb);
+    build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TNUMBER), fallback);
+
+    IrOp vc = opc;
+
+    if (opc.kind == IrOpKind::VmReg)
+    {
+        IrOp tc = build.inst(IrCmd::LOAD_TAG, opc);
+        build.inst(IrCmd::CHECK_TAG, tc, build.constTag(LUA_TNUMBER), fallback);
+
+        vc = build.inst(IrCmd::LOAD_DOUBLE, opc);
+    }
+
+    IrOp vb = build.inst(IrCmd::LOAD_DOUBLE, rb);
+    IrOp va = cmd == IrCmd::UNM_NUM ? build.inst(cmd, vb) : build.inst(cmd, vb, vc);
+
+    build.inst(IrCmd::STORE_DOUBLE, ra, va);
+    build.inst(IrCmd::STORE_TAG, ra, build.constTag(LUA_TNUMBER));
+}
+
+static IrCmd getInlinedArithCmd(LuauOpcode op)
+{
+    switch (op)
+    {
+    case LOP_ADD:
+    case LOP_ADDK:
+        return IrCmd::ADD_NUM;
+    case LOP_SUB:
+    case LOP_SUBK:
+        return IrCmd::SUB_NUM;
+    case LOP_MUL:
+    case LOP_MULK:
+        return IrCmd::MUL_NUM;
+    case LOP_DIV:
+    case LOP_DIVK:
+        return IrCmd::DIV_NUM;
+    case LOP_MOD:
+    case LOP_MODK:
+        return IrCmd::MOD_NUM;
+    case LOP_POW:
+    case LOP_POWK:
+        return IrCmd::POW_NUM;
+    default:
+        LUAU_ASSERT(!"unsupported arithmetic instruction");
+        return IrCmd::NOP;
+    }
+}
+
+bool translateInlinedCall(IrBuilder& build, const Instruction* pc, int pcpos, Proto* callee)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int nparams = LUAU_INSN_B(*pc) - 1;
+    int nresults = LUAU_INSN_C(*pc) - 1;
+
+    if (!canInlineCall(build.function.proto, ra, nparams, nresults, callee))
+        return false;
+
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    IrOp tf = build.inst(IrCmd::LOAD_TAG, build.vmReg(ra));
+    build.inst(IrCmd::CHECK_TAG, tf, build.constTag(LUA_TFUNCTION), fallback);
+
+    IrOp vf = build.inst(IrCmd::LOAD_POINTER, build.vmReg(ra));
+    build.inst(IrCmd::CHECK_CALL_TARGET, vf, build.constUint(pcpos), fallback);
+
+    // Registers of the called function start at the first argument, where the frame of the call would have them
+    int base = ra + 1;
+
+    auto reg = [&](int index) {
+        return build.vmReg(uint8_t(base + index));
+    };
+
+    // Tags of the registers written by the inlined code, results that are known to be numbers don't have to be copied as a TValue
+    std::vector<uint8_t> tags(callee->maxstacksize, kUnknownTag);
+
+    for (int i = nparams; i < callee->numparams; i++)
+    {
+        build.inst(IrCmd::STORE_TAG, reg(i), build.constTag(LUA_TNIL));
+        tags[i] = LUA_TNIL;
+    }
+
+    for (const Instruction* cpc = callee->code;; cpc += getOpLength(LuauOpcode(LUAU_INSN_OP(*cpc))))
+    {
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(*cpc));
+
+        if (op == LOP_RETURN)
+        {
+            int rr = LUAU_INSN_A(*cpc);
+            int count = LUAU_INSN_B(*cpc) - 1;
+
+            // Results are moved down to the function register, so they can be copied in order
+            for (int i = 0; i < nresults; i++)
+            {
+                IrOp result = build.vmReg(uint8_t(ra + i));
+                uint8_t tag = i < count ? tags[rr + i] : LUA_TNIL;
+
+                if (tag == LUA_TNUMBER)
+                {
+                    IrOp value = build.inst(IrCmd::LOAD_DOUBLE, reg(rr + i));
+                    build.inst(IrCmd::STORE_DOUBLE, result, value);
+                    build.inst(IrCmd::STORE_TAG, result, build.constTag(LUA_TNUMBER));
+                }
+                else if (tag == LUA_TBOOLEAN)
+                {
+                    IrOp value = build.inst(IrCmd::LOAD_INT, reg(rr + i));
+                    build.inst(IrCmd::STORE_INT, result, value);
+                    build.inst(IrCmd::STORE_TAG, result, build.constTag(LUA_TBOOLEAN));
+                }
+                else if (tag == LUA_TNIL)
+                {
+                    build.inst(IrCmd::STORE_TAG, result, build.constTag(LUA_TNIL));
+                }
+                else
+                {
+                    IrOp tv = build.inst(IrCmd::LOAD_TVALUE, reg(rr + i));
+                    build.inst(IrCmd::STORE_TVALUE, result, tv);
+                }
+            }
+
+            break;
+        }
+
+        switch (op)
+        {
+        case LOP_NOP:
+            break;
+        case LOP_LOADNIL:
+            build.inst(IrCmd::STORE_TAG, reg(LUAU_INSN_A(*cpc)), build.constTag(LUA_TNIL));
+            tags[LUAU_INSN_A(*cpc)] = LUA_TNIL;
+            break;
+        case LOP_LOADB:
+            build.inst(IrCmd::STORE_INT, reg(LUAU_INSN_A(*cpc)), build.constInt(LUAU_INSN_B(*cpc)));
+            build.inst(IrCmd::STORE_TAG, reg(LUAU_INSN_A(*cpc)), build.constTag(LUA_TBOOLEAN));
+            tags[LUAU_INSN_A(*cpc)] = LUA_TBOOLEAN;
+            break;
+        case LOP_LOADN:
+            build.inst(IrCmd::STORE_DOUBLE, reg(LUAU_INSN_A(*cpc)), build.constDouble(double(LUAU_INSN_D(*cpc))));
+            build.inst(IrCmd::STORE_TAG, reg(LUAU_INSN_A(*cpc)), build.constTag(LUA_TNUMBER));
+            tags[LUAU_INSN_A(*cpc)] = LUA_TNUMBER;
+            break;
+        case LOP_LOADK:
+            translateInlinedConstant(build, reg(LUAU_INSN_A(*cpc)), &callee->k[LUAU_INSN_D(*cpc)]);
+            tags[LUAU_INSN_A(*cpc)] = ttype(&callee->k[LUAU_INSN_D(*cpc)]);
+            break;
+        case LOP_MOVE:
+        {
+            IrOp tv = build.inst(IrCmd::LOAD_TVALUE, reg(LUAU_INSN_B(*cpc)));
+            build.inst(IrCmd::STORE_TVALUE, reg(LUAU_INSN_A(*cpc)), tv);
+            tags[LUAU_INSN_A(*cpc)] = tags[LUAU_INSN_B(*cpc)];
+            break;
+        }
+        case LOP_ADD:
+        case LOP_SUB:
+        case LOP_MUL:
+        case LOP_DIV:
+        case LOP_MOD:
+        case LOP_POW:
+            translateInlinedArith(build, getInlinedArithCmd(op), reg(LUAU_INSN_A(*cpc)), reg(LUAU_INSN_B(*cpc)), reg(LUAU_INSN_C(*cpc)), fallback);
+            tags[LUAU_INSN_A(*cpc)] = LUA_TNUMBER;
+            break;
+        case LOP_ADDK:
+        case LOP_SUBK:
+        case LOP_MULK:
+        case LOP_DIVK:
+        case LOP_MODK:
+        case LOP_POWK:
+        {
+            IrOp kc = build.constDouble(nvalue(&callee->k[LUAU_INSN_C(*cpc)]));
+            translateInlinedArith(build, getInlinedArithCmd(op), reg(LUAU_INSN_A(*cpc)), reg(LUAU_INSN_B(*cpc)), kc, fallback);
+            tags[LUAU_INSN_A(*cpc)] = LUA_TNUMBER;
+            break;
+        }
+        case LOP_MINUS:
+            translateInlinedArith(build, IrCmd::UNM_NUM, reg(LUAU_INSN_A(*cpc)), reg(LUAU_INSN_B(*cpc)), {}, fallback);
+            tags[LUAU_INSN_A(*cpc)] = LUA_TNUMBER;
+            break;
+        case LOP_NOT:
+        {
+            IrOp tb = build.inst(IrCmd::LOAD_TAG, reg(LUAU_INSN_B(*cpc)));
+            IrOp vb = build.inst(IrCmd::LOAD_INT, reg(LUAU_INSN_B(*cpc)));
+
+            IrOp va = build.inst(IrCmd::NOT_ANY, tb, vb);
+
+            build.inst(IrCmd::STORE_INT, reg(LUAU_INSN_A(*cpc)), va);
+            build.inst(IrCmd::STORE_TAG, reg(LUAU_INSN_A(*cpc)), build.constTag(LUA_TBOOLEAN));
+            tags[LUAU_INSN_A(*cpc)] = LUA_TBOOLEAN;
+            break;
+        }
+        case LOP_GETTABLEN:
+        {
+            int c = LUAU_INSN_C(*cpc);
+
+            IrOp tb = build.inst(IrCmd::LOAD_TAG, reg(LUAU_INSN_B(*cpc)));
+            build.inst(IrCmd::CHECK_TAG, tb, build.constTag(LUA_TTABLE), fallback);
+
+            IrOp vb = build.inst(IrCmd::LOAD_POINTER, reg(LUAU_INSN_B(*cpc)));
+
+            build.inst(IrCmd::CHECK_ARRAY_SIZE, vb, build.constInt(c), fallback);
+            build.inst(IrCmd::CHECK_NO_METATABLE, vb, fallback);
+
+            IrOp arrEl = build.inst(IrCmd::GET_ARR_ADDR, vb, build.constInt(c));
+
+            IrOp arrElTval = build.inst(IrCmd::LOAD_TVALUE, arrEl);
+            build.inst(IrCmd::STORE_TVALUE, reg(LUAU_INSN_A(*cpc)), arrElTval);
+            tags[LUAU_INSN_A(*cpc)] = kUnknownTag;
+            break;
+        }
+        case LOP_GETTABLEKS:
+        {
+            // Slot prediction of the instruction can't be used from the code of another function, the lookup goes through an inline cache
+            // Lookups that need a metamethod call perform the original call instead
+            uint32_t cpcpos = uint32_t(cpc - callee->code);
+
+            build.inst(IrCmd::GET_FIELD_CACHED, build.constUint(cpcpos), reg(LUAU_INSN_A(*cpc)), reg(LUAU_INSN_B(*cpc)), {},
+                build.inlineCache(callee), fallback);
+            tags[LUAU_INSN_A(*cpc)] = kUnknownTag;
+            break;
+        }
+        default:
+            LUAU_ASSERT(!"unsupported instruction in an inlined call");
+            break;
+        }
+    }
+
+    IrOp next = build.blockAtInst(pcpos + 1);
+    FallbackStreamScope scope(build, fallback, next);
+
+    build.inst(IrCmd::LOP_CALL, build.constUint(pcpos), build.vmReg(ra), build.constInt(nparams), build.constInt(nresults));
+    build.inst(IrCmd::JUMP, next);
+
+    return true;
+}
+
 } // namespace CodeGen
 } // namespace Luau
@@ -5,6 +5,7 @@
 
 #include "ltm.h"
 
+struct Proto;
 typedef uint32_t Instruction;
 
 namespace Luau
@@ -61,6 +62,7 @@ void translateInstGetGlobal(IrBuilder& build, const Instruction* pc, int pcpos);
 void translateInstSetGlobal(IrBuilder& build, const Instruction* pc, int pcpos);
 void translateInstConcat(IrBuilder& build, const Instruction* pc, int pcpos);
 void translateInstCapture(IrBuilder& build, const Instruction* pc, int pcpos);
+bool translateInlinedCall(IrBuilder& build, const Instruction* pc, int pcpos, Proto* callee);
 
 } // namespace CodeGen
 } // namespace Luau
@@ -0,0 +1,300 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "NativeCache.h"
+
+#include "Luau/Bytecode.h"
+#include "Luau/Common.h"
+
+#include "lstate.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h> // __cpuid
+#else
+#include <cpuid.h> // __cpuid
+#endif
+#endif
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Has to be updated every time the generated code or the serialized layout changes
+constexpr uint32_t kSerializedMagic = 0x434e554c; // 'LUNC'
+constexpr uint32_t kSerializedVersion = 2;
+
+enum class SerializedTarget : uint32_t
+{
+    Unknown,
+    X64,
+    A64,
+};
+
+struct BytecodeHasher
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+
+    void add(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    template<typename T>
+    void add(T value)
+    {
+        add(&value, sizeof(value));
+    }
+};
+
+static uint32_t getStableInstruction(Instruction insn)
+{
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_GETGLOBAL:
+    case LOP_SETGLOBAL:
+    case LOP_GETTABLEKS:
+    case LOP_SETTABLEKS:
+    case LOP_NAMECALL:
+        // Slot prediction is updated by the interpreter and the native code only reads it at runtime
+        return insn & 0x00ffffffu;
+    case LOP_COVERAGE:
+        // Hit counter
+        return insn & 0xffu;
+    default:
+        return insn;
+    }
+}
+
+uint64_t getBytecodeHash(const std::vector<Proto*>& protos)
+{
+    BytecodeHasher hasher;
+
+    hasher.add(uint32_t(protos.size()));
+
+    for (Proto* proto : protos)
+    {
+        if (!proto)
+        {
+            hasher.add(uint8_t(0));
+            continue;
+        }
+
+        hasher.add(uint8_t(1));
+        hasher.add(proto->numparams);
+        hasher.add(proto->is_vararg);
+        hasher.add(proto->maxstacksize);
+        hasher.add(proto->nups);
+        hasher.add(proto->sizep);
+
+        hasher.add(proto->sizecode);
+
+        for (int i = 0; i < proto->sizecode; i++)
+            hasher.add(getStableInstruction(proto->code[i]));
+
+        hasher.add(proto->sizek);
+
+        for (int i = 0; i < proto->sizek; i++)
+        {
+            const TValue* k = &proto->k[i];
+
+            hasher.add(uint8_t(ttype(k)));
+
+            // Values of other object types (imports that were resolved at load time) are only observed at runtime
+            if (ttisboolean(k))
+                hasher.add(bvalue(k));
+            else if (ttisnumber(k))
+                hasher.add(nvalue(k));
+            else if (ttisvector(k))
+                hasher.add(vvalue(k), sizeof(float) * LUA_VECTOR_SIZE);
+            else if (ttisstring(k))
+                hasher.add(getstr(tsvalue(k)), tsvalue(k)->len);
+        }
+    }
+
+    return hasher.hash;
+}
+
+uint32_t getHostTarget()
+{
+#if defined(__aarch64__)
+    return uint32_t(SerializedTarget::A64);
+#elif defined(__x86_64__) || defined(_M_X64)
+    return uint32_t(SerializedTarget::X64);
+#else
+    return uint32_t(SerializedTarget::Unknown);
+#endif
+}
+
+uint32_t getHostCpuFeatures()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    int cpuinfo[4] = {};
+    int cpuinfo7[4] = {};
+
+#ifdef _MSC_VER
+    __cpuid(cpuinfo, 0);
+    int maxLeaf = cpuinfo[0];
+
+    __cpuid(cpuinfo, 1);
+
+    if (maxLeaf >= 7)
+        __cpuidex(cpuinfo7, 7, 0);
+#else
+    int maxLeaf = __get_cpuid_max(0, nullptr);
+
+    __cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+
+    if (maxLeaf >= 7)
+        __cpuid_count(7, 0, cpuinfo7[0], cpuinfo7[1], cpuinfo7[2], cpuinfo7[3]);
+#endif
+
+    // Instruction set extensions that the code generator might rely on
+    // https://en.wikipedia.org/wiki/CPUID#EAX=1:_Processor_Info_and_Feature_Bits
+    uint32_t features = 0;
+    features |= ((cpuinfo[2] >> 19) & 1) << 0; // SSE4.1
+    features |= ((cpuinfo[2] >> 20) & 1) << 1; // SSE4.2
+    features |= ((cpuinfo[2] >> 23) & 1) << 2; // POPCNT
+    features |= ((cpuinfo[2] >> 28) & 1) << 3; // AVX
+    features |= ((cpuinfo[2] >> 12) & 1) << 4; // FMA
+    features |= ((cpuinfo[2] >> 29) & 1) << 5; // F16C
+    features |= ((cpuinfo7[1] >> 5) & 1) << 6; // AVX2
+    features |= ((cpuinfo7[1] >> 3) & 1) << 7; // BMI1
+    features |= ((cpuinfo7[1] >> 8) & 1) << 8; // BMI2
+
+    return features;
+#else
+    return 0;
+#endif
+}
+
+static void writeBytes(std::string& result, const void* data, size_t size)
+{
+    result.append(static_cast<const char*>(data), size);
+}
+
+template<typename T>
+static void write(std::string& result, T value)
+{
+    writeBytes(result, &value, sizeof(value));
+}
+
+struct SerializedReader
+{
+    const char* pos;
+    const char* end;
+
+    bool readBytes(void* data, size_t size)
+    {
+        if (size_t(end - pos) < size)
+            return false;
+
+        memcpy(data, pos, size);
+        pos += size;
+        return true;
+    }
+
+    template<typename T>
+    bool read(T& value)
+    {
+        return readBytes(&value, sizeof(value));
+    }
+
+    template<typename T>
+    bool readArray(std::vector<T>& values)
+    {
+        uint32_t count = 0;
+
+        if (!read(count) || size_t(end - pos) / sizeof(T) < count)
+            return false;
+
+        values.resize(count);
+        return count == 0 || readBytes(values.data(), count * sizeof(T));
+    }
+};
+
+template<typename T>
+static void writeArray(std::string& result, const std::vector<T>& values)
+{
+    write(result, uint32_t(values.size()));
+
+    if (!values.empty())
+        writeBytes(result, values.data(), values.size() * sizeof(T));
+}
+
+std::string serializeModule(const SerializedModule& module)
+{
+    std::string result;
+
+    write(result, kSerializedMagic);
+    write(result, kSerializedVersion);
+    write(result, module.target);
+    write(result, module.cpuFeatures);
+    write(result, module.flags);
+    write(result, module.bytecodeHash);
+
+    writeArray(result, module.data);
+    writeArray(result, module.code);
+
+    write(result, uint32_t(module.functions.size()));
+
+    for (const SerializedFunction& function : module.functions)
+    {
+        write(result, function.bytecodeId);
+        write(result, function.location);
+        writeArray(result, function.instOffsets);
+        writeArray(result, function.inlineCachePcs);
+    }
+
+    return result;
+}
+
+bool deserializeModule(SerializedModule& module, const char* data, size_t size)
+{
+    SerializedReader reader{data, data + size};
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+
+    if (!reader.read(magic) || magic != kSerializedMagic || !reader.read(version) || version != kSerializedVersion)
+        return false;
+
+    if (!reader.read(module.target) || !reader.read(module.cpuFeatures) || !reader.read(module.flags) || !reader.read(module.bytecodeHash))
+        return false;
+
+    if (!reader.readArray(module.data) || !reader.readArray(module.code))
+        return false;
+
+    uint32_t functionCount = 0;
+
+    if (!reader.read(functionCount))
+        return false;
+
+    module.functions.clear();
+
+    for (uint32_t i = 0; i < functionCount; i++)
+    {
+        SerializedFunction function;
+
+        if (!reader.read(function.bytecodeId) || !reader.read(function.location))
+            return false;
+
+        if (!reader.readArray(function.instOffsets) || !reader.readArray(function.inlineCachePcs))
+            return false;
+
+        if (function.location >= module.code.size())
+            return false;
+
+        module.functions.push_back(std::move(function));
+    }
+
+    return reader.pos == reader.end;
+}
+
+} // namespace CodeGen
+} // namespace Luau
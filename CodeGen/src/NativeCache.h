@@ -0,0 +1,60 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "lobject.h"
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Location of a compiled function in the serialized code, all offsets are in bytes from the start of the code
+struct SerializedFunction
+{
+    uint32_t bytecodeId = 0;
+    uint32_t location = 0;
+
+    // Offsets of instructions relative to the function location, one for each bytecode instruction
+    std::vector<uint32_t> instOffsets;
+
+    // Bytecode instruction index of each inline cache, ~0u for caches of instructions that were removed
+    std::vector<uint32_t> inlineCachePcs;
+};
+
+// Native code and the data required to link it to functions of a module in another process
+// Generated code only references helper functions through the native context register and its own data through relative addressing
+// This makes it possible to place the code anywhere without patching it
+struct SerializedModule
+{
+    // Code can only be reused with the same bytecode, target and CPU features
+    uint64_t bytecodeHash = 0;
+    uint32_t target = 0;
+    uint32_t cpuFeatures = 0;
+    uint32_t flags = 0;
+
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> code;
+
+    std::vector<SerializedFunction> functions;
+};
+
+// Hash of the bytecode and constants of the functions that affect the generated code
+// Slot predictions and coverage counters that are patched by the interpreter at runtime are excluded
+uint64_t getBytecodeHash(const std::vector<Proto*>& protos);
+
+uint32_t getHostTarget();
+uint32_t getHostCpuFeatures();
+
+std::string serializeModule(const SerializedModule& module);
+
+// Returns false if the data is malformed or was produced by a different version of the code generator
+bool deserializeModule(SerializedModule& module, const char* data, size_t size);
+
+} // namespace CodeGen
+} // namespace Luau
@@ -108,6 +108,9 @@ void initHelperFunctions(NativeState& data)
     data.context.forgPrepXnextFallback = forgPrepXnextFallback;
     data.context.callProlog = callProlog;
     data.context.callEpilogC = callEpilogC;
+    data.context.getFieldCached = getFieldCached;
+    data.context.setFieldCached = setFieldCached;
+    data.context.getMethodCached = getMethodCached;
 }
 
 } // namespace CodeGen
@@ -3,9 +3,12 @@
 
 #include "Luau/Bytecode.h"
 #include "Luau/CodeAllocator.h"
+#include "Luau/CodeGen.h"
 #include "Luau/Label.h"
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <stdint.h>
 
@@ -33,6 +36,48 @@ struct NativeFallback
     uint8_t flags;
 };
 
+constexpr int kInlineCacheEntries = 4;
+constexpr int kInlineCacheMaxDepth = 4;
+
+// Describes how a string key was found for tables with a specific node layout and metatable
+struct InlineCacheEntry
+{
+    bool valid = false;
+    uint8_t lsizenode = 0;
+    Table* metatable = nullptr;
+
+    // Number of __index tables that were followed, slots of the __index key in each metatable and the slot of the key in the last table
+    uint8_t depth = 0;
+    uint8_t indexSlots[kInlineCacheMaxDepth] = {};
+    uint8_t slot = 0;
+};
+
+// Polymorphic inline cache of a single GETTABLEKS, SETTABLEKS or NAMECALL instruction
+struct InlineCache
+{
+    const Instruction* pc = nullptr;
+    TString* key = nullptr;
+
+    InlineCacheEntry entries[kInlineCacheEntries];
+    uint8_t nextEntry = 0; // Entry that is replaced on the next miss
+};
+
+// Function that was called by a call instruction while the function containing it was profiled
+struct CallTarget
+{
+    Proto* proto = nullptr;
+    bool polymorphic = false; // Different functions were called or the function was destroyed
+};
+
+// Executable memory with the code of functions that were compiled together, it's returned to the allocator with the last function
+struct NativeAllocation
+{
+    uint8_t* data = nullptr;
+    size_t size = 0;
+
+    uint32_t refs = 0;
+};
+
 struct NativeProto
 {
     uintptr_t entryTarget = 0;
@@ -40,6 +85,19 @@ struct NativeProto
 
     Proto* proto = nullptr;
     uint32_t location = 0;
+
+    InlineCache* inlineCaches = nullptr;
+    uint32_t inlineCacheCount = 0;
+
+    NativeAllocation* allocation = nullptr;
+
+    // Interpreter profile of a function waiting for tiered compilation, native code is only present once entryTarget is set
+    uint32_t callCount = 0;
+    uint32_t loopCount = 0;
+
+    // One entry for each instruction, allocated on the first call the function makes in the interpreter
+    // Native code that inlines a called function checks the closure against the entry, so it stays alive with the native code
+    CallTarget* callTargets = nullptr;
 };
 
 struct NativeContext
@@ -107,6 +165,9 @@ struct NativeContext
     void (*forgPrepXnextFallback)(lua_State* L, TValue* ra, int pc) = nullptr;
     Closure* (*callProlog)(lua_State* L, TValue* ra, StkId argtop, int nresults) = nullptr;
     void (*callEpilogC)(lua_State* L, int nresults, int n) = nullptr;
+    bool (*getFieldCached)(lua_State* L, StkId ra, StkId rb, int cacheIndex) = nullptr;
+    bool (*setFieldCached)(lua_State* L, StkId ra, StkId rb, int cacheIndex) = nullptr;
+    bool (*getMethodCached)(lua_State* L, StkId ra, StkId rb, int cacheIndex) = nullptr;
 };
 
 struct NativeState
@@ -121,6 +182,12 @@ struct NativeState
     size_t gateDataSize = 0;
 
     NativeContext context;
+
+    TieringOptions tieringOptions;
+    TieringStats tieringStats;
+
+    // Call target entries that refer to each function, they are reset when the function is destroyed or stops being profiled
+    std::unordered_map<Proto*, std::vector<CallTarget*>> callTargetRefs;
 };
 
 void initFallbackTable(NativeState& data);
@@ -2,16 +2,22 @@
 #include "Luau/OptimizeConstProp.h"
 
 #include "Luau/DenseHash.h"
+#include "Luau/IrAnalysis.h"
 #include "Luau/IrBuilder.h"
 #include "Luau/IrUtils.h"
 
 #include "lua.h"
 
+#include <string.h>
+
 namespace Luau
 {
 namespace CodeGen
 {
 
+// Number of attempts to find loop invariant knowledge before nothing is assumed about loop back edges
+constexpr int kMaxConstPropPasses = 4;
+
 // Data we know about the register value
 struct RegisterInfo
 {
@@ -61,7 +67,7 @@ struct ConstPropState
 
     void saveValue(IrOp op, IrOp value)
     {
-        LUAU_ASSERT(value.kind == IrOpKind::Constant);
+        LUAU_ASSERT(value.kind == IrOpKind::Constant || value.kind == IrOpKind::Inst);
 
         if (RegisterInfo* info = tryGetRegisterInfo(op))
             info->value = value;
@@ -102,6 +108,14 @@ struct ConstPropState
         invalidate(regs[regOp.index], /* invalidateTag */ true, /* invalidateValue */ true);
     }
 
+    void invalidateRegisterRange(IrOp regOp, int count)
+    {
+        LUAU_ASSERT(regOp.kind == IrOpKind::VmReg);
+
+        for (int i = int(regOp.index); i < int(regOp.index) + count && i <= maxReg; ++i)
+            invalidate(regs[i], /* invalidateTag */ true, /* invalidateValue */ true);
+    }
+
     void invalidateRegistersFrom(uint32_t firstReg)
     {
         for (int i = int(firstReg); i <= maxReg; ++i)
@@ -122,6 +136,41 @@ struct ConstPropState
         reg.knownNoMetatable = false;
     }
 
+    void invalidateCapturedRegisters(const std::bitset<256>& captured)
+    {
+        for (int i = 0; i <= maxReg; ++i)
+        {
+            if (captured.test(i))
+                invalidate(regs[i], /* invalidateTag */ true, /* invalidateValue */ true);
+        }
+    }
+
+    bool isPlainTable(IrOp regOp)
+    {
+        if (RegisterInfo* info = tryGetRegisterInfo(regOp))
+            return info->tag == LUA_TTABLE && info->knownNoMetatable;
+
+        return false;
+    }
+
+    // User code that is called by an instruction can't modify registers of the current frame, unless they are captured by a closure
+    void invalidateUserCall(const std::bitset<256>& captured)
+    {
+        invalidateHeap();
+        invalidateCapturedRegisters(captured);
+        inSafeEnv = false;
+    }
+
+    // Native code can be resumed at an interrupt location, so values computed before it can't be used after it
+    void invalidateInstValues()
+    {
+        for (int i = 0; i <= maxReg; ++i)
+        {
+            if (regs[i].value.kind == IrOpKind::Inst)
+                regs[i].value = {};
+        }
+    }
+
     void invalidateAll()
     {
         // Invalidating registers also invalidates what we know about the heap (stored in RegisterInfo)
@@ -181,6 +230,52 @@ struct ConstPropState
     DenseHashMap<uint32_t, RegisterLink> instLink{~0u};
 };
 
+// Register value can be represented by an instruction that has computed it, but that value can only replace a load of the same type
+static bool isDoubleValue(IrFunction& function, IrOp value)
+{
+    if (value.kind != IrOpKind::Inst)
+        return false;
+
+    switch (function.instOp(value).cmd)
+    {
+    case IrCmd::LOAD_DOUBLE:
+    case IrCmd::ADD_NUM:
+    case IrCmd::SUB_NUM:
+    case IrCmd::MUL_NUM:
+    case IrCmd::DIV_NUM:
+    case IrCmd::MOD_NUM:
+    case IrCmd::POW_NUM:
+    case IrCmd::UNM_NUM:
+    case IrCmd::TABLE_LEN:
+    case IrCmd::INT_TO_NUM:
+        return true;
+    default:
+        break;
+    }
+
+    return false;
+}
+
+static bool isIntValue(IrFunction& function, IrOp value)
+{
+    if (value.kind != IrOpKind::Inst)
+        return false;
+
+    switch (function.instOp(value).cmd)
+    {
+    case IrCmd::LOAD_INT:
+    case IrCmd::ADD_INT:
+    case IrCmd::SUB_INT:
+    case IrCmd::NUM_TO_INDEX:
+    case IrCmd::NOT_ANY:
+        return true;
+    default:
+        break;
+    }
+
+    return false;
+}
+
 static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction& function, IrBlock& block, IrInst& inst, uint32_t index)
 {
     switch (inst.cmd)
@@ -196,16 +291,28 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
             state.createRegLink(index, inst.a);
         break;
     case IrCmd::LOAD_DOUBLE:
-        if (IrOp value = state.tryGetValue(inst.a); value.kind == IrOpKind::Constant)
+        if (IrOp value = state.tryGetValue(inst.a); value.kind == IrOpKind::Constant || isDoubleValue(function, value))
+        {
             substitute(function, inst, value);
+        }
         else if (inst.a.kind == IrOpKind::VmReg)
+        {
             state.createRegLink(index, inst.a);
+
+            // Following loads of the same register can reuse the loaded value
+            state.saveValue(inst.a, IrOp{IrOpKind::Inst, index});
+        }
         break;
     case IrCmd::LOAD_INT:
-        if (IrOp value = state.tryGetValue(inst.a); value.kind == IrOpKind::Constant)
+        if (IrOp value = state.tryGetValue(inst.a); value.kind == IrOpKind::Constant || isIntValue(function, value))
+        {
             substitute(function, inst, value);
+        }
         else if (inst.a.kind == IrOpKind::VmReg)
+        {
             state.createRegLink(index, inst.a);
+            state.saveValue(inst.a, IrOp{IrOpKind::Inst, index});
+        }
         break;
     case IrCmd::LOAD_TVALUE:
         if (inst.a.kind == IrOpKind::VmReg)
@@ -246,6 +353,21 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
                 else
                     state.saveValue(inst.a, inst.b);
             }
+            else if (inst.b.kind == IrOpKind::Inst)
+            {
+                IrOp oldValue = state.tryGetValue(inst.a);
+
+                // Register already holds the value that was computed earlier (or loaded from it)
+                if (oldValue.kind == IrOpKind::Inst && oldValue.index == inst.b.index)
+                {
+                    kill(function, inst);
+                }
+                else
+                {
+                    state.invalidateValue(inst.a);
+                    state.saveValue(inst.a, inst.b);
+                }
+            }
             else
             {
                 state.invalidateValue(inst.a);
@@ -265,12 +387,30 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
                 else
                     state.saveValue(inst.a, inst.b);
             }
+            else if (inst.b.kind == IrOpKind::Inst)
+            {
+                IrOp oldValue = state.tryGetValue(inst.a);
+
+                if (oldValue.kind == IrOpKind::Inst && oldValue.index == inst.b.index)
+                {
+                    kill(function, inst);
+                }
+                else
+                {
+                    state.invalidateValue(inst.a);
+                    state.saveValue(inst.a, inst.b);
+                }
+            }
             else
             {
                 state.invalidateValue(inst.a);
             }
         }
         break;
+    case IrCmd::STORE_VECTOR:
+        if (inst.a.kind == IrOpKind::VmReg)
+            state.invalidateValue(inst.a);
+        break;
     case IrCmd::STORE_TVALUE:
         if (inst.a.kind == IrOpKind::VmReg)
         {
@@ -278,6 +418,8 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
 
             if (uint8_t tag = state.tryGetTag(inst.b); tag != 0xff)
                 state.saveTag(inst.a, tag);
+            else if (inst.b.kind == IrOpKind::Inst && function.instOp(inst.b).cmd == IrCmd::TAG_VECTOR)
+                state.saveTag(inst.a, LUA_TVECTOR);
 
             if (IrOp value = state.tryGetValue(inst.b); value.kind != IrOpKind::None)
                 state.saveValue(inst.a, value);
@@ -423,11 +565,13 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
 
         // These instructions don't have an effect on register/memory state we are tracking
     case IrCmd::NOP:
+    case IrCmd::LOAD_FLOAT:
     case IrCmd::LOAD_NODE_VALUE_TV:
     case IrCmd::LOAD_ENV:
     case IrCmd::GET_ARR_ADDR:
     case IrCmd::GET_SLOT_NODE_ADDR:
     case IrCmd::STORE_NODE_VALUE_TV:
+    case IrCmd::SET_FIELD_CACHED: // Only assigns to existing keys, metatables are not changed
     case IrCmd::ADD_INT:
     case IrCmd::SUB_INT:
     case IrCmd::ADD_NUM:
@@ -437,6 +581,12 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
     case IrCmd::MOD_NUM:
     case IrCmd::POW_NUM:
     case IrCmd::UNM_NUM:
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    case IrCmd::UNM_VEC:
+    case IrCmd::TAG_VECTOR:
     case IrCmd::NOT_ANY:
     case IrCmd::JUMP:
     case IrCmd::JUMP_EQ_POINTER:
@@ -445,14 +595,17 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
     case IrCmd::DUP_TABLE:
     case IrCmd::NUM_TO_INDEX:
     case IrCmd::INT_TO_NUM:
+    case IrCmd::NUM_TO_VEC:
     case IrCmd::CHECK_ARRAY_SIZE:
     case IrCmd::CHECK_SLOT_MATCH:
+    case IrCmd::CHECK_CALL_TARGET:
     case IrCmd::BARRIER_TABLE_BACK:
     case IrCmd::LOP_RETURN:
     case IrCmd::LOP_COVERAGE:
     case IrCmd::SET_UPVALUE:
     case IrCmd::LOP_SETLIST:  // We don't track table state that this can invalidate
     case IrCmd::SET_SAVEDPC:  // TODO: we may be able to remove some updates to PC
+    case IrCmd::EXIT_TO_VM:
     case IrCmd::CLOSE_UPVALS: // Doesn't change memory that we track
     case IrCmd::CAPTURE:
     case IrCmd::SUBSTITUTE:
@@ -460,41 +613,287 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
     case IrCmd::ADJUST_STACK_TO_TOP: // Changes stack top, but not the values
         break;
 
-        // We don't model the following instructions, so we just clear all the knowledge we have built up
-        // Many of these call user functions that can change memory and captured registers
-        // Some of these might yield with similar effects
-    case IrCmd::JUMP_CMP_ANY:
+        // These instructions can call user code, but only write to the specified registers of the current frame
     case IrCmd::DO_ARITH:
     case IrCmd::DO_LEN:
+    case IrCmd::GET_IMPORT:
+        state.invalidate(inst.a);
+        state.invalidateUserCall(function.cfg.captured);
+        break;
     case IrCmd::GET_TABLE:
+    {
+        // Lookup in a table without a metatable doesn't call user code
+        bool userCall = !state.isPlainTable(inst.b);
+
+        state.invalidate(inst.a);
+
+        if (userCall)
+            state.invalidateUserCall(function.cfg.captured);
+        break;
+    }
     case IrCmd::SET_TABLE:
-    case IrCmd::GET_IMPORT:
+        if (!state.isPlainTable(inst.b))
+            state.invalidateUserCall(function.cfg.captured);
+        break;
+    case IrCmd::JUMP_CMP_ANY:
+    case IrCmd::FALLBACK_SETGLOBAL:
+    case IrCmd::FALLBACK_SETTABLEKS:
+        state.invalidateUserCall(function.cfg.captured);
+        break;
     case IrCmd::CONCAT:
+        state.invalidateRegisterRange(inst.a, int(function.uintOp(inst.b)));
+        state.invalidateUserCall(function.cfg.captured);
+        break;
+    case IrCmd::FALLBACK_GETGLOBAL:
+    case IrCmd::FALLBACK_GETTABLEKS:
+        state.invalidate(inst.b);
+        state.invalidateUserCall(function.cfg.captured);
+        break;
+    case IrCmd::FALLBACK_NAMECALL:
+        state.invalidateRegisterRange(inst.b, 2);
+        state.invalidateUserCall(function.cfg.captured);
+        break;
+    case IrCmd::FALLBACK_NEWCLOSURE:
+    case IrCmd::FALLBACK_DUPCLOSURE:
+        state.invalidate(inst.b);
+        break;
+    case IrCmd::GET_FIELD_CACHED:
+        // Inline caches only follow __index tables and don't call user code
+        state.invalidate(inst.b);
+        break;
+    case IrCmd::GET_METHOD_CACHED:
+        state.invalidateRegisterRange(inst.b, 2);
+        break;
     case IrCmd::PREPARE_FORN:
-    case IrCmd::INTERRUPT: // TODO: it will be important to keep tag/value state, but we have to track register capture
+        // Loop parameters are converted to numbers (or an error is thrown)
+        for (IrOp reg : {inst.a, inst.b, inst.c})
+        {
+            state.invalidate(reg);
+            state.saveTag(reg, LUA_TNUMBER);
+        }
+        break;
+    case IrCmd::INTERRUPT:
+        // When a separate continuation is provided for the handler call, nothing changes on the main path
+        if (inst.b.kind == IrOpKind::None)
+        {
+            // Interrupt handler is user code as well, but native code might also be re-entered at this location after a yield
+            state.invalidateUserCall(function.cfg.captured);
+            state.invalidateInstValues();
+        }
+        break;
+
+        // We don't model the following instructions, so we just clear all the knowledge we have built up
+        // Many of these call user functions that can change memory and captured registers
+        // Some of these might yield with similar effects
     case IrCmd::LOP_NAMECALL:
     case IrCmd::LOP_CALL:
     case IrCmd::LOP_FORGLOOP:
     case IrCmd::LOP_FORGLOOP_FALLBACK:
     case IrCmd::LOP_FORGPREP_XNEXT_FALLBACK:
-    case IrCmd::FALLBACK_GETGLOBAL:
-    case IrCmd::FALLBACK_SETGLOBAL:
-    case IrCmd::FALLBACK_GETTABLEKS:
-    case IrCmd::FALLBACK_SETTABLEKS:
-    case IrCmd::FALLBACK_NAMECALL:
     case IrCmd::FALLBACK_PREPVARARGS:
     case IrCmd::FALLBACK_GETVARARGS:
-    case IrCmd::FALLBACK_NEWCLOSURE:
-    case IrCmd::FALLBACK_DUPCLOSURE:
     case IrCmd::FALLBACK_FORGPREP:
         // TODO: this is very conservative, some of there instructions can be tracked better
-        // TODO: non-captured register tags and values should not be cleared here
         state.invalidateAll();
         break;
     }
 }
 
-static void constPropInBlock(IrBuilder& build, IrBlock& block, ConstPropState& state)
+// Knowledge about the VM state that holds on all incoming edges of a block
+// Values computed by instructions are not included, those are only carried through direct jumps into unique successors
+struct BlockEntryState
+{
+    bool reached = false;
+    bool inSafeEnv = false;
+
+    // Registers after the last entry are unknown
+    std::vector<RegisterInfo> regs;
+};
+
+struct ConstPropFlow
+{
+    std::vector<uint8_t> processed;
+
+    // Knowledge merged from forward edges and loop back edges of each block in the current pass
+    std::vector<BlockEntryState> entries;
+    std::vector<BlockEntryState> backEdges;
+
+    // What blocks with loop back edges were optimized with in the current pass
+    std::vector<BlockEntryState> used;
+
+    // What we assume about loop back edges, this is narrowed down between passes
+    std::vector<BlockEntryState> assumptions;
+};
+
+static bool isSameConstant(IrFunction& function, IrOp a, IrOp b)
+{
+    if (a.kind != IrOpKind::Constant || b.kind != IrOpKind::Constant)
+        return false;
+
+    if (a.index == b.index)
+        return true;
+
+    const IrConst& ca = function.constOp(a);
+    const IrConst& cb = function.constOp(b);
+
+    if (ca.kind != cb.kind)
+        return false;
+
+    switch (ca.kind)
+    {
+    case IrConstKind::Bool:
+        return ca.valueBool == cb.valueBool;
+    case IrConstKind::Int:
+        return ca.valueInt == cb.valueInt;
+    case IrConstKind::Uint:
+        return ca.valueUint == cb.valueUint;
+    case IrConstKind::Double:
+        // Bitwise comparison keeps 0.0 and -0.0 apart
+        return memcmp(&ca.valueDouble, &cb.valueDouble, sizeof(double)) == 0;
+    case IrConstKind::Tag:
+        return ca.valueTag == cb.valueTag;
+    }
+
+    return false;
+}
+
+static bool isSameRegisterInfo(IrFunction& function, const RegisterInfo& a, const RegisterInfo& b)
+{
+    if (a.tag != b.tag || a.knownNotReadonly != b.knownNotReadonly || a.knownNoMetatable != b.knownNoMetatable)
+        return false;
+
+    if (a.value.kind == IrOpKind::None || b.value.kind == IrOpKind::None)
+        return a.value.kind == b.value.kind;
+
+    return isSameConstant(function, a.value, b.value);
+}
+
+static bool isSameEntryState(IrFunction& function, const BlockEntryState& a, const BlockEntryState& b)
+{
+    if (a.reached != b.reached || a.inSafeEnv != b.inSafeEnv)
+        return false;
+
+    RegisterInfo unknown;
+
+    for (size_t i = 0; i < a.regs.size() || i < b.regs.size(); i++)
+    {
+        const RegisterInfo& ra = i < a.regs.size() ? a.regs[i] : unknown;
+        const RegisterInfo& rb = i < b.regs.size() ? b.regs[i] : unknown;
+
+        if (!isSameRegisterInfo(function, ra, rb))
+            return false;
+    }
+
+    return true;
+}
+
+static void mergeEntryState(IrFunction& function, BlockEntryState& target, const RegisterInfo* regs, size_t count, bool inSafeEnv)
+{
+    if (!target.reached)
+    {
+        target.reached = true;
+        target.inSafeEnv = inSafeEnv;
+        target.regs.assign(regs, regs + count);
+
+        for (RegisterInfo& reg : target.regs)
+        {
+            if (reg.value.kind != IrOpKind::Constant)
+                reg.value = {};
+
+            reg.version = 0;
+        }
+
+        return;
+    }
+
+    target.inSafeEnv = target.inSafeEnv && inSafeEnv;
+
+    if (count < target.regs.size())
+        target.regs.resize(count);
+
+    for (size_t i = 0; i < target.regs.size(); i++)
+    {
+        RegisterInfo& reg = target.regs[i];
+
+        if (reg.tag != regs[i].tag)
+            reg.tag = 0xff;
+
+        if (!isSameConstant(function, reg.value, regs[i].value))
+            reg.value = {};
+
+        reg.knownNotReadonly = reg.knownNotReadonly && regs[i].knownNotReadonly;
+        reg.knownNoMetatable = reg.knownNoMetatable && regs[i].knownNoMetatable;
+    }
+}
+
+static void mergeEntryState(IrFunction& function, BlockEntryState& target, const ConstPropState& state)
+{
+    mergeEntryState(function, target, state.regs, size_t(state.maxReg + 1), state.inSafeEnv);
+}
+
+static void mergeEntryState(IrFunction& function, BlockEntryState& target, const BlockEntryState& source)
+{
+    if (source.reached)
+        mergeEntryState(function, target, source.regs.data(), source.regs.size(), source.inSafeEnv);
+}
+
+static void loadEntryState(ConstPropState& state, const BlockEntryState& entry)
+{
+    LUAU_ASSERT(entry.regs.size() <= 256);
+
+    for (size_t i = 0; i < entry.regs.size(); i++)
+        state.regs[i] = entry.regs[i];
+
+    state.maxReg = entry.regs.empty() ? 0 : int(entry.regs.size()) - 1;
+    state.inSafeEnv = entry.inSafeEnv;
+}
+
+static BlockEntryState& getSuccessorEntry(ConstPropFlow& flow, IrOp block)
+{
+    LUAU_ASSERT(block.kind == IrOpKind::Block);
+
+    // Successor that was already processed in the current pass is reached through a loop back edge
+    return flow.processed[block.index] ? flow.backEdges[block.index] : flow.entries[block.index];
+}
+
+static void mergeIntoSuccessors(ConstPropFlow& flow, IrFunction& function, const IrInst& inst, const ConstPropState& state)
+{
+    auto checkOp = [&](IrOp op) {
+        if (op.kind == IrOpKind::Block)
+            mergeEntryState(function, getSuccessorEntry(flow, op), state);
+    };
+
+    checkOp(inst.a);
+    checkOp(inst.b);
+    checkOp(inst.c);
+    checkOp(inst.d);
+    checkOp(inst.e);
+    checkOp(inst.f);
+}
+
+static void mergeUserCallIntoSuccessor(ConstPropFlow& flow, IrFunction& function, IrOp block, const ConstPropState& state)
+{
+    BlockEntryState afterCall;
+    mergeEntryState(function, afterCall, state);
+
+    // Same as ConstPropState::invalidateUserCall
+    afterCall.inSafeEnv = false;
+
+    for (size_t i = 0; i < afterCall.regs.size(); i++)
+    {
+        RegisterInfo& reg = afterCall.regs[i];
+
+        if (function.cfg.captured.test(i))
+            reg = RegisterInfo{};
+
+        reg.knownNotReadonly = false;
+        reg.knownNoMetatable = false;
+    }
+
+    mergeEntryState(function, getSuccessorEntry(flow, block), afterCall);
+}
+
+static void constPropInBlock(IrBuilder& build, IrBlock& block, ConstPropState& state, ConstPropFlow* flow)
 {
     IrFunction& function = build.function;
 
@@ -507,23 +906,37 @@ static void constPropInBlock(IrBuilder& build, IrBlock& block, ConstPropState& s
 
         foldConstants(build, function, block, index);
 
+        // Interrupt handler continuation is only reached after user code has been called
+        if (flow && inst.cmd == IrCmd::INTERRUPT && inst.b.kind == IrOpKind::Block)
+        {
+            mergeUserCallIntoSuccessor(*flow, function, inst.b, state);
+
+            constPropInInst(state, build, function, block, inst, index);
+            continue;
+        }
+
+        // Guards jump to their target before they update the state and other instructions jump after it, so both states are recorded
+        if (flow)
+            mergeIntoSuccessors(*flow, function, inst, state);
+
         constPropInInst(state, build, function, block, inst, index);
+
+        if (flow)
+            mergeIntoSuccessors(*flow, function, inst, state);
     }
 }
 
-static void constPropInBlockChain(IrBuilder& build, std::vector<uint8_t>& visited, IrBlock* block)
+static void constPropInBlockChain(IrBuilder& build, std::vector<uint8_t>& visited, IrBlock* block, ConstPropState& state, ConstPropFlow* flow)
 {
     IrFunction& function = build.function;
 
-    ConstPropState state;
-
     while (block)
     {
         uint32_t blockIdx = function.getBlockIndex(*block);
         LUAU_ASSERT(!visited[blockIdx]);
         visited[blockIdx] = true;
 
-        constPropInBlock(build, *block, state);
+        constPropInBlock(build, *block, state, flow);
 
         IrInst& termInst = function.instructions[block->finish];
 
@@ -547,6 +960,8 @@ void constPropInBlockChains(IrBuilder& build)
 {
     IrFunction& function = build.function;
 
+    computeCfgInfo(function);
+
     std::vector<uint8_t> visited(function.blocks.size(), false);
 
     for (IrBlock& block : function.blocks)
@@ -557,7 +972,139 @@ void constPropInBlockChains(IrBuilder& build)
         if (visited[function.getBlockIndex(block)])
             continue;
 
-        constPropInBlockChain(build, visited, &block);
+        ConstPropState state;
+        constPropInBlockChain(build, visited, &block, state, nullptr);
+    }
+}
+
+// Optimizes all blocks with the knowledge from their predecessors, returns false if the assumptions made about loop back edges didn't hold
+// When 'pessimistic' is set, nothing is known at the start of blocks with loop back edges
+static bool constPropInFunctionPass(
+    IrBuilder& build, ConstPropFlow& flow, const std::vector<uint32_t>& order, const std::vector<uint8_t>& hasBackEdge, bool pessimistic)
+{
+    IrFunction& function = build.function;
+
+    flow.processed.assign(function.blocks.size(), false);
+    flow.entries.assign(function.blocks.size(), BlockEntryState{});
+    flow.backEdges.assign(function.blocks.size(), BlockEntryState{});
+    flow.used.assign(function.blocks.size(), BlockEntryState{});
+
+    for (uint32_t blockIdx : order)
+    {
+        IrBlock& block = function.blocks[blockIdx];
+
+        // Block might have been processed as a part of a chain or it might have lost all its users
+        if (flow.processed[blockIdx] || block.kind == IrBlockKind::Dead)
+            continue;
+
+        ConstPropState state;
+
+        if (const BlockEntryState& entry = flow.entries[blockIdx]; entry.reached)
+        {
+            if (hasBackEdge[blockIdx])
+            {
+                if (!pessimistic)
+                {
+                    // Loop back edges haven't been processed yet, so we start with what they are assumed to preserve
+                    BlockEntryState& used = flow.used[blockIdx];
+
+                    used = entry;
+
+                    if (flow.assumptions[blockIdx].reached)
+                        mergeEntryState(function, used, flow.assumptions[blockIdx]);
+
+                    loadEntryState(state, used);
+                }
+            }
+            else
+            {
+                loadEntryState(state, entry);
+            }
+        }
+
+        constPropInBlockChain(build, flow.processed, &block, state, &flow);
+    }
+
+    if (pessimistic)
+        return true;
+
+    bool consistent = true;
+
+    for (uint32_t blockIdx : order)
+    {
+        const BlockEntryState& backEdge = flow.backEdges[blockIdx];
+
+        if (!backEdge.reached)
+            continue;
+
+        // Knowledge we started with has to hold on loop back edges as well
+        if (const BlockEntryState& used = flow.used[blockIdx]; used.reached)
+        {
+            BlockEntryState merged = used;
+            mergeEntryState(function, merged, backEdge);
+
+            if (!isSameEntryState(function, merged, used))
+                consistent = false;
+        }
+
+        mergeEntryState(function, flow.assumptions[blockIdx], backEdge);
+    }
+
+    return consistent;
+}
+
+void constPropInFunction(IrBuilder& build)
+{
+    IrFunction& function = build.function;
+
+    computeCfgInfo(function);
+
+    std::vector<uint32_t> order = getReversePostorder(function);
+
+    std::vector<uint32_t> orderIndex(function.blocks.size(), ~0u);
+
+    for (size_t i = 0; i < order.size(); i++)
+        orderIndex[order[i]] = uint32_t(i);
+
+    // Block has a loop back edge if one of its predecessors doesn't come before it in reverse postorder
+    std::vector<uint8_t> hasBackEdge(function.blocks.size(), false);
+    bool hasLoops = false;
+
+    for (uint32_t blockIdx : order)
+    {
+        for (uint32_t predIdx : predecessors(function.cfg, blockIdx))
+        {
+            if (orderIndex[predIdx] != ~0u && orderIndex[predIdx] >= orderIndex[blockIdx])
+            {
+                hasBackEdge[blockIdx] = true;
+                hasLoops = true;
+            }
+        }
+    }
+
+    ConstPropFlow flow;
+    flow.assumptions.resize(function.blocks.size());
+
+    // Knowledge at loop headers is assumed to be preserved by the loop body until proven otherwise
+    // If the assumptions don't hold, the function is restored and optimized again with narrowed down assumptions
+    for (int pass = 0;; pass++)
+    {
+        bool pessimistic = pass == kMaxConstPropPasses;
+
+        std::vector<IrBlock> savedBlocks;
+        std::vector<IrInst> savedInstructions;
+
+        if (hasLoops && !pessimistic)
+        {
+            savedBlocks = function.blocks;
+            savedInstructions = function.instructions;
+        }
+
+        if (constPropInFunctionPass(build, flow, order, hasBackEdge, pessimistic))
+            break;
+
+        function.blocks = std::move(savedBlocks);
+        function.instructions = std::move(savedInstructions);
     }
 }
 
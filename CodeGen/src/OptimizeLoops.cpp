@@ -0,0 +1,637 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/OptimizeLoops.h"
+
+#include "Luau/IrAnalysis.h"
+#include "Luau/IrBuilder.h"
+#include "Luau/IrUtils.h"
+
+#include "lobject.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+constexpr uint32_t kNoBytecodeLocation = ~0u;
+
+struct LoopGuards
+{
+    bool safeEnv = false;
+
+    // Register and the tag it has
+    std::vector<std::pair<uint8_t, uint8_t>> tags;
+
+    // Register holding a table and CHECK_NO_METATABLE or CHECK_READONLY, these are checked after the register tag
+    std::vector<std::pair<uint8_t, IrCmd>> tables;
+
+    bool empty() const
+    {
+        return !safeEnv && tags.empty() && tables.empty();
+    }
+
+    // Checks of the state that can be changed by user code
+    bool hasHeapChecks() const
+    {
+        return safeEnv || !tables.empty();
+    }
+
+    void merge(const LoopGuards& other)
+    {
+        safeEnv = safeEnv || other.safeEnv;
+
+        for (auto tag : other.tags)
+        {
+            if (std::find(tags.begin(), tags.end(), tag) == tags.end())
+                tags.push_back(tag);
+        }
+
+        for (auto table : other.tables)
+        {
+            if (std::find(tables.begin(), tables.end(), table) == tables.end())
+                tables.push_back(table);
+        }
+
+        std::sort(tables.begin(), tables.end());
+    }
+};
+
+struct NaturalLoop
+{
+    uint32_t header = ~0u;
+    uint32_t headerPc = kNoBytecodeLocation;
+
+    std::vector<uint32_t> latches;
+    std::vector<uint32_t> body;
+    std::vector<uint8_t> inBody;
+};
+
+// Instruction after which the hoisted guards have to be checked again
+struct RecheckPoint
+{
+    uint32_t instIdx = ~0u;
+
+    LoopGuards guards;
+};
+
+static bool dominates(const std::vector<uint32_t>& idoms, uint32_t dominator, uint32_t blockIdx)
+{
+    while (blockIdx != ~0u)
+    {
+        if (blockIdx == dominator)
+            return true;
+
+        blockIdx = idoms[blockIdx];
+    }
+
+    return false;
+}
+
+static void markWritten(std::bitset<256>& written, IrOp op, int count = 1)
+{
+    if (op.kind != IrOpKind::VmReg)
+        return;
+
+    for (int i = int(op.index); i < int(op.index) + count && i < 256; i++)
+        written.set(i);
+}
+
+// Returns false if the instruction can write to any register of the current frame
+static bool markWrittenRegisters(IrFunction& function, const IrInst& inst, std::bitset<256>& written)
+{
+    switch (inst.cmd)
+    {
+    case IrCmd::STORE_TAG:
+    case IrCmd::STORE_POINTER:
+    case IrCmd::STORE_DOUBLE:
+    case IrCmd::STORE_INT:
+    case IrCmd::STORE_VECTOR:
+    case IrCmd::STORE_TVALUE:
+    case IrCmd::DO_ARITH:
+    case IrCmd::DO_LEN:
+    case IrCmd::GET_TABLE:
+    case IrCmd::GET_IMPORT:
+    case IrCmd::GET_UPVALUE:
+        markWritten(written, inst.a);
+        break;
+    case IrCmd::CONCAT:
+        markWritten(written, inst.a, int(function.uintOp(inst.b)));
+        break;
+    case IrCmd::PREPARE_FORN:
+        markWritten(written, inst.a);
+        markWritten(written, inst.b);
+        markWritten(written, inst.c);
+        break;
+    case IrCmd::LOP_AND:
+    case IrCmd::LOP_ANDK:
+    case IrCmd::LOP_OR:
+    case IrCmd::LOP_ORK:
+    case IrCmd::FALLBACK_GETGLOBAL:
+    case IrCmd::FALLBACK_GETTABLEKS:
+    case IrCmd::FALLBACK_NEWCLOSURE:
+    case IrCmd::GET_FIELD_CACHED:
+    case IrCmd::FALLBACK_DUPCLOSURE:
+        markWritten(written, inst.b);
+        break;
+    case IrCmd::FALLBACK_NAMECALL:
+    case IrCmd::GET_METHOD_CACHED:
+        markWritten(written, inst.b, 2);
+        break;
+    case IrCmd::FALLBACK_FORGPREP:
+        markWritten(written, inst.b, 3);
+        break;
+    case IrCmd::LOP_FASTCALL:
+    case IrCmd::LOP_FASTCALL1:
+    case IrCmd::LOP_FASTCALL2:
+    case IrCmd::LOP_FASTCALL2K:
+        // Builtins can return multiple values
+        markWritten(written, inst.b, 256);
+        break;
+    case IrCmd::LOP_NAMECALL:
+    case IrCmd::LOP_CALL:
+    case IrCmd::LOP_FORGLOOP:
+    case IrCmd::LOP_FORGLOOP_FALLBACK:
+    case IrCmd::LOP_FORGPREP_XNEXT_FALLBACK:
+    case IrCmd::FALLBACK_PREPVARARGS:
+    case IrCmd::FALLBACK_GETVARARGS:
+        return false;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+// Instructions that might call user code, which can change table metatables and the environment, but not the registers of the frame
+static bool mayCallUserCode(IrCmd cmd)
+{
+    switch (cmd)
+    {
+    case IrCmd::DO_ARITH:
+    case IrCmd::DO_LEN:
+    case IrCmd::GET_TABLE:
+    case IrCmd::SET_TABLE:
+    case IrCmd::GET_IMPORT:
+    case IrCmd::CONCAT:
+    case IrCmd::JUMP_CMP_ANY:
+    case IrCmd::FALLBACK_GETGLOBAL:
+    case IrCmd::FALLBACK_SETGLOBAL:
+    case IrCmd::FALLBACK_GETTABLEKS:
+    case IrCmd::FALLBACK_SETTABLEKS:
+    case IrCmd::FALLBACK_NAMECALL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isFastcall(IrCmd cmd)
+{
+    return cmd == IrCmd::LOP_FASTCALL || cmd == IrCmd::LOP_FASTCALL1 || cmd == IrCmd::LOP_FASTCALL2 || cmd == IrCmd::LOP_FASTCALL2K;
+}
+
+static uint8_t getGuardedRegister(IrFunction& function, IrOp op, IrCmd load)
+{
+    if (op.kind != IrOpKind::Inst)
+        return 0xff;
+
+    const IrInst& source = function.instOp(op);
+
+    if (source.cmd != load || source.a.kind != IrOpKind::VmReg)
+        return 0xff;
+
+    return uint8_t(source.a.index);
+}
+
+// Finds bytecode instructions where the interpreter can continue execution instead of each block
+static std::vector<uint32_t> getBlockBytecodeLocations(IrFunction& function)
+{
+    std::vector<uint32_t> blockAtLocation(function.instructions.size(), ~0u);
+
+    for (size_t i = 0; i < function.blocks.size(); i++)
+    {
+        const IrBlock& block = function.blocks[i];
+
+        if (block.kind != IrBlockKind::Dead && block.start < blockAtLocation.size())
+            blockAtLocation[block.start] = uint32_t(i);
+    }
+
+    std::vector<uint32_t> locations(function.blocks.size(), kNoBytecodeLocation);
+
+    // Instructions that were skipped after a block terminator are mapped to the start of the next block, the last one is the live one
+    for (size_t i = 0; i < function.bcMapping.size(); i++)
+    {
+        uint32_t irLocation = function.bcMapping[i].irLocation;
+
+        if (irLocation < blockAtLocation.size() && blockAtLocation[irLocation] != ~0u)
+            locations[blockAtLocation[irLocation]] = uint32_t(i);
+    }
+
+    return locations;
+}
+
+static std::vector<NaturalLoop> findNaturalLoops(
+    IrFunction& function, const std::vector<uint32_t>& order, const std::vector<uint32_t>& idoms, const std::vector<uint32_t>& blockPcs)
+{
+    const CfgInfo& cfg = function.cfg;
+
+    std::vector<uint8_t> reachable(function.blocks.size(), false);
+
+    for (uint32_t blockIdx : order)
+        reachable[blockIdx] = true;
+
+    std::vector<NaturalLoop> loops;
+
+    for (uint32_t header : order)
+    {
+        NaturalLoop loop;
+        loop.header = header;
+        loop.headerPc = blockPcs[header];
+
+        // Guards can only be hoisted if the interpreter is able to continue from the start of the loop
+        if (loop.headerPc == kNoBytecodeLocation)
+            continue;
+
+        // Loop back edges come from blocks that are dominated by the loop header
+        for (uint32_t predIdx : predecessors(cfg, header))
+        {
+            if (reachable[predIdx] && dominates(idoms, header, predIdx))
+                loop.latches.push_back(predIdx);
+        }
+
+        if (loop.latches.empty())
+            continue;
+
+        loop.inBody.resize(function.blocks.size(), false);
+        loop.inBody[header] = true;
+        loop.body.push_back(header);
+
+        std::vector<uint32_t> queue = loop.latches;
+
+        while (!queue.empty())
+        {
+            uint32_t blockIdx = queue.back();
+            queue.pop_back();
+
+            if (loop.inBody[blockIdx])
+                continue;
+
+            loop.inBody[blockIdx] = true;
+            loop.body.push_back(blockIdx);
+
+            for (uint32_t predIdx : predecessors(cfg, blockIdx))
+            {
+                if (reachable[predIdx] && !loop.inBody[predIdx])
+                    queue.push_back(predIdx);
+            }
+        }
+
+        std::sort(loop.body.begin(), loop.body.end(), [&](uint32_t a, uint32_t b) {
+            return function.blocks[a].start < function.blocks[b].start;
+        });
+
+        loops.push_back(std::move(loop));
+    }
+
+    return loops;
+}
+
+static LoopGuards findInvariantGuards(IrFunction& function, const NaturalLoop& loop, const std::vector<uint32_t>& idoms)
+{
+    // Registers captured by reference can be changed by any user code
+    std::bitset<256> written = function.cfg.captured;
+    bool hasFastcall = false;
+
+    for (uint32_t blockIdx : loop.body)
+    {
+        const IrBlock& block = function.blocks[blockIdx];
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            const IrInst& inst = function.instructions[index];
+
+            if (!markWrittenRegisters(function, inst, written))
+                return {};
+
+            hasFastcall |= isFastcall(inst.cmd);
+        }
+    }
+
+    LoopGuards guards;
+    std::bitset<256> conflicting;
+
+    std::vector<std::pair<uint8_t, IrCmd>> tables;
+
+    for (uint32_t blockIdx : loop.body)
+    {
+        const IrBlock& block = function.blocks[blockIdx];
+
+        if (block.kind == IrBlockKind::Fallback)
+            continue;
+
+        // Guards that might not be executed on every iteration are left where they are
+        bool executedOnEveryIteration = std::all_of(loop.latches.begin(), loop.latches.end(), [&](uint32_t latch) {
+            return dominates(idoms, blockIdx, latch);
+        });
+
+        if (!executedOnEveryIteration)
+            continue;
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            const IrInst& inst = function.instructions[index];
+
+            switch (inst.cmd)
+            {
+            case IrCmd::CHECK_SAFE_ENV:
+                guards.safeEnv = true;
+                break;
+            case IrCmd::CHECK_TAG:
+            {
+                uint8_t reg = getGuardedRegister(function, inst.a, IrCmd::LOAD_TAG);
+
+                if (reg == 0xff || written.test(reg) || conflicting.test(reg))
+                    break;
+
+                uint8_t tag = function.tagOp(inst.b);
+                auto it = std::find_if(guards.tags.begin(), guards.tags.end(), [&](auto& item) {
+                    return item.first == reg;
+                });
+
+                if (it == guards.tags.end())
+                {
+                    guards.tags.push_back({reg, tag});
+                }
+                else if (it->second != tag)
+                {
+                    conflicting.set(reg);
+                    guards.tags.erase(it);
+                }
+                break;
+            }
+            case IrCmd::CHECK_NO_METATABLE:
+            case IrCmd::CHECK_READONLY:
+            {
+                uint8_t reg = getGuardedRegister(function, inst.a, IrCmd::LOAD_POINTER);
+
+                if (reg != 0xff && !written.test(reg) && std::find(tables.begin(), tables.end(), std::make_pair(reg, inst.cmd)) == tables.end())
+                    tables.push_back({reg, inst.cmd});
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    // Builtins are not classified yet and any of them might change table properties
+    if (hasFastcall)
+        return guards;
+
+    // Table pointer is only loaded if the register is known to hold a table
+    for (auto table : tables)
+    {
+        if (std::find(guards.tags.begin(), guards.tags.end(), std::make_pair(table.first, uint8_t(LUA_TTABLE))) != guards.tags.end())
+            guards.tables.push_back(table);
+    }
+
+    std::sort(guards.tables.begin(), guards.tables.end());
+
+    return guards;
+}
+
+static void addRecheckPoint(std::vector<RecheckPoint>& points, uint32_t instIdx, const LoopGuards& guards)
+{
+    for (RecheckPoint& point : points)
+    {
+        if (point.instIdx == instIdx)
+        {
+            point.guards.merge(guards);
+            return;
+        }
+    }
+
+    points.push_back({instIdx, guards});
+}
+
+static void buildGuards(IrBuilder& build, const LoopGuards& guards, IrOp fallback)
+{
+    if (guards.safeEnv)
+        build.inst(IrCmd::CHECK_SAFE_ENV, fallback);
+
+    for (auto [reg, tag] : guards.tags)
+    {
+        IrOp tv = build.inst(IrCmd::LOAD_TAG, build.vmReg(reg));
+        build.inst(IrCmd::CHECK_TAG, tv, build.constTag(tag), fallback);
+    }
+
+    IrOp table;
+
+    for (size_t i = 0; i < guards.tables.size(); i++)
+    {
+        auto [reg, cmd] = guards.tables[i];
+
+        if (i == 0 || guards.tables[i - 1].first != reg)
+            table = build.inst(IrCmd::LOAD_POINTER, build.vmReg(reg));
+
+        build.inst(cmd, table, fallback);
+    }
+}
+
+static IrOp buildExitToVm(IrBuilder& build, uint32_t pcpos)
+{
+    IrOp exit = build.block(IrBlockKind::Fallback);
+
+    build.beginBlock(exit);
+    build.inst(IrCmd::EXIT_TO_VM, build.constUint(pcpos));
+
+    return exit;
+}
+
+void hoistLoopInvariantGuards(IrBuilder& build)
+{
+    IrFunction& function = build.function;
+
+    computeCfgInfo(function);
+
+    std::vector<uint32_t> order = getReversePostorder(function);
+    std::vector<uint32_t> idoms = getImmediateDominators(function, order);
+    std::vector<uint32_t> blockPcs = getBlockBytecodeLocations(function);
+
+    std::vector<NaturalLoop> loops = findNaturalLoops(function, order, idoms, blockPcs);
+
+    if (loops.empty())
+        return;
+
+    std::vector<uint8_t> headerPcs(function.bcMapping.size(), false);
+
+    for (const NaturalLoop& loop : loops)
+        headerPcs[loop.headerPc] = true;
+
+    // Guards that have to be checked again after interrupt handler calls and on the exits from fallback blocks that call user code
+    std::vector<RecheckPoint> interrupts;
+    std::vector<RecheckPoint> userCalls;
+
+    size_t blockCount = function.blocks.size();
+
+    for (const NaturalLoop& loop : loops)
+    {
+        LoopGuards guards = findInvariantGuards(function, loop, idoms);
+
+        if (guards.empty())
+            continue;
+
+        // Interrupt handler gets a separate continuation, so the interrupt has to be followed by a jump
+        // Native code re-entry at the interrupt after a yield is redirected, so it can't share the location with the loop start
+        std::vector<uint32_t> loopInterrupts;
+        std::vector<uint32_t> loopUserCalls;
+        bool canRecheckInterrupts = true;
+        bool canRecheckUserCalls = true;
+
+        for (uint32_t blockIdx : loop.body)
+        {
+            const IrBlock& block = function.blocks[blockIdx];
+
+            for (uint32_t index = block.start; index <= block.finish; index++)
+            {
+                const IrInst& inst = function.instructions[index];
+
+                if (inst.cmd == IrCmd::INTERRUPT)
+                {
+                    uint32_t pcpos = function.uintOp(inst.a);
+
+                    if (index + 1 == block.finish && function.instructions[index + 1].cmd == IrCmd::JUMP && !headerPcs[pcpos] &&
+                        function.bcMapping[pcpos].irLocation == index)
+                        loopInterrupts.push_back(index);
+                    else
+                        canRecheckInterrupts = false;
+                }
+                else if (mayCallUserCode(inst.cmd))
+                {
+                    // Checks are placed on exits from the block, interpreter has to be able to continue from each of them
+                    const IrInst& term = function.instructions[block.finish];
+
+                    for (IrOp op : {term.a, term.b, term.c, term.d, term.e, term.f})
+                    {
+                        if (op.kind == IrOpKind::Block && blockPcs[op.index] == kNoBytecodeLocation)
+                            canRecheckUserCalls = false;
+                    }
+
+                    if (block.kind == IrBlockKind::Fallback)
+                        loopUserCalls.push_back(block.finish);
+                    else
+                        canRecheckUserCalls = false;
+                }
+            }
+        }
+
+        if (!canRecheckInterrupts)
+            continue;
+
+        if (!canRecheckUserCalls)
+        {
+            guards.safeEnv = false;
+            guards.tables.clear();
+
+            if (guards.empty())
+                continue;
+        }
+
+        for (uint32_t index : loopInterrupts)
+            addRecheckPoint(interrupts, index, guards);
+
+        if (guards.hasHeapChecks())
+        {
+            LoopGuards heapGuards = guards;
+            heapGuards.tags.clear();
+
+            for (uint32_t index : loopUserCalls)
+                addRecheckPoint(userCalls, index, heapGuards);
+        }
+
+        IrOp preheader = build.block(IrBlockKind::Internal);
+        IrOp exit = buildExitToVm(build, loop.headerPc);
+
+        build.beginBlock(preheader);
+        buildGuards(build, guards, exit);
+        build.inst(IrCmd::JUMP, IrOp{IrOpKind::Block, loop.header});
+
+        // Loop is entered through the preheader from outside and from the interpreter
+        for (uint32_t predIdx : predecessors(function.cfg, loop.header))
+        {
+            if (predIdx >= blockCount || loop.inBody[predIdx])
+                continue;
+
+            IrBlock& pred = function.blocks[predIdx];
+
+            for (uint32_t index = pred.start; index <= pred.finish; index++)
+            {
+                IrInst& inst = function.instructions[index];
+
+                for (IrOp* op : {&inst.a, &inst.b, &inst.c, &inst.d, &inst.e, &inst.f})
+                {
+                    if (op->kind == IrOpKind::Block && op->index == loop.header)
+                        *op = preheader;
+                }
+            }
+        }
+
+        function.bcMapping[loop.headerPc].irLocation = function.blockOp(preheader).start;
+
+        blockPcs.resize(function.blocks.size(), kNoBytecodeLocation);
+        blockPcs[preheader.index] = loop.headerPc;
+    }
+
+    // User code could have changed the state that the loop relies on, execution continues in the VM if it did
+    for (const RecheckPoint& point : userCalls)
+    {
+        IrInst& term = function.instructions[point.instIdx];
+
+        for (IrOp* op : {&term.a, &term.b, &term.c, &term.d, &term.e, &term.f})
+        {
+            if (op->kind != IrOpKind::Block)
+                continue;
+
+            IrOp target = *op;
+            IrOp recheck = build.block(IrBlockKind::Fallback);
+            IrOp exit = buildExitToVm(build, blockPcs[target.index]);
+
+            build.beginBlock(recheck);
+            buildGuards(build, point.guards, exit);
+            build.inst(IrCmd::JUMP, target);
+
+            *op = recheck;
+        }
+    }
+
+    // Interrupt handler can change the state as well, it's checked when the handler has been called
+    // Interpreter will call the interrupt handler again if it has to continue from the interrupt instruction
+    for (const RecheckPoint& point : interrupts)
+    {
+        uint32_t pcpos = function.uintOp(function.instructions[point.instIdx].a);
+        IrOp next = function.instructions[point.instIdx + 1].a;
+
+        IrOp recheck = build.block(IrBlockKind::Fallback);
+        IrOp reentry = build.block(IrBlockKind::Fallback);
+        IrOp exit = buildExitToVm(build, pcpos);
+
+        build.beginBlock(recheck);
+        buildGuards(build, point.guards, exit);
+        build.inst(IrCmd::JUMP, next);
+
+        // After a yield, native code is re-entered without any knowledge of the state
+        build.beginBlock(reentry);
+        build.inst(IrCmd::INTERRUPT, build.constUint(pcpos), recheck);
+        build.inst(IrCmd::JUMP, recheck);
+
+        function.instructions[point.instIdx].b = recheck;
+        function.bcMapping[pcpos].irLocation = function.blockOp(reentry).start;
+    }
+
+    updateUseCounts(function);
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -184,7 +184,12 @@ void UnwindBuilderDwarf2::save(RegisterX64 reg)
 void UnwindBuilderDwarf2::allocStack(int size)
 {
     stackOffset += size;
-    pos = advanceLocation(pos, 4); // REX.W sub rsp, imm8
+
+    if (size < 128)
+        pos = advanceLocation(pos, 4); // REX.W sub rsp, imm8
+    else
+        pos = advanceLocation(pos, 7); // REX.W sub rsp, imm32
+
     pos = defineCfaExpressionOffset(pos, stackOffset);
 }
 
@@ -63,11 +63,27 @@ void UnwindBuilderWin::save(RegisterX64 reg)
 
 void UnwindBuilderWin::allocStack(int size)
 {
-    LUAU_ASSERT(size >= 8 && size <= 128 && size % 8 == 0);
+    LUAU_ASSERT(size >= 8 && size < 512 * 1024 && size % 8 == 0);
+
+    if (size < 128)
+        prologSize += 4; // REX.W sub rsp, imm8
+    else
+        prologSize += 7; // REX.W sub rsp, imm32
 
-    prologSize += 4; // REX.W sub rsp, imm8
     stackOffset += size;
-    unwindCodes.push_back({prologSize, UWOP_ALLOC_SMALL, uint8_t((size - 8) / 8)});
+
+    if (size <= 128)
+    {
+        unwindCodes.push_back({prologSize, UWOP_ALLOC_SMALL, uint8_t((size - 8) / 8)});
+    }
+    else
+    {
+        // Larger allocations store the size scaled by 8 in the next slot; unwind codes are written in reverse, so that slot goes first
+        uint16_t scaledSize = uint16_t(size / 8);
+
+        unwindCodes.push_back({uint8_t(scaledSize & 0xff), uint8_t((scaledSize >> 8) & 0xf), uint8_t(scaledSize >> 12)});
+        unwindCodes.push_back({prologSize, UWOP_ALLOC_LARGE, 0});
+    }
 }
 
 void UnwindBuilderWin::setupFrameReg(RegisterX64 reg, int espOffset)
@@ -119,7 +135,7 @@ void UnwindBuilderWin::finalize(char* target, void* funcAddress, size_t funcSize
     if (!unwindCodes.empty())
     {
         // Copy unwind codes in reverse order
-        // Some unwind codes take up two array slots, but we don't use those atm
+        // Unwind codes that take up two array slots are recorded with their extra slot first, so they end up in the right order
         char* pos = target + sizeof(UnwindCodeWin) * (unwindCodes.size() - 1);
 
         for (size_t i = 0; i < unwindCodes.size(); i++)
@@ -884,6 +884,90 @@ int BytecodeBuilder::decomposeImportId(uint32_t ids, int32_t& id0, int32_t& id1,
     return count;
 }
 
+#if LUA_WIDESTRINGHASH
+static uint64_t hashRotl(uint64_t x, int s)
+{
+    return (x << s) | (x >> (64 - s));
+}
+
+static uint64_t hashRead(const char* str)
+{
+    uint64_t r;
+    memcpy(&r, str, 8);
+    return r;
+}
+
+static uint64_t hashRound(uint64_t acc, uint64_t input)
+{
+    return hashRotl(acc + input * 0xC2B2AE3D27D4EB4Full, 31) * 0x9E3779B185EBCA87ull;
+}
+
+static uint64_t hashMerge(uint64_t acc, uint64_t lane)
+{
+    return (acc ^ hashRound(0, lane)) * 0x9E3779B185EBCA87ull + 0x85EBCA77C2B2AE63ull;
+}
+
+uint32_t BytecodeBuilder::getStringHash(StringRef key)
+{
+    // This hashing algorithm should match luaS_hash defined in VM/lstring.cpp; we can't use that code directly to keep compiler and VM independent in
+    // terms of compilation/linking. Unlike the Lua 5.1 hash, long inputs can't be omitted since every byte contributes to the hash.
+    const char* str = key.data;
+    const char* end = str + key.length;
+    uint64_t h;
+
+    if (key.length >= 32)
+    {
+        uint64_t v1 = 0x9E3779B185EBCA87ull + 0xC2B2AE3D27D4EB4Full;
+        uint64_t v2 = 0xC2B2AE3D27D4EB4Full;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - 0x9E3779B185EBCA87ull;
+
+        do
+        {
+            v1 = hashRound(v1, hashRead(str));
+            v2 = hashRound(v2, hashRead(str + 8));
+            v3 = hashRound(v3, hashRead(str + 16));
+            v4 = hashRound(v4, hashRead(str + 24));
+            str += 32;
+        } while (end - str >= 32);
+
+        h = hashRotl(v1, 1) + hashRotl(v2, 7) + hashRotl(v3, 12) + hashRotl(v4, 18);
+        h = hashMerge(h, v1);
+        h = hashMerge(h, v2);
+        h = hashMerge(h, v3);
+        h = hashMerge(h, v4);
+    }
+    else
+    {
+        h = 0x27D4EB2F165667C5ull;
+    }
+
+    h += key.length;
+
+    for (; end - str >= 8; str += 8)
+        h = hashRotl(h ^ hashRound(0, hashRead(str)), 27) * 0x9E3779B185EBCA87ull + 0x85EBCA77C2B2AE63ull;
+
+    if (end - str >= 4)
+    {
+        uint32_t block;
+        memcpy(&block, str, 4);
+
+        h = hashRotl(h ^ (block * 0x9E3779B185EBCA87ull), 23) * 0xC2B2AE3D27D4EB4Full + 0x165667B19E3779F9ull;
+        str += 4;
+    }
+
+    for (; str < end; ++str)
+        h = hashRotl(h ^ ((uint8_t)*str * 0x27D4EB2F165667C5ull), 11) * 0x9E3779B185EBCA87ull;
+
+    h ^= h >> 33;
+    h *= 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    h *= 0x165667B19E3779F9ull;
+    h ^= h >> 32;
+
+    return uint32_t(h);
+}
+#else
 uint32_t BytecodeBuilder::getStringHash(StringRef key)
 {
     // This hashing algorithm should match luaS_hash defined in VM/lstring.cpp for short inputs; we can't use that code directly to keep compiler and
@@ -901,6 +985,7 @@ uint32_t BytecodeBuilder::getStringHash(StringRef key)
 
     return h;
 }
+#endif
 
 void BytecodeBuilder::foldJumps()
 {
@@ -72,6 +72,7 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/include/Luau/OperandX64.h
     CodeGen/include/Luau/OptimizeConstProp.h
     CodeGen/include/Luau/OptimizeFinalX64.h
+    CodeGen/include/Luau/OptimizeLoops.h
     CodeGen/include/Luau/RegisterA64.h
     CodeGen/include/Luau/RegisterX64.h
     CodeGen/include/Luau/UnwindBuilder.h
@@ -97,9 +98,11 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/src/IrTranslateBuiltins.cpp
     CodeGen/src/IrTranslation.cpp
     CodeGen/src/IrUtils.cpp
+    CodeGen/src/NativeCache.cpp
     CodeGen/src/NativeState.cpp
     CodeGen/src/OptimizeConstProp.cpp
     CodeGen/src/OptimizeFinalX64.cpp
+    CodeGen/src/OptimizeLoops.cpp
     CodeGen/src/UnwindBuilderDwarf2.cpp
     CodeGen/src/UnwindBuilderWin.cpp
 
@@ -108,6 +111,7 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/src/CodeGenUtils.h
     CodeGen/src/CodeGenX64.h
     CodeGen/src/EmitBuiltinsX64.h
+    CodeGen/src/EmitCommon.h
     CodeGen/src/EmitCommonX64.h
     CodeGen/src/EmitInstructionX64.h
     CodeGen/src/Fallbacks.h
@@ -116,6 +120,7 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/src/IrRegAllocX64.h
     CodeGen/src/IrTranslateBuiltins.h
     CodeGen/src/IrTranslation.h
+    CodeGen/src/NativeCache.h
     CodeGen/src/NativeState.h
 )
 
@@ -294,6 +299,8 @@ if(TARGET Luau.Repl.CLI)
         CLI/FileUtils.cpp
         CLI/Flags.h
         CLI/Flags.cpp
+        CLI/HeapSnapshot.h
+        CLI/HeapSnapshot.cpp
         CLI/Profiler.h
         CLI/Profiler.cpp
         CLI/Repl.cpp
@@ -403,6 +410,14 @@ if(TARGET Luau.Conformance)
         tests/main.cpp)
 endif()
 
+if(TARGET Luau.HeapDiff.CLI)
+    # Luau.HeapDiff.CLI Sources
+    target_sources(Luau.HeapDiff.CLI PRIVATE
+        CLI/HeapDiff.cpp
+        CLI/HeapSnapshot.h
+        CLI/HeapSnapshot.cpp)
+endif()
+
 if(TARGET Luau.CLI.Test)
     # Luau.CLI.Test Sources
     target_sources(Luau.CLI.Test PRIVATE
@@ -412,10 +427,13 @@ if(TARGET Luau.CLI.Test)
         CLI/FileUtils.cpp
         CLI/Flags.h
         CLI/Flags.cpp
+        CLI/HeapSnapshot.h
+        CLI/HeapSnapshot.cpp
         CLI/Profiler.h
         CLI/Profiler.cpp
         CLI/Repl.cpp
 
+        tests/HeapSnapshot.test.cpp
         tests/Repl.test.cpp
         tests/main.cpp)
 endif()
@@ -285,6 +285,51 @@ enum lua_GCOp
     LUA_GCSETGOAL,
     LUA_GCSETSTEPMUL,
     LUA_GCSETSTEPSIZE,
+
+    /*
+    ** pace the collector by time instead of S and step size; both return the previous value
+    **
+    ** LUA_GCSETSTEPTIME sets the target duration of one GC step in microseconds (0 returns to the default pacing)
+    ** LUA_GCSETCPUFRACTION sets the percentage of time the collector should take (1..100, default 25%)
+    **
+    ** the amount of work per step is derived from the measured duration of previous steps, and the next step is scheduled after
+    ** the mutator has allocated as much memory as it's expected to allocate while running for its share of the time, but no later
+    ** than when the heap reaches the goal G. until the first cycle sets the goal, and once the heap is past it, steps do at least
+    ** as much work and are scheduled at least as often as S and step size would require.
+    */
+    LUA_GCSETSTEPTIME,
+    LUA_GCSETCPUFRACTION,
+
+    /*
+    ** switch between generational and incremental collection; both return the previous mode (LUA_GCGEN or LUA_GCINC)
+    **
+    ** in generational mode, objects that survive a collection are not traversed or swept again until the heap outgrows the goal G
+    ** relative to the heap size after the last major collection; minor collections only trace objects allocated since the last cycle,
+    ** which makes them cheaper when the program mostly creates short-lived objects.
+    ** data for LUA_GCGEN specifies the heap growth in percentages that triggers a minor collection (default 20%; 0 keeps the current value)
+    */
+    LUA_GCGEN,
+    LUA_GCINC,
+
+    /*
+    ** page cache control: pages that become empty are kept (up to a limit) to be reused for new allocations
+    ** LUA_GCSETPAGECACHE sets the maximum number of cached pages and returns the previous limit (0 disables the cache)
+    ** LUA_GCTRIMPAGECACHE releases cached pages until at most 'data' pages remain and returns the number of released pages
+    ** LUA_GCPAGECACHEHITS/LUA_GCPAGECACHEMISSES return the number of page allocations that were/weren't served from the cache
+    */
+    LUA_GCSETPAGECACHE,
+    LUA_GCTRIMPAGECACHE,
+    LUA_GCPAGECACHEHITS,
+    LUA_GCPAGECACHEMISSES,
+
+    /*
+    ** defer sweeping to explicit GC steps (data = 1 to enable, 0 to disable); returns the previous setting
+    **
+    ** sweeping doesn't need to trace the heap and can be scheduled at convenient points, such as between frames, using LUA_GCSTEP
+    ** while it's deferred, GC assists don't sweep, so allocations don't pay for it unless the heap grows by more than 25% compared
+    ** to its size when the mark has finished, in which case the assists take over to keep the heap bounded
+    */
+    LUA_GCDEFERSWEEP,
 };
 
 LUA_API int lua_gc(lua_State* L, int what, int data);
@@ -297,6 +342,14 @@ LUA_API int lua_gc(lua_State* L, int what, int data);
 LUA_API void lua_setmemcat(lua_State* L, int category);
 LUA_API size_t lua_totalbytes(lua_State* L, int category);
 
+/*
+** allocation sampling: once 'interval' bytes were allocated since the previous sample, the next new object or block is reported to
+** lua_Callbacks::allocsample, with 'weight' set to the number of bytes allocated since the previous sample; when a reported block
+** is freed, lua_Callbacks::freesample is called. interval of 0 disables sampling and forgets all blocks that were sampled
+** blocks that are resized in place (such as thread stacks) count towards the interval but aren't sampled themselves
+*/
+LUA_API void lua_setallocsampling(lua_State* L, size_t interval);
+
 /*
 ** miscellaneous functions
 */
@@ -393,6 +446,21 @@ typedef void (*lua_Coverage)(void* context, const char* function, int linedefine
 
 LUA_API void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage callback);
 
+/*
+** heap enumeration: reports every live object and the references between them
+**
+** node is called once per object with its address, type (LUA_T*), memory category, size in bytes and an optional name (function name
+** or the source of the thread's first function); names are only valid during the callback.
+** edge calls for the references of an object immediately follow its node call; name describes the reference (string key of a table
+** field, "metatable", "upvalue", etc.) and may be NULL. weak references aren't reported.
+** the main thread is reported first; registry and metatables of basic types are reported as its references.
+** objects that aren't referenced by anything (such as fixed strings) are reported as well.
+*/
+typedef void (*lua_HeapNode)(void* context, void* ptr, int tt, int memcat, size_t size, const char* name);
+typedef void (*lua_HeapEdge)(void* context, void* from, void* to, const char* name);
+
+LUA_API void lua_enumheap(lua_State* L, void* context, lua_HeapNode node, lua_HeapEdge edge);
+
 // Warning: this function is not thread-safe since it stores the result in a shared global array! Only use for debugging.
 LUA_API const char* lua_debugtrace(lua_State* L);
 
@@ -433,6 +501,10 @@ struct lua_Callbacks
     void (*debugstep)(lua_State* L, lua_Debug* ar);      // gets called after each instruction in single step mode
     void (*debuginterrupt)(lua_State* L, lua_Debug* ar); // gets called when thread execution is interrupted by break in another thread
     void (*debugprotectederror)(lua_State* L);           // gets called when protected call results in an error
+
+    // allocation sampling, see lua_setallocsampling; these must not allocate memory or modify the state, except for using lua_getinfo in allocsample
+    void (*allocsample)(lua_State* L, void* block, size_t size, size_t weight, int memcat); // gets called when a sampled block is allocated
+    void (*freesample)(lua_State* L, void* block, size_t size, int memcat);                // gets called when a sampled block is freed
 };
 typedef struct lua_Callbacks lua_Callbacks;
 
@@ -94,6 +94,11 @@
 #define LUA_SIZECLASSES 32
 #endif
 
+// number of unused pages that page allocator keeps for reuse
+#ifndef LUA_PAGECACHE
+#define LUA_PAGECACHE 16
+#endif
+
 // available number of separate memory categories
 #ifndef LUA_MEMORY_CATEGORIES
 #define LUA_MEMORY_CATEGORIES 256
@@ -114,6 +119,12 @@
 #define LUA_CUSTOM_EXECUTION 0
 #endif
 
+// replaces Lua 5.1 string hash with a faster hash that mixes every byte of long strings; compiler needs to be built with the same setting
+// note that this changes the traversal order of string keys in tables, which some scripts rely on
+#ifndef LUA_WIDESTRINGHASH
+#define LUA_WIDESTRINGHASH 0
+#endif
+
 // }==================================================================
 
 /*
@@ -8,10 +8,12 @@
 #include "lfunc.h"
 #include "lgc.h"
 #include "ldo.h"
+#include "lmem.h"
 #include "ludata.h"
 #include "lvm.h"
 #include "lnumutils.h"
 
+#include <limits.h>
 #include <string.h>
 
 /*
@@ -1148,6 +1150,60 @@ int lua_gc(lua_State* L, int what, int data)
         g->gcstepsize = data << 10;
         break;
     }
+    case LUA_GCSETSTEPTIME:
+    {
+        res = g->gcsteptime;
+        g->gcsteptime = data < 0 ? 0 : data;
+        break;
+    }
+    case LUA_GCSETCPUFRACTION:
+    {
+        res = g->gccpufraction;
+        g->gccpufraction = data < 1 ? 1 : (data > 100 ? 100 : data);
+        break;
+    }
+    case LUA_GCGEN:
+    {
+        res = g->gcgenmode ? LUA_GCGEN : LUA_GCINC;
+        if (data != 0)
+            g->gcgenminormul = data;
+        g->gcgenmode = true;
+        break;
+    }
+    case LUA_GCINC:
+    {
+        res = g->gcgenmode ? LUA_GCGEN : LUA_GCINC;
+        g->gcgenmode = false;
+        break;
+    }
+    case LUA_GCDEFERSWEEP:
+    {
+        res = g->gcdefersweep;
+        g->gcdefersweep = data != 0;
+        break;
+    }
+    case LUA_GCSETPAGECACHE:
+    {
+        res = g->pagecachelimit;
+        g->pagecachelimit = data < 0 ? 0 : data;
+        luaM_trimpagecache(L, g->pagecachelimit);
+        break;
+    }
+    case LUA_GCTRIMPAGECACHE:
+    {
+        res = luaM_trimpagecache(L, data < 0 ? 0 : data);
+        break;
+    }
+    case LUA_GCPAGECACHEHITS:
+    {
+        res = g->pagecachehits > INT_MAX ? INT_MAX : int(g->pagecachehits);
+        break;
+    }
+    case LUA_GCPAGECACHEMISSES:
+    {
+        res = g->pagecachemisses > INT_MAX ? INT_MAX : int(g->pagecachemisses);
+        break;
+    }
     default:
         res = -1; // invalid option
     }
@@ -1205,6 +1261,10 @@ int lua_rawiter(lua_State* L, int idx, int iter)
         }
     }
 
+    // nodes must not move while they are visited
+    if (h->migration)
+        luaH_finishmigration(L, h);
+
     int sizenode = 1 << h->lsizenode;
 
     // then we advance iter through the hash portion
@@ -1424,3 +1484,8 @@ size_t lua_totalbytes(lua_State* L, int category)
     api_check(L, category < LUA_MEMORY_CATEGORIES);
     return category < 0 ? L->global->totalbytes : L->global->memcatbytes[category];
 }
+
+void lua_setallocsampling(lua_State* L, size_t interval)
+{
+    luaM_setallocsampling(L, interval);
+}
@@ -518,6 +518,11 @@ void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage ca
     luaM_freearray(L, buffer, size, int, 0);
 }
 
+void lua_enumheap(lua_State* L, void* context, lua_HeapNode node, lua_HeapEdge edge)
+{
+    luaC_enumheap(L, context, node, edge);
+}
+
 static size_t append(char* buf, size_t bufsize, size_t offset, const char* data)
 {
     size_t size = strlen(data);
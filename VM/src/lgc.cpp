@@ -12,9 +12,10 @@
 #include "ludata.h"
 
 #include <string.h>
+#include <limits.h>
 
 /*
- * Luau uses an incremental non-generational non-moving mark&sweep garbage collector.
+ * Luau uses an incremental non-moving mark&sweep garbage collector with an optional generational mode.
  *
  * The collector runs in three stages: mark, atomic and sweep. Mark and sweep are incremental and try to do a limited amount
  * of work every GC step; atomic is ran once per the GC cycle and is indivisible. In either case, the work happens during GC
@@ -86,6 +87,8 @@
  * mark. During sweeping we don't need to maintain the GC invariant, because our goal is to paint all objects with current white -
  * however, some barriers will still trigger (because some reachable objects are still black as sweeping didn't get to them yet), and
  * some barriers will proactively mark black objects as white to avoid extra barriers from triggering excessively.
+ * Since sweeping doesn't need to trace the heap, it can optionally be deferred (LUA_GCDEFERSWEEP): GC assists then skip the sweep and
+ * leave it to explicit steps that the application can schedule outside of latency-sensitive sections, unless the heap grows too much.
  *
  * Most references that GC deals with are strong, and as such they fit neatly into the incremental marking scheme. Some, however, are
  * weak - notably, tables can be marked as having weak keys/values (using __mode metafield). During incremental marking, we don't know
@@ -114,10 +117,30 @@
  * as black (doing so would violate the GC invariant), and they are kept in a special global list (global_State::uvhead) which is traversed
  * during atomic phase. This is needed because an open upvalue might point to a stack location in a dead thread that never marked the stack
  * slot - upvalues like this are identified since they don't have `markedopen` bit set during thread traversal and closed in `clearupvals`.
+ *
+ * In generational mode (selected via lua_gc), most cycles are minor collections that only look at objects allocated since the previous
+ * cycle. This uses "sticky" marks: when a cycle ends in generational mode, the sweep frees dead objects but doesn't turn the surviving
+ * objects white, which promotes them to the old generation. The next cycle then starts with all old objects already black, and the mark
+ * only needs to traverse the young (white) objects reachable from the roots and from the old objects that were modified since they have
+ * been marked. The tri-color invariant is maintained between the cycles as well, so a write of a young object into an old black object
+ * either marks the young object (forward barrier) or turns the old object gray and places it on the `grayagain` list (backward barrier);
+ * the `grayagain` list is not reset at the start of a minor cycle and acts as the remembered set. Because old objects are never visited,
+ * threads with open upvalues and weak tables stay gray and on the `grayagain` list so that they are traversed by every minor cycle.
+ *
+ * Since only young objects can be white, the sweep after a minor collection only visits the pages that had objects allocated in them
+ * (see lmem.cpp). Old objects that become unreachable are not collected by minor collections; when the heap grows past the GC goal
+ * relative to the heap size after the last major collection, the sweep of the minor cycle turns all surviving objects white instead,
+ * and the next cycle is a major collection that marks the entire heap from scratch.
  */
 
 #define GC_SWEEPPAGESTEPCOST 16
 
+// number of string table buckets that are moved by each step while the table is resized
+#define GC_REHASHSTEP 256
+
+// number of nodes of incrementally resized tables that are moved by each step
+#define GC_MIGRATESTEP 256
+
 #define GC_INTERRUPT(state) \
     { \
         void (*interrupt)(lua_State*, int) = g->cb.interrupt; \
@@ -216,6 +239,8 @@ static void finishGcCycleMetrics(global_State* g)
     g->gcmetrics.currcycle.endtotalsizebytes = g->totalbytes;
 
     g->gcmetrics.completedcycles++;
+    if (g->gcmetrics.currcycle.minor)
+        g->gcmetrics.completedminorcycles++;
     g->gcmetrics.lastcycle = g->gcmetrics.currcycle;
     g->gcmetrics.currcycle = GCCycleMetrics();
 
@@ -296,6 +321,26 @@ static const char* gettablemode(global_State* g, Table* h)
     return NULL;
 }
 
+static void traversenodes(global_State* g, LuaNode* node, int first, int size, int weakkey, int weakvalue)
+{
+    int i = size;
+    while (i-- > first)
+    {
+        LuaNode* n = &node[i];
+        LUAU_ASSERT(ttype(gkey(n)) != LUA_TDEADKEY || ttisnil(gval(n)));
+        if (ttisnil(gval(n)))
+            removeentry(n); // remove empty entries
+        else
+        {
+            LUAU_ASSERT(!ttisnil(gkey(n)));
+            if (!weakkey)
+                markvalue(g, gkey(n));
+            if (!weakvalue)
+                markvalue(g, gval(n));
+        }
+    }
+}
+
 static int traversetable(global_State* g, Table* h)
 {
     int i;
@@ -324,22 +369,10 @@ static int traversetable(global_State* g, Table* h)
         while (i--)
             markvalue(g, &h->array[i]);
     }
-    i = sizenode(h);
-    while (i--)
-    {
-        LuaNode* n = gnode(h, i);
-        LUAU_ASSERT(ttype(gkey(n)) != LUA_TDEADKEY || ttisnil(gval(n)));
-        if (ttisnil(gval(n)))
-            removeentry(n); // remove empty entries
-        else
-        {
-            LUAU_ASSERT(!ttisnil(gkey(n)));
-            if (!weakkey)
-                markvalue(g, gkey(n));
-            if (!weakvalue)
-                markvalue(g, gval(n));
-        }
-    }
+    traversenodes(g, h->node, 0, sizenode(h), weakkey, weakvalue);
+    // nodes that an incremental resize hasn't moved yet
+    if (TableMigration* m = h->migration)
+        traversenodes(g, m->node, m->pos, twoto(m->lsizenode), weakkey, weakvalue);
     return weakkey || weakvalue;
 }
 
@@ -455,7 +488,7 @@ static size_t propagatemark(global_State* g)
         g->gray = h->gclist;
         if (traversetable(g, h)) // table is weak?
             black2gray(o);       // keep it gray
-        return sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
+        return sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h) + sizemigration(h);
     }
     case LUA_TFUNCTION:
     {
@@ -474,7 +507,8 @@ static size_t propagatemark(global_State* g)
         traversestack(g, th);
 
         // active threads will need to be rescanned later to mark new stack writes so we mark them gray again
-        if (active)
+        // in generational mode, threads with open upvalues are rescanned as well since clearupvals relies on `markedopen` bits
+        if (active || (g->gcgencycle && th->openupval))
         {
             th->gclist = g->grayagain;
             g->grayagain = o;
@@ -536,6 +570,32 @@ static int isobjcleared(GCObject* o)
 
 #define iscleared(o) (iscollectable(o) && isobjcleared(gcvalue(o)))
 
+static int clearnodes(LuaNode* node, int first, int size)
+{
+    int activevalues = 0;
+    int i = size;
+    while (i-- > first)
+    {
+        LuaNode* n = &node[i];
+
+        // non-empty entry?
+        if (!ttisnil(gval(n)))
+        {
+            // can we clear key or value?
+            if (iscleared(gkey(n)) || iscleared(gval(n)))
+            {
+                setnilvalue(gval(n)); // remove value ...
+                removeentry(n);       // remove entry from table
+            }
+            else
+            {
+                activevalues++;
+            }
+        }
+    }
+    return activevalues;
+}
+
 /*
 ** clear collected entries from weaktables
 */
@@ -545,7 +605,7 @@ static size_t cleartable(lua_State* L, GCObject* l)
     while (l)
     {
         Table* h = gco2h(l);
-        work += sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
+        work += sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h) + sizemigration(h);
 
         int i = h->sizearray;
         while (i--)
@@ -554,27 +614,10 @@ static size_t cleartable(lua_State* L, GCObject* l)
             if (iscleared(o))   // value was collected?
                 setnilvalue(o); // remove value
         }
-        i = sizenode(h);
-        int activevalues = 0;
-        while (i--)
-        {
-            LuaNode* n = gnode(h, i);
-
-            // non-empty entry?
-            if (!ttisnil(gval(n)))
-            {
-                // can we clear key or value?
-                if (iscleared(gkey(n)) || iscleared(gval(n)))
-                {
-                    setnilvalue(gval(n)); // remove value ...
-                    removeentry(n);       // remove entry from table
-                }
-                else
-                {
-                    activevalues++;
-                }
-            }
-        }
+        int activevalues = clearnodes(h->node, 0, sizenode(h));
+        // nodes that an incremental resize hasn't moved yet
+        if (TableMigration* m = h->migration)
+            activevalues += clearnodes(m->node, m->pos, twoto(m->lsizenode));
 
         if (const char* modev = gettablemode(L->global, h))
         {
@@ -626,8 +669,8 @@ static void freeobj(lua_State* L, GCObject* o, lua_Page* page)
 static void shrinkbuffers(lua_State* L)
 {
     global_State* g = L->global;
-    // check size of string hash
-    if (g->strt.nuse < cast_to(uint32_t, g->strt.size / 4) && g->strt.size > LUA_MINSTRTABSIZE * 2)
+    // check size of string hash; shrinking waits for the resize in progress to finish
+    if (g->strt.nuse < cast_to(uint32_t, g->strt.size / 4) && g->strt.size > LUA_MINSTRTABSIZE * 2 && !g->strt.oldhash)
         luaS_resize(L, g->strt.size / 2); // table is too big
 }
 
@@ -659,6 +702,8 @@ void luaC_freeall(lua_State* L)
 
     for (int i = 0; i < g->strt.size; i++) // free all string lists
         LUAU_ASSERT(g->strt.hash[i] == NULL);
+    for (int i = 0; i < g->strt.oldsize; i++)
+        LUAU_ASSERT(g->strt.oldhash[i] == NULL);
 
     LUAU_ASSERT(L->global->strt.nuse == 0);
 }
@@ -675,8 +720,17 @@ static void markmt(global_State* g)
 static void markroot(lua_State* L)
 {
     global_State* g = L->global;
-    g->gray = NULL;
-    g->grayagain = NULL;
+
+    // minor collection starts from the objects marked by barriers since the last cycle and the remembered set in `grayagain'
+    g->gcminor = g->gcsticky;
+    g->gcgencycle = g->gcgenmode;
+
+    if (!g->gcminor)
+    {
+        g->gray = NULL;
+        g->grayagain = NULL;
+    }
+
     g->weak = NULL;
     markobject(g, g->mainthread);
     // make global table be traversed before main stack
@@ -684,6 +738,10 @@ static void markroot(lua_State* L)
     markvalue(g, registry(L));
     markmt(g);
     g->gcstate = GCSpropagate;
+
+#ifdef LUAI_GCMETRICS
+    g->gcmetrics.currcycle.minor = g->gcminor;
+#endif
 }
 
 static size_t remarkupvals(global_State* g)
@@ -739,6 +797,29 @@ static size_t clearupvals(lua_State* L)
     return work;
 }
 
+static void startsweep(lua_State* L, bool young)
+{
+    global_State* g = L->global;
+
+    if (young)
+    {
+        // pages are removed from the young set as they are swept
+        g->sweepgcopage = g->younggcopages;
+    }
+    else
+    {
+        g->sweepgcopage = g->allgcopages;
+
+        for (lua_Page* page = g->younggcopages; page; page = luaM_getnextyounggcopage(page))
+            luaM_setyounggcopage(L, page, false);
+    }
+
+    // pages that still have young objects after the sweep will be linked again
+    g->younggcopages = NULL;
+    g->gcsweepyoung = young;
+    g->gcstate = GCSsweep;
+}
+
 static size_t atomic(lua_State* L)
 {
     global_State* g = L->global;
@@ -782,6 +863,23 @@ static size_t atomic(lua_State* L)
 
     // remove collected objects from weak tables
     work += cleartable(L, g->weak);
+
+    // in generational mode, marks are kept until the heap outgrows the goal relative to the size after the last major collection
+    g->gcsticky = g->gcgencycle && !(g->gcminor && g->totalbytes > (g->gcgenmajorbase / 100) * g->gcgoal);
+
+    // weak tables stay gray to be traversed and cleared again by the next minor collection
+    if (g->gcsticky)
+    {
+        for (GCObject* o = g->weak; o;)
+        {
+            Table* h = gco2h(o);
+            o = h->gclist;
+
+            h->gclist = g->grayagain;
+            g->grayagain = obj2gco(h);
+        }
+    }
+
     g->weak = NULL;
 
 #ifdef LUAI_GCMETRICS
@@ -797,8 +895,9 @@ static size_t atomic(lua_State* L)
 
     // flip current white
     g->currentwhite = cast_byte(otherwhite(g));
-    g->sweepgcopage = g->allgcopages;
-    g->gcstate = GCSsweep;
+
+    // only young objects could have died during a minor collection
+    startsweep(L, g->gcminor && g->gcsticky);
 
     return work;
 }
@@ -821,6 +920,10 @@ static int sweepgcopage(lua_State* L, lua_Page* page)
 
     int newwhite = luaC_white(g);
 
+    // in generational mode, marks of live objects are kept and we only need to know if any of them are still young
+    bool sticky = g->gcsticky;
+    bool young = false;
+
     for (char* pos = start; pos != end; pos += blockSize)
     {
         GCObject* gco = (GCObject*)pos;
@@ -833,8 +936,17 @@ static int sweepgcopage(lua_State* L, lua_Page* page)
         if ((gco->gch.marked ^ WHITEBITS) & deadmask)
         {
             LUAU_ASSERT(!isdead(g, gco));
-            // make it white (for next cycle)
-            gco->gch.marked = cast_byte((gco->gch.marked & maskmarks) | newwhite);
+
+            if (sticky)
+            {
+                if (iswhite(gco) && !isfixed(gco))
+                    young = true;
+            }
+            else
+            {
+                // make it white (for next cycle)
+                gco->gch.marked = cast_byte((gco->gch.marked & maskmarks) | newwhite);
+            }
         }
         else
         {
@@ -847,6 +959,9 @@ static int sweepgcopage(lua_State* L, lua_Page* page)
         }
     }
 
+    if (young)
+        luaM_setyounggcopage(L, page, true);
+
     return int(end - start) / blockSize;
 }
 
@@ -854,6 +969,15 @@ static size_t gcstep(lua_State* L, size_t limit)
 {
     size_t cost = 0;
     global_State* g = L->global;
+
+    // string table resize is moved forward by new strings, but when few strings are created the collector has to finish it
+    if (g->strt.oldhash)
+        cost += luaS_rehash(L, GC_REHASHSTEP) * GC_SWEEPPAGESTEPCOST;
+
+    // the same goes for large tables that stop growing while their hash part is resized
+    if (g->tablemigrations)
+        cost += luaH_migratestep(L, GC_MIGRATESTEP) * GC_SWEEPPAGESTEPCOST;
+
     switch (g->gcstate)
     {
     case GCSpause:
@@ -914,15 +1038,24 @@ static size_t gcstep(lua_State* L, size_t limit)
         cost = atomic(L); // finish mark phase
 
         LUAU_ASSERT(g->gcstate == GCSsweep);
+
+        // deferred sweep can let the heap grow by a quarter
+        g->gcsweeplimit = g->totalbytes + g->totalbytes / 4;
         break;
     }
     case GCSsweep:
     {
         while (g->sweepgcopage && cost < limit)
         {
-            lua_Page* next = luaM_getnextgcopage(g->sweepgcopage); // page sweep might destroy the page
+            lua_Page* page = g->sweepgcopage;
+
+            // page sweep might destroy the page
+            lua_Page* next = g->gcsweepyoung ? luaM_getnextyounggcopage(page) : luaM_getnextgcopage(page);
 
-            int steps = sweepgcopage(L, g->sweepgcopage);
+            if (g->gcsweepyoung)
+                luaM_setyounggcopage(L, page, false);
+
+            int steps = sweepgcopage(L, page);
 
             g->sweepgcopage = next;
             cost += steps * GC_SWEEPPAGESTEPCOST;
@@ -933,7 +1066,10 @@ static size_t gcstep(lua_State* L, size_t limit)
         {
             // don't forget to visit main thread, it's the only object not allocated in GCO pages
             LUAU_ASSERT(!isdead(g, obj2gco(g->mainthread)));
-            makewhite(g, obj2gco(g->mainthread)); // make it white (for next cycle)
+
+            // main thread is always active, so in generational mode it remains gray on the `grayagain' list
+            if (!g->gcsticky)
+                makewhite(g, obj2gco(g->mainthread)); // make it white (for next cycle)
 
             shrinkbuffers(L);
 
@@ -1001,6 +1137,76 @@ static size_t getheaptrigger(global_State* g, size_t heapgoal)
     return heaptrigger < int64_t(g->totalbytes) ? g->totalbytes : (heaptrigger > int64_t(heapgoal) ? heapgoal : size_t(heaptrigger));
 }
 
+// exponential moving average that favors recent samples; first sample is taken as is
+static double updaterate(double rate, double sample)
+{
+    return rate > 0 ? rate * 0.75 + sample * 0.25 : sample;
+}
+
+static int getpacedworklimit(global_State* g, int lim)
+{
+    double rate = g->gcstate == GCSsweep ? g->gcstats.sweepworkrate : g->gcstats.markworkrate;
+
+    // until the first step of this kind is measured, use the default limit
+    if (rate <= 0)
+        return lim;
+
+    double paced = rate * (g->gcsteptime * 1e-6);
+
+    // once the heap is past the goal, steps can't do less work than stepmul requires
+    if (g->gcstats.heapgoalsizebytes != 0 && g->totalbytes > g->gcstats.heapgoalsizebytes && paced < double(lim))
+        return lim;
+
+    // atomic step can't be split, but other steps need to make some progress
+    if (paced < 1024)
+        return 1024;
+
+    return paced > double(INT_MAX / 2) ? INT_MAX / 2 : int(paced);
+}
+
+static void recordpacedstep(global_State* g, int lastgcstate, double starttimestamp, size_t starttotalsizebytes, size_t work)
+{
+    double endtimestamp = lua_clock();
+    double duration = endtimestamp - starttimestamp;
+
+    if (work > 0 && duration > 0)
+    {
+        if (lastgcstate == GCSpropagate || lastgcstate == GCSpropagateagain)
+            g->gcstats.markworkrate = updaterate(g->gcstats.markworkrate, work / duration);
+        else if (lastgcstate == GCSsweep)
+            g->gcstats.sweepworkrate = updaterate(g->gcstats.sweepworkrate, work / duration);
+    }
+
+    // mutator allocations since the end of the previous step
+    if (g->gcstats.stependtimestamp > 0 && starttimestamp > g->gcstats.stependtimestamp && starttotalsizebytes > g->gcstats.stependtotalsizebytes)
+    {
+        double allocated = double(starttotalsizebytes - g->gcstats.stependtotalsizebytes);
+
+        g->gcstats.allocationrate = updaterate(g->gcstats.allocationrate, allocated / (starttimestamp - g->gcstats.stependtimestamp));
+    }
+
+    g->gcstats.stependtimestamp = endtimestamp;
+    g->gcstats.stependtotalsizebytes = g->totalbytes;
+}
+
+static size_t getpacedinterval(global_State* g, double stepduration, size_t stepsize)
+{
+    // until the first cycle sets a heap goal and the allocation rate is measured, steps are scheduled like stepmul requires
+    if (g->gcstats.allocationrate <= 0 || g->gcstats.heapgoalsizebytes == 0)
+        return stepsize;
+
+    // the mutator should run long enough for GC to take its fraction of time
+    double mutatortime = stepduration * (100 - g->gccpufraction) / g->gccpufraction;
+    double interval = g->gcstats.allocationrate * mutatortime;
+
+    // the estimate is noisy, so a single interval can't take the heap past the goal
+    // once the heap is past the goal, GC can't be paced slower than stepmul requires, otherwise it may never catch up
+    size_t heapgoal = g->gcstats.heapgoalsizebytes;
+    size_t limit = heapgoal > g->totalbytes && heapgoal - g->totalbytes > stepsize ? heapgoal - g->totalbytes : stepsize;
+
+    return interval > double(limit) ? limit : size_t(interval);
+}
+
 size_t luaC_step(lua_State* L, bool assist)
 {
     global_State* g = L->global;
@@ -1009,6 +1215,19 @@ size_t luaC_step(lua_State* L, bool assist)
     LUAU_ASSERT(g->totalbytes >= g->GCthreshold);
     size_t debt = g->totalbytes - g->GCthreshold;
 
+    // sweep can be left to explicit steps as long as the heap doesn't grow too much past the size at the end of mark
+    // once it does, assists finish the sweep since the objects allocated in the meantime are carried over to the next cycle
+    if (assist && g->gcdefersweep && g->gcstate == GCSsweep)
+    {
+        if (g->totalbytes < g->gcsweeplimit)
+        {
+            g->GCthreshold = g->gcsweeplimit;
+            return 0;
+        }
+
+        g->gcsweeplimit = 0;
+    }
+
     GC_INTERRUPT(0);
 
     // at the start of the new cycle
@@ -1024,24 +1243,56 @@ size_t luaC_step(lua_State* L, bool assist)
 
     int lastgcstate = g->gcstate;
 
+    // explicit steps do the amount of work they were asked for, only assists are paced by time
+    bool paced = assist && g->gcsteptime > 0;
+    double pacedtimestamp = 0;
+    size_t pacedtotalsizebytes = g->totalbytes;
+
+    if (paced)
+    {
+        pacedtimestamp = lua_clock();
+        lim = getpacedworklimit(g, lim);
+    }
+
     size_t work = gcstep(L, lim);
 
 #ifdef LUAI_GCMETRICS
     recordGcStateStep(g, lastgcstate, lua_clock() - lasttimestamp, assist, work);
 #endif
 
+    if (paced)
+        recordpacedstep(g, lastgcstate, pacedtimestamp, pacedtotalsizebytes, work);
+
     size_t actualstepsize = work * 100 / g->gcstepmul;
 
     // at the end of the last cycle
     if (g->gcstate == GCSpause)
     {
-        // at the end of a collection cycle, set goal based on gcgoal setting
-        size_t heapgoal = (g->totalbytes / 100) * g->gcgoal;
-        size_t heaptrigger = getheaptrigger(g, heapgoal);
+        if (g->gcsticky)
+        {
+            // surviving objects of a major collection set the base for the next one
+            if (!g->gcminor)
+                g->gcgenmajorbase = g->totalbytes;
 
-        g->GCthreshold = heaptrigger;
+            // minor collection is started after a fixed amount of new allocations
+            g->GCthreshold = g->totalbytes + (g->totalbytes / 100) * g->gcgenminormul;
+        }
+        else if (g->gcgenmode && g->gcgencycle)
+        {
+            // heap has outgrown the goal of the generational mode, so major collection is started right away
+            g->GCthreshold = g->totalbytes;
+        }
+        else
+        {
+            // at the end of a collection cycle, set goal based on gcgoal setting
+            size_t heapgoal = (g->totalbytes / 100) * g->gcgoal;
+            size_t heaptrigger = getheaptrigger(g, heapgoal);
+
+            g->GCthreshold = heaptrigger;
+
+            g->gcstats.heapgoalsizebytes = heapgoal;
+        }
 
-        g->gcstats.heapgoalsizebytes = heapgoal;
         g->gcstats.endtimestamp = lua_clock();
         g->gcstats.endtotalsizebytes = g->totalbytes;
 
@@ -1051,7 +1302,20 @@ size_t luaC_step(lua_State* L, bool assist)
     }
     else
     {
-        g->GCthreshold = g->totalbytes + actualstepsize;
+        size_t interval = actualstepsize;
+
+        if (paced)
+        {
+            interval = getpacedinterval(g, g->gcstats.stependtimestamp - pacedtimestamp, actualstepsize);
+
+#ifdef LUAI_GCMETRICS
+            g->gcmetrics.currcycle.pacedsteps++;
+            g->gcmetrics.currcycle.pacedworklimit = lim;
+            g->gcmetrics.currcycle.pacedinterval = interval;
+#endif
+        }
+
+        g->GCthreshold = g->totalbytes + interval;
 
         // compensate if GC is "behind schedule" (has some debt to pay)
         if (g->GCthreshold >= debt)
@@ -1074,13 +1338,20 @@ void luaC_fullgc(lua_State* L)
 
     if (keepinvariant(g))
     {
-        // reset sweep marks to sweep all elements (returning them to white)
-        g->sweepgcopage = g->allgcopages;
+        // pages that the interrupted sweep of young pages didn't visit are still marked as young
+        if (g->gcstate == GCSsweep && g->gcsweepyoung)
+        {
+            for (lua_Page* page = g->sweepgcopage; page; page = luaM_getnextyounggcopage(page))
+                luaM_setyounggcopage(L, page, false);
+        }
+
         // reset other collector lists
         g->gray = NULL;
         g->grayagain = NULL;
         g->weak = NULL;
-        g->gcstate = GCSsweep;
+        // reset sweep marks to sweep all elements (returning them to white), this also drops marks kept in generational mode
+        g->gcsticky = false;
+        startsweep(L, /* young= */ false);
     }
     LUAU_ASSERT(g->gcstate == GCSpause || g->gcstate == GCSsweep);
     // finish any pending sweep phase
@@ -1113,16 +1384,25 @@ void luaC_fullgc(lua_State* L)
 
     size_t heapgoalsizebytes = (g->totalbytes / 100) * g->gcgoal;
 
-    // trigger cannot be correctly adjusted after a forced full GC.
-    // we will try to place it so that we can reach the goal based on
-    // the rate at which we run the GC relative to allocation rate
-    // and on amount of bytes we need to traverse in propagation stage.
-    // goal and stepmul are defined in percents
-    g->GCthreshold = g->totalbytes * (g->gcgoal * g->gcstepmul / 100 - 100) / g->gcstepmul;
-
-    // but it might be impossible to satisfy that directly
-    if (g->GCthreshold < g->totalbytes)
-        g->GCthreshold = g->totalbytes;
+    if (g->gcsticky)
+    {
+        // full collection was a major collection of the generational mode
+        g->gcgenmajorbase = g->totalbytes;
+        g->GCthreshold = g->totalbytes + (g->totalbytes / 100) * g->gcgenminormul;
+    }
+    else
+    {
+        // trigger cannot be correctly adjusted after a forced full GC.
+        // we will try to place it so that we can reach the goal based on
+        // the rate at which we run the GC relative to allocation rate
+        // and on amount of bytes we need to traverse in propagation stage.
+        // goal and stepmul are defined in percents
+        g->GCthreshold = g->totalbytes * (g->gcgoal * g->gcstepmul / 100 - 100) / g->gcstepmul;
+
+        // but it might be impossible to satisfy that directly
+        if (g->GCthreshold < g->totalbytes)
+            g->GCthreshold = g->totalbytes;
+    }
 
     g->gcstats.heapgoalsizebytes = heapgoalsizebytes;
 
@@ -1135,7 +1415,7 @@ void luaC_barrierf(lua_State* L, GCObject* o, GCObject* v)
 {
     global_State* g = L->global;
     LUAU_ASSERT(isblack(o) && iswhite(v) && !isdead(g, v) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gcsticky);
     // must keep invariant?
     if (keepinvariant(g))
         reallymarkobject(g, v); // restore invariant
@@ -1157,7 +1437,7 @@ void luaC_barriertable(lua_State* L, Table* t, GCObject* v)
     }
 
     LUAU_ASSERT(isblack(o) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gcsticky);
     black2gray(o); // make table gray (again)
     t->gclist = g->grayagain;
     g->grayagain = o;
@@ -1167,7 +1447,7 @@ void luaC_barrierback(lua_State* L, GCObject* o, GCObject** gclist)
 {
     global_State* g = L->global;
     LUAU_ASSERT(isblack(o) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gcsticky);
 
     black2gray(o); // make object gray (again)
     *gclist = g->grayagain;
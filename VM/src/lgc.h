@@ -9,9 +9,11 @@
 /*
 ** Default settings for GC tunables (settable via lua_gc)
 */
-#define LUAI_GCGOAL 200    // 200% (allow heap to double compared to live heap size)
-#define LUAI_GCSTEPMUL 200 // GC runs 'twice the speed' of memory allocation
-#define LUAI_GCSTEPSIZE 1  // GC runs every KB of memory allocation
+#define LUAI_GCGOAL 200       // 200% (allow heap to double compared to live heap size)
+#define LUAI_GCSTEPMUL 200    // GC runs 'twice the speed' of memory allocation
+#define LUAI_GCSTEPSIZE 1     // GC runs every KB of memory allocation
+#define LUAI_GCGENMINORMUL 20 // in generational mode, minor collection runs after heap grows by 20%
+#define LUAI_GCCPUFRACTION 25 // when pacing by time, GC steps take 25% of the time spent in the mutator and the collector
 
 /*
 ** Possible states of the Garbage Collector
@@ -28,8 +30,10 @@
 ** phase may break the invariant, as objects turned white may point to
 ** still-black objects. The invariant is restored when sweep ends and
 ** all objects are white again.
+** In generational mode, live objects keep their marks between the cycles
+** and the invariant has to be kept at all times until a major collection.
 */
-#define keepinvariant(g) ((g)->gcstate == GCSpropagate || (g)->gcstate == GCSpropagateagain || (g)->gcstate == GCSatomic)
+#define keepinvariant(g) ((g)->gcstate == GCSpropagate || (g)->gcstate == GCSpropagateagain || (g)->gcstate == GCSatomic || (g)->gcsticky)
 
 /*
 ** some useful bit tricks
@@ -134,5 +138,6 @@ LUAI_FUNC void luaC_barriertable(lua_State* L, Table* t, GCObject* v);
 LUAI_FUNC void luaC_barrierback(lua_State* L, GCObject* o, GCObject** gclist);
 LUAI_FUNC void luaC_validate(lua_State* L);
 LUAI_FUNC void luaC_dump(lua_State* L, void* file, const char* (*categoryName)(lua_State* L, uint8_t memcat));
+LUAI_FUNC void luaC_enumheap(lua_State* L, void* context, lua_HeapNode node, lua_HeapEdge edge);
 LUAI_FUNC int64_t luaC_allocationrate(lua_State* L);
 LUAI_FUNC const char* luaC_statename(int state);
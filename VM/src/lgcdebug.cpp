@@ -8,6 +8,7 @@
 #include "lstate.h"
 #include "lstring.h"
 #include "ltable.h"
+#include "ltm.h"
 #include "ludata.h"
 
 #include <string.h>
@@ -62,6 +63,33 @@ static void validatetable(global_State* g, Table* h)
             validateref(g, obj2gco(h), gval(n));
         }
     }
+
+    if (TableMigration* m = h->migration)
+    {
+        int oldsize = 1 << m->lsizenode;
+
+        LUAU_ASSERT(m->table == h);
+        LUAU_ASSERT(m->lsizenode < h->lsizenode);
+        LUAU_ASSERT(m->pos <= oldsize);
+
+        for (int i = 0; i < oldsize; ++i)
+        {
+            LuaNode* n = &m->node[i];
+
+            LUAU_ASSERT(i >= m->pos || (ttisnil(gkey(n)) && ttisnil(gval(n))));
+            LUAU_ASSERT(i + gnext(n) >= 0 && i + gnext(n) < oldsize);
+
+            if (!ttisnil(gval(n)))
+            {
+                TValue k = {};
+                k.tt = gkey(n)->tt;
+                k.value = gkey(n)->value;
+
+                validateref(g, obj2gco(h), &k);
+                validateref(g, obj2gco(h), gval(n));
+            }
+        }
+    }
 }
 
 static void validateclosure(global_State* g, Closure* cl)
@@ -286,9 +314,36 @@ static void dumpstring(FILE* f, TString* ts)
     fprintf(f, "\"}");
 }
 
+static void dumpnodes(FILE* f, const LuaNode* node, int size, bool& first)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        const LuaNode& n = node[i];
+
+        if (!ttisnil(&n.val) && (iscollectable(&n.key) || iscollectable(&n.val)))
+        {
+            if (!first)
+                fputc(',', f);
+            first = false;
+
+            if (iscollectable(&n.key))
+                dumpref(f, gcvalue(&n.key));
+            else
+                fprintf(f, "null");
+
+            fputc(',', f);
+
+            if (iscollectable(&n.val))
+                dumpref(f, gcvalue(&n.val));
+            else
+                fprintf(f, "null");
+        }
+    }
+}
+
 static void dumptable(FILE* f, Table* h)
 {
-    size_t size = sizeof(Table) + (h->node == &luaH_dummynode ? 0 : sizenode(h) * sizeof(LuaNode)) + h->sizearray * sizeof(TValue);
+    size_t size = sizeof(Table) + (h->node == &luaH_dummynode ? 0 : sizenode(h) * sizeof(LuaNode)) + sizemigration(h) + h->sizearray * sizeof(TValue);
 
     fprintf(f, "{\"type\":\"table\",\"cat\":%d,\"size\":%d", h->memcat, int(size));
 
@@ -298,29 +353,11 @@ static void dumptable(FILE* f, Table* h)
 
         bool first = true;
 
-        for (int i = 0; i < sizenode(h); ++i)
-        {
-            const LuaNode& n = h->node[i];
-
-            if (!ttisnil(&n.val) && (iscollectable(&n.key) || iscollectable(&n.val)))
-            {
-                if (!first)
-                    fputc(',', f);
-                first = false;
-
-                if (iscollectable(&n.key))
-                    dumpref(f, gcvalue(&n.key));
-                else
-                    fprintf(f, "null");
-
-                fputc(',', f);
+        dumpnodes(f, h->node, sizenode(h), first);
 
-                if (iscollectable(&n.val))
-                    dumpref(f, gcvalue(&n.val));
-                else
-                    fprintf(f, "null");
-            }
-        }
+        // moved nodes of an incremental resize are empty, so the whole old hash part can be dumped
+        if (h->migration)
+            dumpnodes(f, h->migration->node, 1 << h->migration->lsizenode, first);
 
         fprintf(f, "]");
     }
@@ -602,3 +639,257 @@ void luaC_dump(lua_State* L, void* file, const char* (*categoryName)(lua_State*
     fprintf(f, "}\n");
     fprintf(f, "}}\n");
 }
+
+struct EnumContext
+{
+    global_State* g;
+
+    void* context;
+    lua_HeapNode node;
+    lua_HeapEdge edge;
+};
+
+static void enumnode(EnumContext* ctx, GCObject* gco, size_t size, const char* name)
+{
+    ctx->node(ctx->context, gco, gco->gch.tt, gco->gch.memcat, size, name);
+}
+
+static void enumedge(EnumContext* ctx, GCObject* from, GCObject* to, const char* name)
+{
+    ctx->edge(ctx->context, from, to, name);
+}
+
+static void enumedges(EnumContext* ctx, GCObject* from, TValue* data, size_t size, const char* name)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (iscollectable(&data[i]))
+            enumedge(ctx, from, gcvalue(&data[i]), name);
+    }
+}
+
+static void enumstring(EnumContext* ctx, TString* ts)
+{
+    enumnode(ctx, obj2gco(ts), sizestring(ts->len), NULL);
+}
+
+static void enumnodes(EnumContext* ctx, Table* h, const LuaNode* node, int size, bool weakkey, bool weakvalue)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        const LuaNode& n = node[i];
+
+        if (!ttisnil(&n.val) && (iscollectable(&n.key) || iscollectable(&n.val)))
+        {
+            if (!weakkey && iscollectable(&n.key))
+                enumedge(ctx, obj2gco(h), gcvalue(&n.key), "[key]");
+
+            if (!weakvalue && iscollectable(&n.val))
+                enumedge(ctx, obj2gco(h), gcvalue(&n.val), ttisstring(&n.key) ? svalue(&n.key) : NULL);
+        }
+    }
+}
+
+static void enumtable(EnumContext* ctx, Table* h)
+{
+    size_t size = sizeof(Table) + (h->node == &luaH_dummynode ? 0 : sizenode(h) * sizeof(LuaNode)) + sizemigration(h) + h->sizearray * sizeof(TValue);
+
+    enumnode(ctx, obj2gco(h), size, NULL);
+
+    // weak references don't keep objects alive, so they are not reported
+    bool weakkey = false;
+    bool weakvalue = false;
+
+    const TValue* mode = gfasttm(ctx->g, h->metatable, TM_MODE);
+
+    if (mode && ttisstring(mode))
+    {
+        weakkey = strchr(svalue(mode), 'k') != NULL;
+        weakvalue = strchr(svalue(mode), 'v') != NULL;
+    }
+
+    if (h->node != &luaH_dummynode)
+        enumnodes(ctx, h, h->node, sizenode(h), weakkey, weakvalue);
+
+    // moved nodes of an incremental resize are empty, so the whole old hash part can be visited
+    if (h->migration)
+        enumnodes(ctx, h, h->migration->node, 1 << h->migration->lsizenode, weakkey, weakvalue);
+
+    if (!weakvalue)
+        enumedges(ctx, obj2gco(h), h->array, h->sizearray, "array");
+
+    if (h->metatable)
+        enumedge(ctx, obj2gco(h), obj2gco(h->metatable), "metatable");
+}
+
+static void enumclosure(EnumContext* ctx, Closure* cl)
+{
+    if (cl->isC)
+    {
+        enumnode(ctx, obj2gco(cl), sizeCclosure(cl->nupvalues), cl->c.debugname);
+    }
+    else
+    {
+        Proto* p = cl->l.p;
+
+        enumnode(ctx, obj2gco(cl), sizeLclosure(cl->nupvalues), p->debugname ? getstr(p->debugname) : NULL);
+    }
+
+    enumedge(ctx, obj2gco(cl), obj2gco(cl->env), "env");
+
+    if (cl->isC)
+    {
+        enumedges(ctx, obj2gco(cl), cl->c.upvals, cl->nupvalues, "upvalue");
+    }
+    else
+    {
+        enumedge(ctx, obj2gco(cl), obj2gco(cl->l.p), "proto");
+        enumedges(ctx, obj2gco(cl), cl->l.uprefs, cl->nupvalues, "upvalue");
+    }
+}
+
+static void enumudata(EnumContext* ctx, Udata* u)
+{
+    enumnode(ctx, obj2gco(u), sizeudata(u->len), NULL);
+
+    if (u->metatable)
+        enumedge(ctx, obj2gco(u), obj2gco(u->metatable), "metatable");
+}
+
+static void enumthread(EnumContext* ctx, lua_State* th)
+{
+    size_t size = sizeof(lua_State) + sizeof(TValue) * th->stacksize + sizeof(CallInfo) * th->size_ci;
+
+    Closure* tcl = NULL;
+    for (CallInfo* ci = th->base_ci; ci <= th->ci; ++ci)
+    {
+        if (ttisfunction(ci->func))
+        {
+            tcl = clvalue(ci->func);
+            break;
+        }
+    }
+
+    if (tcl && !tcl->isC && tcl->l.p->source)
+    {
+        Proto* p = tcl->l.p;
+
+        char buf[LUA_IDSIZE];
+        luaO_chunkid(buf, sizeof(buf), getstr(p->source), p->source->len);
+
+        char name[LUA_IDSIZE + 16];
+        snprintf(name, sizeof(name), "%s:%d", buf, p->linedefined);
+
+        enumnode(ctx, obj2gco(th), size, name);
+    }
+    else
+    {
+        enumnode(ctx, obj2gco(th), size, NULL);
+    }
+
+    enumedge(ctx, obj2gco(th), obj2gco(th->gt), "globals");
+
+    if (th->namecall)
+        enumedge(ctx, obj2gco(th), obj2gco(th->namecall), "namecall");
+
+    enumedges(ctx, obj2gco(th), th->stack, th->top - th->stack, "stack");
+
+    for (UpVal* uv = th->openupval; uv; uv = uv->u.open.threadnext)
+        enumedge(ctx, obj2gco(th), obj2gco(uv), "openupvalue");
+
+    // main thread also serves as the root for the objects that are reachable from the global state
+    if (th == ctx->g->mainthread)
+    {
+        if (iscollectable(&ctx->g->registry))
+            enumedge(ctx, obj2gco(th), gcvalue(&ctx->g->registry), "registry");
+
+        for (int i = 0; i < LUA_T_COUNT; ++i)
+        {
+            if (ctx->g->mt[i])
+                enumedge(ctx, obj2gco(th), obj2gco(ctx->g->mt[i]), "metatable");
+        }
+    }
+}
+
+static void enumproto(EnumContext* ctx, Proto* p)
+{
+    size_t size = sizeof(Proto) + sizeof(Instruction) * p->sizecode + sizeof(Proto*) * p->sizep + sizeof(TValue) * p->sizek + p->sizelineinfo +
+                  sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues;
+
+    enumnode(ctx, obj2gco(p), size, p->debugname ? getstr(p->debugname) : NULL);
+
+    if (p->source)
+        enumedge(ctx, obj2gco(p), obj2gco(p->source), "source");
+
+    if (p->debugname)
+        enumedge(ctx, obj2gco(p), obj2gco(p->debugname), "debugname");
+
+    enumedges(ctx, obj2gco(p), p->k, p->sizek, "constant");
+
+    for (int i = 0; i < p->sizep; ++i)
+        enumedge(ctx, obj2gco(p), obj2gco(p->p[i]), "proto");
+}
+
+static void enumupval(EnumContext* ctx, UpVal* uv)
+{
+    enumnode(ctx, obj2gco(uv), sizeof(UpVal), NULL);
+
+    if (iscollectable(uv->v))
+        enumedge(ctx, obj2gco(uv), gcvalue(uv->v), "value");
+}
+
+static void enumobj(EnumContext* ctx, GCObject* o)
+{
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+        return enumstring(ctx, gco2ts(o));
+
+    case LUA_TTABLE:
+        return enumtable(ctx, gco2h(o));
+
+    case LUA_TFUNCTION:
+        return enumclosure(ctx, gco2cl(o));
+
+    case LUA_TUSERDATA:
+        return enumudata(ctx, gco2u(o));
+
+    case LUA_TTHREAD:
+        return enumthread(ctx, gco2th(o));
+
+    case LUA_TPROTO:
+        return enumproto(ctx, gco2p(o));
+
+    case LUA_TUPVAL:
+        return enumupval(ctx, gco2uv(o));
+
+    default:
+        LUAU_ASSERT(0);
+    }
+}
+
+static bool enumgco(void* context, lua_Page* page, GCObject* gco)
+{
+    EnumContext* ctx = (EnumContext*)context;
+
+    // objects that are waiting to be swept may refer to objects that were already freed
+    if (!isdead(ctx->g, gco))
+        enumobj(ctx, gco);
+
+    return false;
+}
+
+void luaC_enumheap(lua_State* L, void* context, lua_HeapNode node, lua_HeapEdge edge)
+{
+    global_State* g = L->global;
+
+    EnumContext ctx;
+    ctx.g = g;
+    ctx.context = context;
+    ctx.node = node;
+    ctx.edge = edge;
+
+    enumgco(&ctx, NULL, obj2gco(g->mainthread));
+
+    luaM_visitgco(L, &ctx, enumgco);
+}
@@ -67,15 +67,23 @@
  * size up to reduce the chance that we'll allocate pages that have very few allocated blocks. The size
  * class strategy is determined by SizeClassConfig constructor.
  *
- * Note that when the last block in a page is freed, we immediately free the page with frealloc - the
- * memory manager doesn't currently attempt to keep unused memory around. This can result in excessive
- * allocation traffic and can be mitigated by adding a page cache in the future.
+ * When the last block in a page is freed, the page is not immediately returned to frealloc; instead, pages
+ * of the standard size are kept in a small cache (global_State::cachedpages) that is shared between GCO and
+ * non-GCO pages of all size classes. This avoids excessive allocation traffic when the heap size oscillates
+ * around page boundaries. The number of retained pages is limited (LUA_PAGECACHE by default, adjustable via
+ * lua_gc), and the cache can be trimmed explicitly with LUA_GCTRIMPAGECACHE. Dedicated pages of large GCOs
+ * have custom sizes and are always freed immediately.
  *
  * For both GCO and non-GCO pages, the per-page block allocation combines bump pointer style allocation
  * (lua_Page::freeNext) and per-page free list (lua_Page::freeList). We use the bump allocator to allocate
  * the contents of the page, and the free list for further reuse; this allows shorter page setup times
  * which results in less variance between allocation cost, as well as tighter sweep bounds for newly
  * allocated pages.
+ *
+ * In generational mode, GC additionally needs to know which pages contain objects allocated since the last
+ * collection, so that minor collections can sweep just these pages. Such pages are marked as young and
+ * linked in a separate intrusive list (global_State::younggcopages) when an object is allocated out of them;
+ * the sweeper removes the young mark from the page once all of its remaining objects have been marked.
  */
 
 #ifndef __has_feature
@@ -115,7 +123,7 @@ static_assert(sizeof(LuaNode) == ABISWITCH(32, 32, 32), "size mismatch for table
 
 static_assert(offsetof(TString, data) == ABISWITCH(24, 20, 20), "size mismatch for string header");
 static_assert(offsetof(Udata, data) == ABISWITCH(16, 16, 12), "size mismatch for userdata header");
-static_assert(sizeof(Table) == ABISWITCH(48, 32, 32), "size mismatch for table header");
+static_assert(sizeof(Table) == ABISWITCH(56, 36, 36), "size mismatch for table header");
 
 const size_t kSizeClasses = LUA_SIZECLASSES;
 const size_t kMaxSmallSize = 512;
@@ -182,6 +190,10 @@ struct lua_Page
     lua_Page* gcolistprev;
     lua_Page* gcolistnext;
 
+    // list of gco pages with young objects; only maintained in generational mode
+    lua_Page* youngnext;
+    bool young;
+
     int pageSize;  // page size in bytes, including page header
     int blockSize; // block size in bytes, including block header (for non-GCO)
 
@@ -208,9 +220,30 @@ static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int
 
     LUAU_ASSERT(pageSize - int(offsetof(lua_Page, data)) >= blockSize * blockCount);
 
-    lua_Page* page = (lua_Page*)(*g->frealloc)(g->ud, NULL, 0, pageSize);
+    lua_Page* page = NULL;
+
+    if (pageSize == int(kPageSize))
+    {
+        page = g->cachedpages;
+
+        if (page)
+        {
+            g->cachedpages = page->next;
+            g->cachedpagecount--;
+            g->pagecachehits++;
+        }
+        else
+        {
+            g->pagecachemisses++;
+        }
+    }
+
     if (!page)
-        luaD_throw(L, LUA_ERRMEM);
+    {
+        page = (lua_Page*)(*g->frealloc)(g->ud, NULL, 0, pageSize);
+        if (!page)
+            luaD_throw(L, LUA_ERRMEM);
+    }
 
     ASAN_POISON_MEMORY_REGION(page->data, blockSize * blockCount);
 
@@ -221,6 +254,9 @@ static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int
     page->gcolistprev = NULL;
     page->gcolistnext = NULL;
 
+    page->youngnext = NULL;
+    page->young = false;
+
     page->pageSize = pageSize;
     page->blockSize = blockSize;
 
@@ -272,6 +308,17 @@ static void freepage(lua_State* L, lua_Page** gcopageset, lua_Page* page)
             *gcopageset = page->gcolistnext;
     }
 
+    // keep the page around if there's space in the cache; all pages of standard size are interchangeable
+    if (page->pageSize == int(kPageSize) && g->cachedpagecount < g->pagecachelimit)
+    {
+        ASAN_POISON_MEMORY_REGION(page->data, page->pageSize - offsetof(lua_Page, data));
+
+        page->next = g->cachedpages;
+        g->cachedpages = page;
+        g->cachedpagecount++;
+        return;
+    }
+
     // so long
     (*g->frealloc)(g->ud, page, page->pageSize, 0);
 }
@@ -338,6 +385,16 @@ static void* newblock(lua_State* L, int sizeClass)
     return (char*)block + kBlockHeader;
 }
 
+static void addyounggcopage(global_State* g, lua_Page* page)
+{
+    if (!page->young)
+    {
+        page->young = true;
+        page->youngnext = g->younggcopages;
+        g->younggcopages = page;
+    }
+}
+
 static void* newgcoblock(lua_State* L, int sizeClass)
 {
     global_State* g = L->global;
@@ -371,6 +428,10 @@ static void* newgcoblock(lua_State* L, int sizeClass)
         page->busyBlocks++;
     }
 
+    // minor collections only sweep pages with objects allocated since the last collection
+    if (g->gcsticky)
+        addyounggcopage(g, page);
+
     // if we allocate the last block out of a page, we need to remove it from free list
     if (!page->freeList && page->freeNext < 0)
     {
@@ -454,6 +515,121 @@ static void freegcoblock(lua_State* L, int sizeClass, void* block, lua_Page* pag
         freeclasspage(L, g->freegcopages, &g->allgcopages, page, sizeClass);
 }
 
+// sampled blocks are kept in an open addressing hash set with linear probing, so that frees can be matched without extra block headers
+static uint32_t memsamplehash(void* block, uint32_t capacity)
+{
+    uint64_t h = uint64_t(uintptr_t(block) >> 3) * 0x9E3779B97F4A7C15ull;
+    return uint32_t(h >> 32) & (capacity - 1);
+}
+
+static bool growmemsamples(global_State* g)
+{
+    uint32_t newcapacity = g->memsamplecapacity ? g->memsamplecapacity * 2 : 64;
+
+    void** newsamples = (void**)(*g->frealloc)(g->ud, NULL, 0, newcapacity * sizeof(void*));
+    if (!newsamples)
+        return false;
+
+    memset(newsamples, 0, newcapacity * sizeof(void*));
+
+    for (uint32_t i = 0; i < g->memsamplecapacity; ++i)
+    {
+        if (void* block = g->memsamples[i])
+        {
+            uint32_t j = memsamplehash(block, newcapacity);
+
+            while (newsamples[j])
+                j = (j + 1) & (newcapacity - 1);
+
+            newsamples[j] = block;
+        }
+    }
+
+    if (g->memsamples)
+        (*g->frealloc)(g->ud, g->memsamples, g->memsamplecapacity * sizeof(void*), 0);
+
+    g->memsamples = newsamples;
+    g->memsamplecapacity = newcapacity;
+    return true;
+}
+
+static void samplealloc(lua_State* L, void* block, size_t size, uint8_t memcat)
+{
+    global_State* g = L->global;
+
+    size_t weight = g->memsamplebytes;
+    g->memsamplebytes = 0;
+
+    if (!g->cb.allocsample)
+        return;
+
+    // without a record of the block its free can't be reported, so the sample is dropped
+    if ((g->memsamplecount + 1) * 2 > g->memsamplecapacity && !growmemsamples(g))
+        return;
+
+    uint32_t i = memsamplehash(block, g->memsamplecapacity);
+
+    while (g->memsamples[i])
+        i = (i + 1) & (g->memsamplecapacity - 1);
+
+    g->memsamples[i] = block;
+    g->memsamplecount++;
+
+    g->cb.allocsample(L, block, size, weight, memcat);
+}
+
+static void samplefree(lua_State* L, void* block, size_t size, uint8_t memcat)
+{
+    global_State* g = L->global;
+    uint32_t mask = g->memsamplecapacity - 1;
+    uint32_t i = memsamplehash(block, g->memsamplecapacity);
+
+    while (g->memsamples[i] != block)
+    {
+        if (!g->memsamples[i])
+            return;
+
+        i = (i + 1) & mask;
+    }
+
+    // remove the entry and shift the following entries back so that lookups don't need tombstones
+    g->memsamples[i] = NULL;
+    g->memsamplecount--;
+
+    for (uint32_t j = (i + 1) & mask; g->memsamples[j]; j = (j + 1) & mask)
+    {
+        uint32_t k = memsamplehash(g->memsamples[j], g->memsamplecapacity);
+
+        // entry stays if its home slot is cyclically in (i, j]
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        g->memsamples[i] = g->memsamples[j];
+        g->memsamples[j] = NULL;
+        i = j;
+    }
+
+    if (g->cb.freesample)
+        g->cb.freesample(L, block, size, memcat);
+}
+
+void luaM_setallocsampling(lua_State* L, size_t interval)
+{
+    global_State* g = L->global;
+
+    g->memsampleinterval = interval ? interval : SIZE_MAX;
+    g->memsamplebytes = 0;
+
+    if (interval == 0 && g->memsamples)
+    {
+        (*g->frealloc)(g->ud, g->memsamples, g->memsamplecapacity * sizeof(void*), 0);
+
+        g->memsamples = NULL;
+        g->memsamplecapacity = 0;
+        g->memsamplecount = 0;
+    }
+}
+
 void* luaM_new_(lua_State* L, size_t nsize, uint8_t memcat)
 {
     global_State* g = L->global;
@@ -467,6 +643,9 @@ void* luaM_new_(lua_State* L, size_t nsize, uint8_t memcat)
     g->totalbytes += nsize;
     g->memcatbytes[memcat] += nsize;
 
+    if (LUAU_UNLIKELY((g->memsamplebytes += nsize) >= g->memsampleinterval))
+        samplealloc(L, block, nsize, memcat);
+
     return block;
 }
 
@@ -494,6 +673,9 @@ GCObject* luaM_newgco_(lua_State* L, size_t nsize, uint8_t memcat)
 
         page->freeNext -= page->blockSize;
         page->busyBlocks++;
+
+        if (g->gcsticky)
+            addyounggcopage(g, page);
     }
 
     if (block == NULL && nsize > 0)
@@ -502,6 +684,9 @@ GCObject* luaM_newgco_(lua_State* L, size_t nsize, uint8_t memcat)
     g->totalbytes += nsize;
     g->memcatbytes[memcat] += nsize;
 
+    if (LUAU_UNLIKELY((g->memsamplebytes += nsize) >= g->memsampleinterval))
+        samplealloc(L, block, nsize, memcat);
+
     return (GCObject*)block;
 }
 
@@ -510,6 +695,9 @@ void luaM_free_(lua_State* L, void* block, size_t osize, uint8_t memcat)
     global_State* g = L->global;
     LUAU_ASSERT((osize == 0) == (block == NULL));
 
+    if (LUAU_UNLIKELY(g->memsamplecount) && block)
+        samplefree(L, block, osize, memcat);
+
     int oclass = sizeclass(osize);
 
     if (oclass >= 0)
@@ -526,6 +714,9 @@ void luaM_freegco_(lua_State* L, GCObject* block, size_t osize, uint8_t memcat,
     global_State* g = L->global;
     LUAU_ASSERT((osize == 0) == (block == NULL));
 
+    if (LUAU_UNLIKELY(g->memsamplecount))
+        samplefree(L, block, osize, memcat);
+
     int oclass = sizeclass(osize);
 
     if (oclass >= 0)
@@ -579,8 +770,15 @@ void* luaM_realloc_(lua_State* L, void* block, size_t osize, size_t nsize, uint8
     }
 
     LUAU_ASSERT((nsize == 0) == (result == NULL));
+
+    if (LUAU_UNLIKELY(g->memsamplecount) && block)
+        samplefree(L, block, osize, memcat);
+
     g->totalbytes = (g->totalbytes - osize) + nsize;
     g->memcatbytes[memcat] += nsize - osize;
+
+    // resized blocks can't be reported since the callback could observe the state in the middle of an update (e.g. stack reallocation)
+    g->memsamplebytes += nsize;
     return result;
 }
 
@@ -598,11 +796,43 @@ void luaM_getpagewalkinfo(lua_Page* page, char** start, char** end, int* busyBlo
     *blockSize = page->blockSize;
 }
 
+int luaM_trimpagecache(lua_State* L, int keep)
+{
+    global_State* g = L->global;
+    int released = 0;
+
+    while (g->cachedpagecount > keep)
+    {
+        lua_Page* page = g->cachedpages;
+
+        g->cachedpages = page->next;
+        g->cachedpagecount--;
+
+        (*g->frealloc)(g->ud, page, page->pageSize, 0);
+        released++;
+    }
+
+    return released;
+}
+
 lua_Page* luaM_getnextgcopage(lua_Page* page)
 {
     return page->gcolistnext;
 }
 
+lua_Page* luaM_getnextyounggcopage(lua_Page* page)
+{
+    return page->youngnext;
+}
+
+void luaM_setyounggcopage(lua_State* L, lua_Page* page, bool young)
+{
+    if (young)
+        addyounggcopage(L->global, page);
+    else
+        page->young = false; // page must have already been unlinked from `younggcopages'
+}
+
 void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco))
 {
     char* start;
@@ -25,8 +25,14 @@ LUAI_FUNC void* luaM_realloc_(lua_State* L, void* block, size_t osize, size_t ns
 
 LUAI_FUNC l_noret luaM_toobig(lua_State* L);
 
+LUAI_FUNC int luaM_trimpagecache(lua_State* L, int keep);
+
+LUAI_FUNC void luaM_setallocsampling(lua_State* L, size_t interval);
+
 LUAI_FUNC void luaM_getpagewalkinfo(lua_Page* page, char** start, char** end, int* busyBlocks, int* blockSize);
 LUAI_FUNC lua_Page* luaM_getnextgcopage(lua_Page* page);
+LUAI_FUNC lua_Page* luaM_getnextyounggcopage(lua_Page* page);
+LUAI_FUNC void luaM_setyounggcopage(lua_State* L, lua_Page* page, bool young);
 
 LUAI_FUNC void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco));
 LUAI_FUNC void luaM_visitgco(lua_State* L, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco));
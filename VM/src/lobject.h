@@ -415,6 +415,17 @@ typedef struct LuaNode
     }
 
 // clang-format off
+typedef struct TableMigration
+{
+    LuaNode* node;     // old hash part; nodes before `pos' were already moved to the new one
+    int pos;
+    uint8_t lsizenode; // log2 of size of `node' array
+    uint8_t memcat;
+
+    struct Table* table;         // NULL until the new hash part is allocated
+    struct TableMigration* next; // next resize in progress
+} TableMigration;
+
 typedef struct Table
 {
     CommonHeader;
@@ -438,6 +449,7 @@ typedef struct Table
     TValue* array;  // array part
     LuaNode* node;
     GCObject* gclist;
+    TableMigration* migration; // incremental resize of the hash part that is in progress, see ltable.cpp
 } Table;
 // clang-format on
 
@@ -89,6 +89,9 @@ static void close_state(lua_State* L)
     luaC_freeall(L);         // collect all objects
     LUAU_ASSERT(g->strt.nuse == 0);
     luaM_freearray(L, L->global->strt.hash, L->global->strt.size, TString*, 0);
+    if (g->strt.oldhash)
+        luaM_freearray(L, g->strt.oldhash, g->strt.oldsize, TString*, 0);
+    luaH_freemigrations(L);
     freestack(L, L);
     for (int i = 0; i < LUA_SIZECLASSES; i++)
     {
@@ -96,6 +99,8 @@ static void close_state(lua_State* L)
         LUAU_ASSERT(g->freegcopages[i] == NULL);
     }
     LUAU_ASSERT(g->allgcopages == NULL);
+    luaM_trimpagecache(L, 0);
+    luaM_setallocsampling(L, 0);
     LUAU_ASSERT(g->totalbytes == sizeof(LG));
     LUAU_ASSERT(g->memcatbytes[0] == sizeof(LG));
     for (int i = 1; i < LUA_MEMORY_CATEGORIES; i++)
@@ -191,16 +196,31 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->strt.size = 0;
     g->strt.nuse = 0;
     g->strt.hash = NULL;
+    g->strt.oldhash = NULL;
+    g->strt.oldsize = 0;
+    g->strt.rehashpos = 0;
     setnilvalue(&g->pseudotemp);
     setnilvalue(registry(L));
     g->gcstate = GCSpause;
+    g->gcgenmode = false;
+    g->gcgencycle = false;
+    g->gcsticky = false;
+    g->gcminor = false;
+    g->gcsweepyoung = false;
+    g->gcdefersweep = false;
     g->gray = NULL;
     g->grayagain = NULL;
     g->weak = NULL;
+    g->tablemigrations = NULL;
     g->totalbytes = sizeof(LG);
     g->gcgoal = LUAI_GCGOAL;
     g->gcstepmul = LUAI_GCSTEPMUL;
     g->gcstepsize = LUAI_GCSTEPSIZE << 10;
+    g->gcsweeplimit = 0;
+    g->gcgenminormul = LUAI_GCGENMINORMUL;
+    g->gcsteptime = 0;
+    g->gccpufraction = LUAI_GCCPUFRACTION;
+    g->gcgenmajorbase = 0;
     for (i = 0; i < LUA_SIZECLASSES; i++)
     {
         g->freepages[i] = NULL;
@@ -208,12 +228,23 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     }
     g->allgcopages = NULL;
     g->sweepgcopage = NULL;
+    g->younggcopages = NULL;
+    g->cachedpages = NULL;
+    g->cachedpagecount = 0;
+    g->pagecachelimit = LUA_PAGECACHE;
+    g->pagecachehits = 0;
+    g->pagecachemisses = 0;
     for (i = 0; i < LUA_T_COUNT; i++)
         g->mt[i] = NULL;
     for (i = 0; i < LUA_UTAG_LIMIT; i++)
         g->udatagc[i] = NULL;
     for (i = 0; i < LUA_MEMORY_CATEGORIES; i++)
         g->memcatbytes[i] = 0;
+    g->memsampleinterval = SIZE_MAX;
+    g->memsamplebytes = 0;
+    g->memsamples = NULL;
+    g->memsamplecapacity = 0;
+    g->memsamplecount = 0;
 
     g->memcatbytes[0] = sizeof(LG);
 
@@ -22,6 +22,11 @@ typedef struct stringtable
     TString** hash;
     uint32_t nuse; // number of elements
     int size;
+
+    // while the table is resized, strings are moved out of the old buckets in order; buckets before rehashpos are already empty
+    TString** oldhash;
+    int oldsize;
+    int rehashpos;
 } stringtable;
 // clang-format on
 
@@ -69,6 +74,7 @@ typedef struct CallInfo
 
 #define LUA_CALLINFO_RETURN (1 << 0) // should the interpreter return after returning from this callinfo? first frame must have this set
 #define LUA_CALLINFO_HANDLE (1 << 1) // should the error thrown during execution get handled by continuation from this callinfo? func must be C
+#define LUA_CALLINFO_INTERPRETED (1 << 2) // has the frame of a function with custom execution data been running in the interpreter?
 
 #define curr_func(L) (clvalue(L->ci->func))
 #define ci_func(ci) (clvalue((ci)->func))
@@ -89,6 +95,13 @@ struct GCStats
     double starttimestamp = 0;
     double atomicstarttimestamp = 0;
     double endtimestamp = 0;
+
+    // data for pacing by time, only collected when a target step time is set
+    double markworkrate = 0;   // amount of mark work done per second
+    double sweepworkrate = 0;  // amount of sweep work done per second
+    double allocationrate = 0; // bytes allocated by the mutator per second
+    double stependtimestamp = 0;
+    size_t stependtotalsizebytes = 0;
 };
 
 #ifdef LUAI_GCMETRICS
@@ -131,6 +144,13 @@ struct GCCycleMetrics
     size_t propagateagainwork = 0;
 
     size_t endtotalsizebytes = 0;
+
+    bool minor = false; // cycle only collected objects allocated since the previous cycle (generational mode)
+
+    // decisions of the time-based pacing (LUA_GCSETSTEPTIME) for the last step of the cycle
+    size_t pacedsteps = 0;
+    size_t pacedworklimit = 0;
+    size_t pacedinterval = 0;
 };
 
 struct GCMetrics
@@ -140,6 +160,7 @@ struct GCMetrics
 
     // when cycle is completed, last cycle values are updated
     uint64_t completedcycles = 0;
+    uint64_t completedminorcycles = 0;
 
     GCCycleMetrics lastcycle;
     GCCycleMetrics currcycle;
@@ -153,6 +174,7 @@ struct lua_ExecutionCallbacks
     void (*close)(lua_State* L);                 // called when global VM state is closed
     void (*destroy)(lua_State* L, Proto* proto); // called when function is destroyed
     int (*enter)(lua_State* L, Proto* proto);    // called when function is about to start/resume (when execdata is present), return 0 to exit VM
+    void (*loop)(lua_State* L, Proto* proto);    // called on loop back edges of functions running in the VM (when execdata is present)
     void (*setbreakpoint)(lua_State* L, Proto* proto, int line); // called when a breakpoint is set in a function
 };
 
@@ -172,25 +194,50 @@ typedef struct global_State
     uint8_t currentwhite;
     uint8_t gcstate; // state of garbage collector
 
+    bool gcgenmode;    // generational mode was requested via lua_gc
+    bool gcgencycle;   // current cycle was started in generational mode
+    bool gcsticky;     // marks of live objects are kept when the cycle ends, so the next cycle is a minor collection
+    bool gcminor;      // current cycle is a minor collection that only traverses objects that are not marked yet
+    bool gcsweepyoung; // sweep only visits `younggcopages'
+    bool gcdefersweep; // GC assists leave the sweep to explicit steps
+
 
     GCObject* gray;      // list of gray objects
     GCObject* grayagain; // list of objects to be traversed atomically
     GCObject* weak;     // list of weak tables (to be cleared)
 
+    TableMigration* tablemigrations; // incremental table resizes in progress, finished by the collector for tables that stop growing
 
     size_t GCthreshold;                       // when totalbytes > GCthreshold, run GC step
     size_t totalbytes;                        // number of bytes currently allocated
     int gcgoal;                               // see LUAI_GCGOAL
     int gcstepmul;                            // see LUAI_GCSTEPMUL
     int gcstepsize;                          // see LUAI_GCSTEPSIZE
+    size_t gcsweeplimit;                      // heap size at which GC assists stop deferring the sweep, see LUA_GCDEFERSWEEP
+    int gcgenminormul;                        // see LUAI_GCGENMINORMUL
+    int gcsteptime;                           // target duration of a GC step in microseconds, 0 to pace by gcstepmul/gcstepsize
+    int gccpufraction;                        // see LUAI_GCCPUFRACTION
+    size_t gcgenmajorbase;                    // heap size after the last major collection in generational mode
 
     struct lua_Page* freepages[LUA_SIZECLASSES]; // free page linked list for each size class for non-collectable objects
     struct lua_Page* freegcopages[LUA_SIZECLASSES]; // free page linked list for each size class for collectable objects
     struct lua_Page* allgcopages; // page linked list with all pages for all classes
-    struct lua_Page* sweepgcopage; // position of the sweep in `allgcopages'
+    struct lua_Page* sweepgcopage; // position of the sweep in `allgcopages' or `younggcopages'
+    struct lua_Page* cachedpages; // page linked list with unused pages that can be reused by any size class
+    int cachedpagecount;          // number of pages in `cachedpages'
+    int pagecachelimit;           // maximum number of pages in `cachedpages', see LUA_PAGECACHE
+    uint64_t pagecachehits;       // number of page allocations served from `cachedpages'
+    uint64_t pagecachemisses;     // number of page allocations that had to use frealloc
+    struct lua_Page* younggcopages; // page linked list with pages that have objects allocated since the last cycle (in generational mode)
 
     size_t memcatbytes[LUA_MEMORY_CATEGORIES]; // total amount of memory used by each memory category
 
+    size_t memsampleinterval; // an allocation is sampled once this many bytes were allocated since the last sample, SIZE_MAX when disabled
+    size_t memsamplebytes;    // number of bytes allocated since the last sample
+    void** memsamples;        // open addressing hash set of sampled blocks that weren't freed yet
+    uint32_t memsamplecapacity;
+    uint32_t memsamplecount;
+
 
     struct lua_State* mainthread;
     UpVal uvhead;                                    // head of double-linked list of all open upvalues
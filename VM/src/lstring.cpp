@@ -7,6 +7,102 @@
 
 #include <string.h>
 
+#if LUA_WIDESTRINGHASH
+// XXH64 with zero seed; the four lanes are independent so the main loop hashes 32 bytes per iteration
+#define PRIME1 0x9E3779B185EBCA87ull
+#define PRIME2 0xC2B2AE3D27D4EB4Full
+#define PRIME3 0x165667B19E3779F9ull
+#define PRIME4 0x85EBCA77C2B2AE63ull
+#define PRIME5 0x27D4EB2F165667C5ull
+
+static uint64_t rotl64(uint64_t x, int s)
+{
+    return (x << s) | (x >> (64 - s));
+}
+
+static uint64_t read64(const char* str)
+{
+    // should compile into fast unaligned reads
+    uint64_t r;
+    memcpy(&r, str, 8);
+    return r;
+}
+
+static uint64_t hashround(uint64_t acc, uint64_t input)
+{
+    return rotl64(acc + input * PRIME2, 31) * PRIME1;
+}
+
+static uint64_t hashmerge(uint64_t acc, uint64_t lane)
+{
+    return (acc ^ hashround(0, lane)) * PRIME1 + PRIME4;
+}
+
+unsigned int luaS_hash(const char* str, size_t len)
+{
+    // Note that this hashing algorithm is replicated in BytecodeBuilder.cpp, BytecodeBuilder::getStringHash
+    const char* end = str + len;
+    uint64_t h;
+
+    if (len >= 32)
+    {
+        uint64_t v1 = PRIME1 + PRIME2;
+        uint64_t v2 = PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - PRIME1;
+
+        do
+        {
+            v1 = hashround(v1, read64(str));
+            v2 = hashround(v2, read64(str + 8));
+            v3 = hashround(v3, read64(str + 16));
+            v4 = hashround(v4, read64(str + 24));
+            str += 32;
+        } while (end - str >= 32);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = hashmerge(h, v1);
+        h = hashmerge(h, v2);
+        h = hashmerge(h, v3);
+        h = hashmerge(h, v4);
+    }
+    else
+    {
+        h = PRIME5;
+    }
+
+    h += len;
+
+    for (; end - str >= 8; str += 8)
+        h = rotl64(h ^ hashround(0, read64(str)), 27) * PRIME1 + PRIME4;
+
+    if (end - str >= 4)
+    {
+        uint32_t block;
+        memcpy(&block, str, 4);
+
+        h = rotl64(h ^ (block * PRIME1), 23) * PRIME2 + PRIME3;
+        str += 4;
+    }
+
+    for (; str < end; ++str)
+        h = rotl64(h ^ ((uint8_t)*str * PRIME5), 11) * PRIME1;
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+
+    return unsigned(h);
+}
+
+#undef PRIME1
+#undef PRIME2
+#undef PRIME3
+#undef PRIME4
+#undef PRIME5
+#else
 unsigned int luaS_hash(const char* str, size_t len)
 {
     // Note that this hashing algorithm is replicated in BytecodeBuilder.cpp, BytecodeBuilder::getStringHash
@@ -41,31 +137,105 @@ unsigned int luaS_hash(const char* str, size_t len)
 
     return h;
 }
+#endif
+
+// strings from the old buckets are moved to the new ones a few buckets at a time, so that a resize doesn't visit all strings at once
+#define REHASHSTEP 4
 
 void luaS_resize(lua_State* L, int newsize)
 {
-    TString** newhash = luaM_newarray(L, newsize, TString*, 0);
     stringtable* tb = &L->global->strt;
+
+    // only one resize can be in progress
+    if (tb->oldhash)
+        luaS_rehash(L, tb->oldsize);
+
+    TString** newhash = luaM_newarray(L, newsize, TString*, 0);
     for (int i = 0; i < newsize; i++)
         newhash[i] = NULL;
-    // rehash
-    for (int i = 0; i < tb->size; i++)
+
+    if (tb->hash)
+    {
+        tb->oldhash = tb->hash;
+        tb->oldsize = tb->size;
+        tb->rehashpos = 0;
+    }
+
+    tb->size = newsize;
+    tb->hash = newhash;
+}
+
+int luaS_rehash(lua_State* L, int buckets)
+{
+    stringtable* tb = &L->global->strt;
+
+    if (!tb->oldhash)
+        return 0;
+
+    int start = tb->rehashpos;
+    int end = buckets < tb->oldsize - start ? start + buckets : tb->oldsize;
+
+    for (int i = start; i < end; i++)
     {
-        TString* p = tb->hash[i];
+        TString* p = tb->oldhash[i];
         while (p)
         {                            // for each node in the list
             TString* next = p->next; // save next
             unsigned int h = p->hash;
-            int h1 = lmod(h, newsize); // new position
-            LUAU_ASSERT(cast_int(h % newsize) == lmod(h, newsize));
-            p->next = newhash[h1]; // chain it
-            newhash[h1] = p;
+            int h1 = lmod(h, tb->size); // new position
+            LUAU_ASSERT(cast_int(h % tb->size) == lmod(h, tb->size));
+            p->next = tb->hash[h1]; // chain it
+            tb->hash[h1] = p;
             p = next;
         }
+        tb->oldhash[i] = NULL;
     }
-    luaM_freearray(L, tb->hash, tb->size, TString*, 0);
-    tb->size = newsize;
-    tb->hash = newhash;
+
+    tb->rehashpos = end;
+
+    if (end == tb->oldsize)
+    {
+        luaM_freearray(L, tb->oldhash, tb->oldsize, TString*, 0);
+        tb->oldhash = NULL;
+        tb->oldsize = 0;
+        tb->rehashpos = 0;
+    }
+
+    return end - start;
+}
+
+static TString* findstr(stringtable* tb, const char* str, size_t l, unsigned int h)
+{
+    for (TString* el = tb->hash[lmod(h, tb->size)]; el != NULL; el = el->next)
+        if (el->len == l && memcmp(str, getstr(el), l) == 0)
+            return el;
+
+    if (tb->oldhash)
+    {
+        // buckets that were already moved are empty
+        for (TString* el = tb->oldhash[lmod(h, tb->oldsize)]; el != NULL; el = el->next)
+            if (el->len == l && memcmp(str, getstr(el), l) == 0)
+                return el;
+    }
+
+    return NULL;
+}
+
+static void linkstr(lua_State* L, TString* ts)
+{
+    stringtable* tb = &L->global->strt;
+    int h = lmod(ts->hash, tb->size);
+    ts->next = tb->hash[h]; // chain new entry
+    tb->hash[h] = ts;
+
+    tb->nuse++;
+
+    // shrinking halves the table when it's a quarter full, so each insertion moves several buckets to finish the resize before the next one
+    if (tb->oldhash)
+        luaS_rehash(L, REHASHSTEP);
+
+    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
+        luaS_resize(L, tb->size * 2); // too crowded
 }
 
 static TString* newlstr(lua_State* L, const char* str, size_t l, unsigned int h)
@@ -82,14 +252,7 @@ static TString* newlstr(lua_State* L, const char* str, size_t l, unsigned int h)
     memcpy(ts->data, str, l);
     ts->data[l] = '\0'; // ending 0
 
-    stringtable* tb = &L->global->strt;
-    h = lmod(h, tb->size);
-    ts->next = tb->hash[h]; // chain new entry
-    tb->hash[h] = ts;
-
-    tb->nuse++;
-    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
-        luaS_resize(L, tb->size * 2); // too crowded
+    linkstr(L, ts);
 
     return ts;
 }
@@ -113,20 +276,15 @@ TString* luaS_bufstart(lua_State* L, size_t size)
 TString* luaS_buffinish(lua_State* L, TString* ts)
 {
     unsigned int h = luaS_hash(ts->data, ts->len);
-    stringtable* tb = &L->global->strt;
-    int bucket = lmod(h, tb->size);
 
     // search if we already have this string in the hash table
-    for (TString* el = tb->hash[bucket]; el != NULL; el = el->next)
+    if (TString* el = findstr(&L->global->strt, ts->data, ts->len, h))
     {
-        if (el->len == ts->len && memcmp(el->data, ts->data, ts->len) == 0)
-        {
-            // string may be dead
-            if (isdead(L->global, obj2gco(el)))
-                changewhite(obj2gco(el));
+        // string may be dead
+        if (isdead(L->global, obj2gco(el)))
+            changewhite(obj2gco(el));
 
-            return el;
-        }
+        return el;
     }
 
     LUAU_ASSERT(ts->next == NULL);
@@ -134,12 +292,8 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
     ts->hash = h;
     ts->data[ts->len] = '\0'; // ending 0
     ts->atom = ATOM_UNDEF;
-    ts->next = tb->hash[bucket]; // chain new entry
-    tb->hash[bucket] = ts;
 
-    tb->nuse++;
-    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
-        luaS_resize(L, tb->size * 2); // too crowded
+    linkstr(L, ts);
 
     return ts;
 }
@@ -147,25 +301,18 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
 TString* luaS_newlstr(lua_State* L, const char* str, size_t l)
 {
     unsigned int h = luaS_hash(str, l);
-    for (TString* el = L->global->strt.hash[lmod(h, L->global->strt.size)]; el != NULL; el = el->next)
+    if (TString* el = findstr(&L->global->strt, str, l, h))
     {
-        if (el->len == l && (memcmp(str, getstr(el), l) == 0))
-        {
-            // string may be dead
-            if (isdead(L->global, obj2gco(el)))
-                changewhite(obj2gco(el));
-            return el;
-        }
+        // string may be dead
+        if (isdead(L->global, obj2gco(el)))
+            changewhite(obj2gco(el));
+        return el;
     }
     return newlstr(L, str, l, h); // not found
 }
 
-static bool unlinkstr(lua_State* L, TString* ts)
+static bool unlinkstr(TString** p, TString* ts)
 {
-    global_State* g = L->global;
-
-    TString** p = &g->strt.hash[lmod(ts->hash, g->strt.size)];
-
     while (TString* curr = *p)
     {
         if (curr == ts)
@@ -184,8 +331,10 @@ static bool unlinkstr(lua_State* L, TString* ts)
 
 void luaS_free(lua_State* L, TString* ts, lua_Page* page)
 {
-    if (unlinkstr(L, ts))
-        L->global->strt.nuse--;
+    stringtable* tb = &L->global->strt;
+
+    if (unlinkstr(&tb->hash[lmod(ts->hash, tb->size)], ts) || (tb->oldhash && unlinkstr(&tb->oldhash[lmod(ts->hash, tb->oldsize)], ts)))
+        tb->nuse--;
     else
         LUAU_ASSERT(ts->next == NULL); // orphaned string buffer
 
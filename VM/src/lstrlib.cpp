@@ -180,6 +180,7 @@ typedef struct MatchState
     const char* src_init; // init of source string
     const char* src_end;  // end ('\0') of source string
     const char* p_end;    // end ('\0') of pattern
+    const struct PatternItem* item_end; // end of the compiled pattern
     lua_State* L;
     int level; // total number of captures (finished or unfinished)
     struct
@@ -577,7 +578,8 @@ static const char* lmemfind(const char* s1, size_t l1, const char* s2, size_t l2
         while (l1 > 0 && (init = (const char*)memchr(s1, *s2, l1)) != NULL)
         {
             init++; // 1st char is already checked
-            if (memcmp(init, s2 + 1, l2) == 0)
+            // last char is checked before the rest to reject most candidates without a call
+            if (l2 == 0 || (init[l2 - 1] == s2[l2] && memcmp(init, s2 + 1, l2) == 0))
                 return init - 1;
             else
             { // correct `l1' and `s1' to try again
@@ -589,6 +591,452 @@ static const char* lmemfind(const char* s1, size_t l1, const char* s2, size_t l2
     }
 }
 
+/*
+** {======================================================
+** COMPILED PATTERNS
+** =======================================================
+*/
+
+// Patterns without back references and balanced matches are compiled into a list of items, with each character class expanded into a 256-bit
+// set. Matching follows match() step by step, so the results are the same, but classes don't need to be parsed again at every character.
+// The set of characters that a match can start with lets the callers skip positions where a match can't start.
+
+enum PatternItemKind
+{
+    PI_SET,      // single character class, with an optional suffix
+    PI_OPEN,     // start of a capture
+    PI_POSITION, // position capture
+    PI_CLOSE,    // end of a capture
+    PI_FRONTIER, // %f[set]
+    PI_END,      // '$' at the end of the pattern
+};
+
+struct PatternItem
+{
+    uint8_t kind;
+    char suffix; // '?', '*', '+', '-' or 0
+    uint8_t set[32];
+};
+
+#define PATTERN_PREFIX 16
+
+// longer patterns are left to match(), since every pattern character may take a PatternItem
+#define PATTERN_MAXLEN 256
+
+struct Pattern
+{
+    bool compiled; // false when the pattern has to be handled by match()
+    bool anchor;
+    bool nullable; // a match may be empty or may not consume a character from the set below
+    uint8_t first[32]; // characters a match can start with
+
+    // literal characters that every match starts with
+    uint8_t prefixlen;
+    char prefix[PATTERN_PREFIX];
+
+    int count;
+    PatternItem items[1];
+};
+
+#define testset(set, c) (((set)[uchar(c) >> 3] >> (uchar(c) & 7)) & 1)
+
+static const char* cmatch(MatchState* ms, const char* s, const PatternItem* p);
+
+static const char* cmax_expand(MatchState* ms, const char* s, const PatternItem* p)
+{
+    ptrdiff_t i = 0; // counts maximum expand for item
+    while (s + i < ms->src_end && testset(p->set, s[i]))
+        i++;
+    // when the next item has to match a character, positions where it can't are skipped without a call
+    const PatternItem* next = p + 1;
+    while (next != ms->item_end && (next->kind == PI_OPEN || next->kind == PI_POSITION || next->kind == PI_CLOSE))
+        next++;
+    const uint8_t* nextset = (next != ms->item_end && next->kind == PI_SET && (next->suffix == 0 || next->suffix == '+')) ? next->set : NULL;
+    // keeps trying to match with the maximum repetitions
+    while (i >= 0)
+    {
+        if (!nextset || (s + i < ms->src_end && testset(nextset, s[i])))
+        {
+            const char* res = cmatch(ms, (s + i), p + 1);
+            if (res)
+                return res;
+        }
+        i--; // else didn't match; reduce 1 repetition to try again
+    }
+    return NULL;
+}
+
+static const char* cmin_expand(MatchState* ms, const char* s, const PatternItem* p)
+{
+    for (;;)
+    {
+        const char* res = cmatch(ms, s, p + 1);
+        if (res != NULL)
+            return res;
+        else if (s < ms->src_end && testset(p->set, *s))
+            s++; // try with one more repetition
+        else
+            return NULL;
+    }
+}
+
+static const char* cstart_capture(MatchState* ms, const char* s, const PatternItem* p, int what)
+{
+    const char* res;
+    int level = ms->level;
+    LUAU_ASSERT(level < LUA_MAXCAPTURES); // checked during compilation
+    ms->capture[level].init = s;
+    ms->capture[level].len = what;
+    ms->level = level + 1;
+    if ((res = cmatch(ms, s, p)) == NULL) // match failed?
+        ms->level--;                      // undo capture
+    return res;
+}
+
+static const char* cend_capture(MatchState* ms, const char* s, const PatternItem* p)
+{
+    int l = capture_to_close(ms);
+    const char* res;
+    ms->capture[l].len = s - ms->capture[l].init; // close capture
+    if ((res = cmatch(ms, s, p)) == NULL)         // match failed?
+        ms->capture[l].len = CAP_UNFINISHED;      // undo capture
+    return res;
+}
+
+static const char* cmatch(MatchState* ms, const char* s, const PatternItem* p)
+{
+    if (ms->matchdepth-- == 0)
+        luaL_error(ms->L, "pattern too complex");
+init: // using goto's to optimize tail recursion
+    if (p != ms->item_end)
+    { // end of pattern?
+        switch (p->kind)
+        {
+        case PI_OPEN:
+            s = cstart_capture(ms, s, p + 1, CAP_UNFINISHED);
+            break;
+        case PI_POSITION:
+            s = cstart_capture(ms, s, p + 1, CAP_POSITION);
+            break;
+        case PI_CLOSE:
+            s = cend_capture(ms, s, p + 1);
+            break;
+        case PI_END:
+            s = (s == ms->src_end) ? s : NULL; // check end of string
+            break;
+        case PI_FRONTIER:
+        {
+            char previous = (s == ms->src_init) ? '\0' : *(s - 1);
+            if (!testset(p->set, previous) && testset(p->set, *s))
+            {
+                p++;
+                goto init; // return cmatch(ms, s, p + 1);
+            }
+            s = NULL; // match failed
+            break;
+        }
+        default:
+        {
+            // does not match at least once?
+            if (!(s < ms->src_end && testset(p->set, *s)))
+            {
+                if (p->suffix == '*' || p->suffix == '?' || p->suffix == '-')
+                { // accept empty?
+                    p++;
+                    goto init; // return cmatch(ms, s, p + 1);
+                }
+                else          // '+' or no suffix
+                    s = NULL; // fail
+            }
+            else
+            { // matched once
+                switch (p->suffix)
+                { // handle optional suffix
+                case '?':
+                { // optional
+                    const char* res;
+                    if ((res = cmatch(ms, s + 1, p + 1)) != NULL)
+                        s = res;
+                    else
+                    {
+                        p++;
+                        goto init; // else return cmatch(ms, s, p + 1);
+                    }
+                    break;
+                }
+                case '+': // 1 or more repetitions
+                    s++;  // 1 match already done
+                          // go through
+                case '*': // 0 or more repetitions
+                    s = cmax_expand(ms, s, p);
+                    break;
+                case '-': // 0 or more repetitions (minimum)
+                    s = cmin_expand(ms, s, p);
+                    break;
+                default: // no suffix
+                    s++;
+                    p++;
+                    goto init; // return cmatch(ms, s + 1, p + 1);
+                }
+            }
+            break;
+        }
+        }
+    }
+    ms->matchdepth++;
+    return s;
+}
+
+// returns the end of the class starting at p, or NULL if the class is malformed; mirrors classend without raising errors
+static const char* compileclassend(const char* p, const char* pe)
+{
+    switch (*p++)
+    {
+    case L_ESC:
+        return p == pe ? NULL : p + 1;
+    case '[':
+        if (*p == '^')
+            p++;
+        do
+        { // look for a `]'
+            if (p == pe)
+                return NULL;
+            if (*(p++) == L_ESC && p < pe)
+                p++; // skip escapes (e.g. `%]')
+        } while (*p != ']');
+        return p + 1;
+    default:
+        return p;
+    }
+}
+
+// returns the number of items, or -1 if the pattern has to be handled by match()
+static int compileitems(const char* p, const char* pe, PatternItem* items)
+{
+    int count = 0;
+    int captures = 0;
+    int open = 0;
+
+    while (p < pe)
+    {
+        PatternItem& item = items[count++];
+        item.suffix = 0;
+        memset(item.set, 0, sizeof(item.set));
+
+        switch (*p)
+        {
+        case '(':
+            if (++captures > LUA_MAXCAPTURES)
+                return -1;
+
+            if (*(p + 1) == ')')
+            {
+                item.kind = PI_POSITION;
+                p += 2;
+            }
+            else
+            {
+                item.kind = PI_OPEN;
+                open++;
+                p++;
+            }
+            continue;
+        case ')':
+            if (open == 0)
+                return -1;
+
+            item.kind = PI_CLOSE;
+            open--;
+            p++;
+            continue;
+        case '$':
+            if (p + 1 == pe)
+            {
+                item.kind = PI_END;
+                p++;
+                continue;
+            }
+            break;
+        case L_ESC:
+            if (p + 1 == pe || *(p + 1) == 'b' || isdigit(uchar(*(p + 1))))
+                return -1;
+
+            if (*(p + 1) == 'f')
+            {
+                p += 2;
+                const char* ep = *p == '[' ? compileclassend(p, pe) : NULL;
+                if (!ep)
+                    return -1;
+
+                item.kind = PI_FRONTIER;
+                for (int c = 0; c < 256; c++)
+                    if (matchbracketclass(c, p, ep - 1))
+                        item.set[c >> 3] |= 1 << (c & 7);
+                p = ep;
+                continue;
+            }
+            break;
+        }
+
+        const char* ep = compileclassend(p, pe);
+        if (!ep)
+            return -1;
+
+        item.kind = PI_SET;
+        for (int c = 0; c < 256; c++)
+        {
+            bool match;
+            switch (*p)
+            {
+            case '.':
+                match = true;
+                break;
+            case L_ESC:
+                match = match_class(c, uchar(*(p + 1)));
+                break;
+            case '[':
+                match = matchbracketclass(c, p, ep - 1);
+                break;
+            default:
+                match = uchar(*p) == c;
+                break;
+            }
+
+            if (match)
+                item.set[c >> 3] |= 1 << (c & 7);
+        }
+
+        if (*ep == '?' || *ep == '*' || *ep == '+' || *ep == '-')
+        {
+            item.suffix = *ep;
+            ep++;
+        }
+
+        p = ep;
+    }
+
+    // unfinished captures are reported by match()
+    return open == 0 ? count : -1;
+}
+
+static int setsize(const uint8_t set[32], int* last)
+{
+    int size = 0;
+    for (int c = 0; c < 256; c++)
+        if (testset(set, c))
+        {
+            size++;
+            *last = c;
+        }
+    return size;
+}
+
+static void analyzepattern(Pattern* pat)
+{
+    pat->nullable = true;
+    memset(pat->first, 0, sizeof(pat->first));
+
+    for (int i = 0; i < pat->count; i++)
+    {
+        const PatternItem& item = pat->items[i];
+
+        // captures and frontiers don't consume characters; '$' can match without consuming any
+        if (item.kind == PI_END)
+            break;
+        if (item.kind != PI_SET)
+            continue;
+
+        for (int j = 0; j < 32; j++)
+            pat->first[j] |= item.set[j];
+
+        if (item.suffix == 0 || item.suffix == '+')
+        {
+            pat->nullable = false;
+            break;
+        }
+    }
+
+    pat->prefixlen = 0;
+
+    for (int i = 0; i < pat->count && pat->prefixlen < PATTERN_PREFIX; i++)
+    {
+        const PatternItem& item = pat->items[i];
+
+        if (item.kind == PI_OPEN || item.kind == PI_POSITION || item.kind == PI_CLOSE)
+            continue;
+
+        int c = 0;
+        if (item.kind != PI_SET || item.suffix != 0 || setsize(item.set, &c) != 1)
+            break;
+
+        pat->prefix[pat->prefixlen++] = char(c);
+    }
+}
+
+// pushes the compiled form of the pattern at stack index 'arg', which is cached until the next garbage collection cycle
+static const Pattern* getpattern(lua_State* L, int arg)
+{
+    size_t lp;
+    const char* p = lua_tolstring(L, arg, &lp);
+    const char* pe = p + lp;
+
+    if (lp > PATTERN_MAXLEN)
+    {
+        lua_pushnil(L);
+        return NULL;
+    }
+
+    lua_pushvalue(L, arg);
+    lua_rawget(L, lua_upvalueindex(1));
+
+    if (Pattern* pat = (Pattern*)lua_touserdata(L, -1))
+        return pat->compiled ? pat : NULL;
+
+    lua_pop(L, 1);
+
+    bool anchor = (*p == '^');
+    if (anchor)
+        p++;
+
+    // every item takes at least one character of the pattern
+    Pattern* pat = (Pattern*)lua_newuserdata(L, sizeof(Pattern) + sizeof(PatternItem) * (pe - p));
+    pat->anchor = anchor;
+    pat->count = compileitems(p, pe, pat->items);
+    pat->compiled = pat->count >= 0;
+
+    if (pat->compiled)
+        analyzepattern(pat);
+
+    lua_pushvalue(L, arg);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, lua_upvalueindex(1));
+
+    return pat->compiled ? pat : NULL;
+}
+
+// returns the first position at or after s where a match can start, or NULL if there is none
+static const char* skippattern(const Pattern* pat, const char* s, const char* e)
+{
+    if (pat->nullable)
+        return s;
+
+    if (pat->prefixlen)
+        return lmemfind(s, e - s, pat->prefix, pat->prefixlen);
+
+    for (; s < e; s++)
+        if (testset(pat->first, *s))
+            return s;
+
+    return NULL;
+}
+
+static const char* domatch(MatchState* ms, const char* s, const char* p, const Pattern* pat)
+{
+    return pat ? cmatch(ms, s, pat->items) : match(ms, s, p);
+}
+
+// }======================================================
+
 static void push_onecapture(MatchState* ms, int i, const char* s, const char* e)
 {
     if (i >= ms->level)
@@ -633,13 +1081,14 @@ static int nospecials(const char* p, size_t l)
     return 1; // no special chars found
 }
 
-static void prepstate(MatchState* ms, lua_State* L, const char* s, size_t ls, const char* p, size_t lp)
+static void prepstate(MatchState* ms, lua_State* L, const char* s, size_t ls, const char* p, size_t lp, const Pattern* pat)
 {
     ms->L = L;
     ms->matchdepth = LUAI_MAXCCALLS;
     ms->src_init = s;
     ms->src_end = s + ls;
     ms->p_end = p + lp;
+    ms->item_end = pat ? pat->items + pat->count : NULL;
 }
 
 static void reprepstate(MatchState* ms)
@@ -677,18 +1126,21 @@ static int str_find_aux(lua_State* L, int find)
     {
         MatchState ms;
         const char* s1 = s + init - 1;
+        const Pattern* pat = getpattern(L, 2);
         int anchor = (*p == '^');
         if (anchor)
         {
             p++;
             lp--; // skip anchor character
         }
-        prepstate(&ms, L, s, ls, p, lp);
+        prepstate(&ms, L, s, ls, p, lp, pat);
         do
         {
             const char* res;
+            if (pat && !anchor && (s1 = skippattern(pat, s1, ms.src_end)) == NULL)
+                break;
             reprepstate(&ms);
-            if ((res = match(&ms, s1, p)) != NULL)
+            if ((res = domatch(&ms, s1, p, pat)) != NULL)
             {
                 if (find)
                 {
@@ -721,13 +1173,19 @@ static int gmatch_aux(lua_State* L)
     size_t ls, lp;
     const char* s = lua_tolstring(L, lua_upvalueindex(1), &ls);
     const char* p = lua_tolstring(L, lua_upvalueindex(2), &lp);
+    const Pattern* pat = (const Pattern*)lua_touserdata(L, lua_upvalueindex(4));
     const char* src;
-    prepstate(&ms, L, s, ls, p, lp);
+    // gmatch doesn't treat '^' as an anchor
+    if (pat && (!pat->compiled || pat->anchor))
+        pat = NULL;
+    prepstate(&ms, L, s, ls, p, lp, pat);
     for (src = s + (size_t)lua_tointeger(L, lua_upvalueindex(3)); src <= ms.src_end; src++)
     {
         const char* e;
+        if (pat && (src = skippattern(pat, src, ms.src_end)) == NULL)
+            break;
         reprepstate(&ms);
-        if ((e = match(&ms, src, p)) != NULL)
+        if ((e = domatch(&ms, src, p, pat)) != NULL)
         {
             int newstart = (int)(e - s);
             if (e == src)
@@ -746,7 +1204,8 @@ static int gmatch(lua_State* L)
     luaL_checkstring(L, 2);
     lua_settop(L, 2);
     lua_pushinteger(L, 0);
-    lua_pushcclosure(L, gmatch_aux, NULL, 3);
+    getpattern(L, 2);
+    lua_pushcclosure(L, gmatch_aux, NULL, 4);
     return 1;
 }
 
@@ -828,18 +1287,28 @@ static int str_gsub(lua_State* L)
     MatchState ms;
     luaL_Buffer b;
     luaL_argexpected(L, tr == LUA_TNUMBER || tr == LUA_TSTRING || tr == LUA_TFUNCTION || tr == LUA_TTABLE, 3, "string/function/table");
+    const Pattern* pat = getpattern(L, 2); // the string buffer expects to be placed above the pattern
     luaL_buffinit(L, &b);
     if (anchor)
     {
         p++;
         lp--; // skip anchor character
     }
-    prepstate(&ms, L, src, srcl, p, lp);
+    prepstate(&ms, L, src, srcl, p, lp, pat);
     while (n < max_s)
     {
         const char* e;
+        if (pat && !anchor)
+        {
+            // characters that can't start a match are copied as is
+            const char* next = skippattern(pat, src, ms.src_end);
+            if (next == NULL)
+                break;
+            luaL_addlstring(&b, src, next - src, -1);
+            src = next;
+        }
         reprepstate(&ms);
-        e = match(&ms, src, p);
+        e = domatch(&ms, src, p, pat);
         if (e)
         {
             n++;
@@ -1064,44 +1533,44 @@ static int str_split(lua_State* L)
     size_t needleLen;
     const char* needle = luaL_optlstring(L, 2, ",", &needleLen);
 
-    const char* begin = haystack;
     const char* end = haystack + haystackLen;
-    const char* spanStart = begin;
-    int numMatches = 0;
-
-    lua_createtable(L, 0, 0);
 
     if (needleLen == 0)
-        begin++;
-
-    // Don't iterate the last needleLen - 1 bytes of the string - they are
-    // impossible to be splits and would let us memcmp past the end of the
-    // buffer.
-    for (const char* iter = begin; iter <= end - needleLen; iter++)
     {
-        // Use of memcmp here instead of strncmp is so that we allow embedded
-        // nulls to be used in either of the haystack or the needle strings.
-        // Most Lua string APIs allow embedded nulls, and this should be no
-        // exception.
-        if (memcmp(iter, needle, needleLen) == 0)
-        {
-            lua_pushinteger(L, ++numMatches);
-            lua_pushlstring(L, spanStart, iter - spanStart);
-            lua_settable(L, -3);
+        // every character is a separate piece
+        lua_createtable(L, int(haystackLen), 0);
 
-            spanStart = iter + needleLen;
-            if (needleLen > 0)
-                iter += needleLen - 1;
+        for (size_t i = 0; i < haystackLen; i++)
+        {
+            lua_pushlstring(L, haystack + i, 1);
+            lua_rawseti(L, -2, int(i + 1));
         }
+
+        return 1;
     }
 
-    if (needleLen > 0)
+    // pieces are counted first so that the result is allocated once; lmemfind allows embedded nulls in either string
+    int numMatches = 1;
+    for (const char* iter = haystack; (iter = lmemfind(iter, end - iter, needle, needleLen)) != NULL; iter += needleLen)
+        numMatches++;
+
+    lua_createtable(L, numMatches, 0);
+
+    const char* spanStart = haystack;
+
+    for (int i = 1; i < numMatches; i++)
     {
-        lua_pushinteger(L, ++numMatches);
-        lua_pushlstring(L, spanStart, end - spanStart);
-        lua_settable(L, -3);
+        const char* iter = lmemfind(spanStart, end - spanStart, needle, needleLen);
+
+        lua_pushlstring(L, spanStart, iter - spanStart);
+        lua_rawseti(L, -2, i);
+
+        spanStart = iter + needleLen;
     }
 
+    lua_pushlstring(L, spanStart, end - spanStart);
+    lua_rawseti(L, -2, numMatches);
+
     return 1;
 }
 
@@ -1625,13 +2094,9 @@ static int str_unpack(lua_State* L)
 static const luaL_Reg strlib[] = {
     {"byte", str_byte},
     {"char", str_char},
-    {"find", str_find},
     {"format", str_format},
-    {"gmatch", gmatch},
-    {"gsub", str_gsub},
     {"len", str_len},
     {"lower", str_lower},
-    {"match", str_match},
     {"rep", str_rep},
     {"reverse", str_reverse},
     {"sub", str_sub},
@@ -1643,6 +2108,33 @@ static const luaL_Reg strlib[] = {
     {NULL, NULL},
 };
 
+// pattern matching functions share the cache of compiled patterns as their first upvalue
+static const luaL_Reg patternlib[] = {
+    {"find", str_find},
+    {"gmatch", gmatch},
+    {"gsub", str_gsub},
+    {"match", str_match},
+    {NULL, NULL},
+};
+
+static void createpatterncache(lua_State* L)
+{
+    lua_createtable(L, 0, 0); // compiled patterns, keyed by pattern string
+    lua_createtable(L, 0, 1);
+    lua_pushliteral(L, "v"); // entries are dropped when the compiled pattern is collected
+    lua_setfield(L, -2, "__mode");
+    lua_setmetatable(L, -2);
+
+    for (const luaL_Reg* l = patternlib; l->name; l++)
+    {
+        lua_pushvalue(L, -1);
+        lua_pushcclosure(L, l->func, l->name, 1);
+        lua_setfield(L, -3, l->name);
+    }
+
+    lua_pop(L, 1); // pop cache
+}
+
 static void createmetatable(lua_State* L)
 {
     lua_createtable(L, 0, 1); // create metatable for strings
@@ -1661,6 +2153,7 @@ static void createmetatable(lua_State* L)
 int luaopen_string(lua_State* L)
 {
     luaL_register(L, LUA_STRLIBNAME, strlib);
+    createpatterncache(L);
     createmetatable(L);
 
     return 1;
@@ -21,6 +21,12 @@
  * invariant where the boundary must be in the array part - this enforces a consistent iteration order through the
  * prefix of the table when using pairs(), and allows to implement algorithms that access elements in 1..#t range
  * more efficiently.
+ *
+ * When the hash part of a large table grows, its nodes are moved to the new hash part incrementally to avoid a long pause: the old
+ * node array is kept in a TableMigration record, every insertion moves a few of its nodes and the collector moves the rest when the
+ * table stops growing. Lookups that don't find the key in the new hash part search the old one as well. Nodes of the old array are
+ * never relinked; moved nodes lose their key and value but stay in their chains, so the chains of the remaining nodes stay intact.
+ * Traversals finish the resize first since the nodes would otherwise move while they are visited.
  */
 
 #include "ltable.h"
@@ -37,6 +43,12 @@
 #define MAXBITS 26
 #define MAXSIZE (1 << MAXBITS)
 
+// hash parts with at least 2^MIGRATEBITS nodes are resized incrementally when they grow
+#define MIGRATEBITS 13
+
+// number of old nodes that are visited by every insertion while the hash part is resized incrementally
+#define MIGRATESTEP 8
+
 static_assert(offsetof(LuaNode, val) == 0, "Unexpected Node memory layout, pointer cast in gval2slot is incorrect");
 
 // TKey is bitpacked for memory efficiency so we need to validate bit counts for worst case
@@ -149,6 +161,26 @@ static LuaNode* mainposition(const Table* t, const TValue* key)
     }
 }
 
+/*
+** search function for keys that were not moved by an incremental resize yet;
+** the size of the old hash part is a smaller power of 2, so the old main
+** position can be derived from the main position `mp' in the new one
+*/
+static const TValue* getmigrating(Table* t, const LuaNode* mp, const TValue* key)
+{
+    TableMigration* m = t->migration;
+    LuaNode* n = &m->node[cast_int(mp - t->node) & (twoto(m->lsizenode) - 1)];
+    for (;;)
+    { // check whether `key' is somewhere in the chain
+        if (luaO_rawequalKey(gkey(n), key))
+            return gval(n); // that's it
+        if (gnext(n) == 0)
+            break;
+        n += gnext(n);
+    }
+    return luaO_nilobject;
+}
+
 /*
 ** returns the index for `key' if `key' is an appropriate key to live in
 ** the array part of the table, -1 otherwise.
@@ -196,6 +228,8 @@ static int findindex(lua_State* L, Table* t, StkId key)
 
 int luaH_next(lua_State* L, Table* t, StkId key)
 {
+    if (t->migration)
+        luaH_finishmigration(L, t);
     int i = findindex(L, t, key); // find original element
     for (i++; i < t->sizearray; i++)
     { // try first array part
@@ -298,14 +332,13 @@ static int numusearray(const Table* t, int* nums)
     return ause;
 }
 
-static int numusehash(const Table* t, int* nums, int* pnasize)
+static int numusenodes(const LuaNode* node, int first, int size, int* nums, int* pnasize)
 {
     int totaluse = 0; // total number of elements
     int ause = 0;     // summation of `nums'
-    int i = sizenode(t);
-    while (i--)
+    for (int i = first; i < size; i++)
     {
-        LuaNode* n = &t->node[i];
+        const LuaNode* n = &node[i];
         if (!ttisnil(gval(n)))
         {
             if (ttisnumber(gkey(n)))
@@ -317,6 +350,15 @@ static int numusehash(const Table* t, int* nums, int* pnasize)
     return totaluse;
 }
 
+static int numusehash(const Table* t, int* nums, int* pnasize)
+{
+    int totaluse = numusenodes(t->node, 0, sizenode(t), nums, pnasize);
+    // count nodes that an incremental resize hasn't moved yet
+    if (TableMigration* m = t->migration)
+        totaluse += numusenodes(m->node, m->pos, twoto(m->lsizenode), nums, pnasize);
+    return totaluse;
+}
+
 static void setarrayvector(lua_State* L, Table* t, int size)
 {
     if (size > MAXSIZE)
@@ -373,12 +415,55 @@ static TValue* arrayornewkey(lua_State* L, Table* t, const TValue* key)
     return newkey(L, t, key);
 }
 
+static void unlinkmigration(global_State* g, TableMigration* m)
+{
+    TableMigration** p = &g->tablemigrations;
+    while (*p != m)
+        p = &(*p)->next;
+    *p = m->next;
+}
+
+static void freemigration(lua_State* L, TableMigration* m)
+{
+    if (m->node)
+        luaM_freearray(L, m->node, twoto(m->lsizenode), LuaNode, m->memcat);
+    unlinkmigration(L->global, m);
+    luaM_free_(L, m, sizeof(TableMigration), m->memcat);
+}
+
+static void startmigration(lua_State* L, Table* t, int nhsize)
+{
+    global_State* g = L->global;
+    LuaNode* nold = t->node;
+    int oldhsize = t->lsizenode;
+    // the record is linked before the new hash part is allocated, so that the collector frees it if the allocation fails
+    TableMigration* m = cast_to(TableMigration*, luaM_new_(L, sizeof(TableMigration), t->memcat));
+    m->node = NULL;
+    m->pos = 0;
+    m->lsizenode = 0;
+    m->memcat = t->memcat;
+    m->table = NULL;
+    m->next = g->tablemigrations;
+    g->tablemigrations = m;
+    setnodevector(L, t, nhsize);
+    m->node = nold;
+    m->lsizenode = cast_byte(oldhsize);
+    m->table = t;
+    t->migration = m;
+}
+
 static void resize(lua_State* L, Table* t, int nasize, int nhsize)
 {
     if (nasize > MAXSIZE || nhsize > MAXSIZE)
         luaG_runerror(L, "table overflow");
     int oldasize = t->sizearray;
     int oldhsize = t->lsizenode;
+    // large hash parts that grow while the array part keeps its size are moved incrementally, see migrate
+    if (nasize == oldasize && oldhsize >= MIGRATEBITS && nhsize > twoto(oldhsize) && !t->migration)
+    {
+        startmigration(L, t, nhsize);
+        return;
+    }
     LuaNode* nold = t->node; // save old hash ...
     if (nasize > oldasize)   // array part must grow?
         setarrayvector(L, t, nasize);
@@ -386,6 +471,9 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
     setnodevector(L, t, nhsize);
     // used for the migration check at the end
     LuaNode* nnew = t->node;
+    // nodes of an incremental resize in progress are re-inserted as well; newkey must not move them while this happens
+    TableMigration* mold = t->migration;
+    t->migration = NULL;
     if (nasize < oldasize)
     { // array part must shrink?
         t->sizearray = nasize;
@@ -415,6 +503,19 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
             setobjt2t(L, arrayornewkey(L, t, &ok), gval(old));
         }
     }
+    if (mold)
+    {
+        for (int i = mold->pos; i < twoto(mold->lsizenode); i++)
+        {
+            LuaNode* old = mold->node + i;
+            if (!ttisnil(gval(old)))
+            {
+                TValue ok;
+                getnodekey(L, &ok, old);
+                setobjt2t(L, arrayornewkey(L, t, &ok), gval(old));
+            }
+        }
+    }
 
     // make sure we haven't recursively rehashed during element migration
     LUAU_ASSERT(nnew == t->node);
@@ -422,6 +523,8 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
 
     if (nold != dummynode)
         luaM_freearray(L, nold, twoto(oldhsize), LuaNode, t->memcat); // free old array
+    if (mold)
+        freemigration(L, mold);
 }
 
 static int adjustasize(Table* t, int size, const TValue* ek)
@@ -485,6 +588,7 @@ Table* luaH_new(lua_State* L, int narray, int nhash)
     t->safeenv = 0;
     t->nodemask8 = 0;
     t->node = cast_to(LuaNode*, dummynode);
+    t->migration = NULL;
     if (narray > 0)
         setarrayvector(L, t, narray);
     if (nhash > 0)
@@ -494,6 +598,8 @@ Table* luaH_new(lua_State* L, int narray, int nhash)
 
 void luaH_free(lua_State* L, Table* t, lua_Page* page)
 {
+    if (t->migration)
+        freemigration(L, t->migration);
     if (t->node != dummynode)
         luaM_freearray(L, t->node, sizenode(t), LuaNode, t->memcat);
     if (t->array)
@@ -520,29 +626,16 @@ static LuaNode* getfreepos(Table* t)
 ** position or not: if it is not, move colliding node to an empty place and
 ** put new key in its main position; otherwise (colliding node is in its main
 ** position), new key goes to an empty position.
+** returns NULL if the hash part has no free position left.
 */
-static TValue* newkey(lua_State* L, Table* t, const TValue* key)
+static TValue* insertkey(lua_State* L, Table* t, const TValue* key)
 {
-    // enforce boundary invariant
-    if (ttisnumber(key) && nvalue(key) == t->sizearray + 1)
-    {
-        rehash(L, t, key); // grow table
-
-        // after rehash, numeric keys might be located in the new array part, but won't be found in the node part
-        return arrayornewkey(L, t, key);
-    }
-
     LuaNode* mp = mainposition(t, key);
     if (!ttisnil(gval(mp)) || mp == dummynode)
     {
         LuaNode* n = getfreepos(t); // get a free place
-        if (n == NULL)
-        {                      // cannot find a free place?
-            rehash(L, t, key); // grow table
-
-            // after rehash, numeric keys might be located in the new array part, but won't be found in the node part
-            return arrayornewkey(L, t, key);
-        }
+        if (n == NULL)              // cannot find a free place?
+            return NULL;
         LUAU_ASSERT(n != dummynode);
         TValue mk;
         getnodekey(L, &mk, mp);
@@ -573,11 +666,72 @@ static TValue* newkey(lua_State* L, Table* t, const TValue* key)
         }
     }
     setnodekey(L, mp, key);
-    luaC_barriert(L, t, key);
     LUAU_ASSERT(ttisnil(gval(mp)));
     return gval(mp);
 }
 
+/*
+** moves up to `count' nodes of the old hash part to the new one and
+** finishes the incremental resize when no nodes are left; returns the
+** number of nodes visited
+*/
+static int migrate(lua_State* L, Table* t, int count)
+{
+    TableMigration* m = t->migration;
+    int size = twoto(m->lsizenode);
+    int first = m->pos;
+    int last = count < size - first ? first + count : size;
+    for (int i = first; i < last; i++)
+    {
+        LuaNode* old = &m->node[i];
+        if (!ttisnil(gval(old)))
+        {
+            TValue ok;
+            getnodekey(L, &ok, old);
+            // the new hash part is at least twice as large and every insertion moves several nodes, so it can't fill up before the resize is done
+            TValue* v = insertkey(L, t, &ok);
+            LUAU_ASSERT(v);
+            // both parts belong to the same table, so the write doesn't need a barrier
+            setobjt2t(L, v, gval(old));
+            setnilvalue(gval(old));
+        }
+        setnilvalue(gkey(old)); // moved node can't be found anymore, but its `next' still links the chain
+    }
+    m->pos = last;
+    if (last == size)
+    {
+        t->migration = NULL;
+        freemigration(L, m);
+    }
+    return last - first;
+}
+
+static TValue* newkey(lua_State* L, Table* t, const TValue* key)
+{
+    if (t->migration)
+        migrate(L, t, MIGRATESTEP);
+
+    // enforce boundary invariant
+    if (ttisnumber(key) && nvalue(key) == t->sizearray + 1)
+    {
+        rehash(L, t, key); // grow table
+
+        // after rehash, numeric keys might be located in the new array part, but won't be found in the node part
+        return arrayornewkey(L, t, key);
+    }
+
+    TValue* v = insertkey(L, t, key);
+    if (v == NULL)
+    {                      // cannot find a free place?
+        rehash(L, t, key); // grow table
+
+        // after rehash, numeric keys might be located in the new array part, but won't be found in the node part
+        return arrayornewkey(L, t, key);
+    }
+    luaC_barriert(L, t, key);
+    return v;
+}
+
 /*
 ** search function for integers
 */
@@ -589,7 +743,8 @@ const TValue* luaH_getnum(Table* t, int key)
     else if (t->node != dummynode)
     {
         double nk = cast_num(key);
-        LuaNode* n = hashnum(t, nk);
+        LuaNode* mp = hashnum(t, nk);
+        LuaNode* n = mp;
         for (;;)
         { // check whether `key' is somewhere in the chain
             if (ttisnumber(gkey(n)) && luai_numeq(nvalue(gkey(n)), nk))
@@ -598,6 +753,12 @@ const TValue* luaH_getnum(Table* t, int key)
                 break;
             n += gnext(n);
         }
+        if (LUAU_UNLIKELY(t->migration != NULL))
+        {
+            TValue k;
+            setnvalue(&k, nk);
+            return getmigrating(t, mp, &k);
+        }
         return luaO_nilobject;
     }
     else
@@ -609,7 +770,8 @@ const TValue* luaH_getnum(Table* t, int key)
 */
 const TValue* luaH_getstr(Table* t, TString* key)
 {
-    LuaNode* n = hashstr(t, key);
+    LuaNode* mp = hashstr(t, key);
+    LuaNode* n = mp;
     for (;;)
     { // check whether `key' is somewhere in the chain
         if (ttisstring(gkey(n)) && tsvalue(gkey(n)) == key)
@@ -618,6 +780,13 @@ const TValue* luaH_getstr(Table* t, TString* key)
             break;
         n += gnext(n);
     }
+    if (LUAU_UNLIKELY(t->migration != NULL))
+    {
+        TValue k = {};
+        k.value.gc = obj2gco(key);
+        k.tt = LUA_TSTRING;
+        return getmigrating(t, mp, &k);
+    }
     return luaO_nilobject;
 }
 
@@ -643,7 +812,8 @@ const TValue* luaH_get(Table* t, const TValue* key)
     }
     default:
     {
-        LuaNode* n = mainposition(t, key);
+        LuaNode* mp = mainposition(t, key);
+        LuaNode* n = mp;
         for (;;)
         { // check whether `key' is somewhere in the chain
             if (luaO_rawequalKey(gkey(n), key))
@@ -652,6 +822,8 @@ const TValue* luaH_get(Table* t, const TValue* key)
                 break;
             n += gnext(n);
         }
+        if (LUAU_UNLIKELY(t->migration != NULL))
+            return getmigrating(t, mp, key);
         return luaO_nilobject;
     }
     }
@@ -775,6 +947,9 @@ int luaH_getn(Table* t)
 
 Table* luaH_clone(lua_State* L, Table* tt)
 {
+    if (tt->migration)
+        luaH_finishmigration(L, tt);
+
     Table* t = luaM_newgco(L, Table, sizeof(Table), L->activememcat);
     luaC_init(L, t, LUA_TTABLE);
     t->metatable = tt->metatable;
@@ -786,6 +961,7 @@ Table* luaH_clone(lua_State* L, Table* tt)
     t->readonly = 0;
     t->safeenv = 0;
     t->node = cast_to(LuaNode*, dummynode);
+    t->migration = NULL;
     t->lastfree = 0;
 
     if (tt->sizearray)
@@ -812,28 +988,72 @@ Table* luaH_clone(lua_State* L, Table* tt)
 
 void luaH_clear(Table* tt)
 {
+    static_assert(LUA_TNIL == 0, "nil values and empty nodes are expected to be all zero bits");
+
     // clear array part
-    for (int i = 0; i < tt->sizearray; ++i)
-    {
-        setnilvalue(&tt->array[i]);
-    }
+    if (tt->sizearray)
+        memset(tt->array, 0, tt->sizearray * sizeof(TValue));
 
     maybesetaboundary(tt, 0);
 
-    // clear hash part
+    // clear hash part: keys, values and `next' are all zero in an empty node
     if (tt->node != dummynode)
     {
         int size = sizenode(tt);
         tt->lastfree = size;
-        for (int i = 0; i < size; ++i)
+        memset(tt->node, 0, size * sizeof(LuaNode));
+    }
+
+    // nodes that weren't moved yet are cleared as well; the next step of the resize will free the old hash part
+    if (TableMigration* m = tt->migration)
+    {
+        int size = twoto(m->lsizenode);
+        for (int i = m->pos; i < size; ++i)
         {
-            LuaNode* n = gnode(tt, i);
+            LuaNode* n = &m->node[i];
             setnilvalue(gkey(n));
             setnilvalue(gval(n));
-            gnext(n) = 0;
         }
+        m->pos = size;
     }
 
     // back to empty -> no tag methods present
     tt->tmcache = cast_byte(~0);
 }
+
+void luaH_finishmigration(lua_State* L, Table* t)
+{
+    migrate(L, t, MAXSIZE);
+    LUAU_ASSERT(t->migration == NULL);
+}
+
+/*
+** resizes are moved forward by insertions; for tables that stop growing,
+** the collector calls this to visit up to `nodes' old nodes
+*/
+int luaH_migratestep(lua_State* L, int nodes)
+{
+    global_State* g = L->global;
+    int visited = 0;
+    TableMigration* m = g->tablemigrations;
+    while (m && visited < nodes)
+    {
+        TableMigration* next = m->next;
+        if (m->table == NULL)
+            freemigration(L, m); // allocation of the new hash part failed
+        else if (!isdead(g, obj2gco(m->table))) // keys of tables that are about to be freed can't be hashed as they may be freed already
+            visited += migrate(L, m->table, nodes - visited);
+        m = next;
+    }
+    return visited;
+}
+
+void luaH_freemigrations(lua_State* L)
+{
+    global_State* g = L->global;
+    while (TableMigration* m = g->tablemigrations)
+    {
+        LUAU_ASSERT(m->table == NULL); // tables free their own resize
+        freemigration(L, m);
+    }
+}
@@ -11,6 +11,9 @@
 
 #define gval2slot(t, v) int(cast_to(LuaNode*, static_cast<const TValue*>(v)) - t->node)
 
+// memory used by the old hash part of a table that is being resized incrementally
+#define sizemigration(t) ((t)->migration ? sizeof(TableMigration) + sizeof(LuaNode) * twoto((t)->migration->lsizenode) : 0)
+
 // reset cache of absent metamethods, cache is updated in luaT_gettm
 #define invalidateTMcache(t) t->tmcache = 0
 
@@ -29,6 +32,9 @@ LUAI_FUNC int luaH_next(lua_State* L, Table* t, StkId key);
 LUAI_FUNC int luaH_getn(Table* t);
 LUAI_FUNC Table* luaH_clone(lua_State* L, Table* tt);
 LUAI_FUNC void luaH_clear(Table* tt);
+LUAI_FUNC void luaH_finishmigration(lua_State* L, Table* t);
+LUAI_FUNC int luaH_migratestep(lua_State* L, int nodes);
+LUAI_FUNC void luaH_freemigrations(lua_State* L);
 
 #define luaH_setslot(L, t, slot, key) (invalidateTMcache(t), (slot == luaO_nilobject ? luaH_newkey(L, t, key) : cast_to(TValue*, slot)))
 
@@ -9,6 +9,8 @@
 #include "lgc.h"
 #include "ldebug.h"
 #include "lvm.h"
+#include "ldo.h"
+#include "lnumutils.h"
 
 static int foreachi(lua_State* L)
 {
@@ -298,124 +300,230 @@ static int tunpack(lua_State* L)
 
 /*
 ** {======================================================
-** Quicksort
-** (based on `Algorithms in MODULA-3', Robert Sedgewick;
-**  Addison-Wesley, 1993.)
+** Introsort
+** (quicksort based on `Algorithms in MODULA-3', Robert Sedgewick;
+**  Addison-Wesley, 1993, that switches to heapsort when the recursion
+**  gets too deep, as in `Introspective Sorting and Selection Algorithms',
+**  David Musser, 1997)
+**
+** Elements are sorted in place in the array part of the table, which
+** always contains the whole 1..#t range because of the boundary invariant.
 */
 
-static void set2(lua_State* L, int i, int j)
+typedef int (*SortPredicate)(lua_State* L, const TValue* l, const TValue* r);
+
+static int sort_func(lua_State* L, const TValue* l, const TValue* r)
 {
-    lua_rawseti(L, 1, i);
-    lua_rawseti(L, 1, j);
+    LUAU_ASSERT(L->top == L->base + 2); // table, function
+
+    // the comparator is called in the same stack slots every time
+    setobj2s(L, L->top, &L->base[1]);
+    setobj2s(L, L->top + 1, l);
+    setobj2s(L, L->top + 2, r);
+    L->top += 3; // safe because of LUA_MINSTACK guarantee
+    luaD_call(L, L->top - 3, 1);
+    L->top -= 1; // maintain stack depth
+
+    return !l_isfalse(L->top);
 }
 
-static int sort_comp(lua_State* L, int a, int b)
+static int sort_number(lua_State* L, const TValue* l, const TValue* r)
 {
-    if (!lua_isnil(L, 2))
-    { // function?
-        int res;
-        lua_pushvalue(L, 2);
-        lua_pushvalue(L, a - 1); // -1 to compensate function
-        lua_pushvalue(L, b - 2); // -2 to compensate function and `a'
-        lua_call(L, 2, 1);
-        res = lua_toboolean(L, -1);
-        lua_pop(L, 1);
-        return res;
+    return nvalue(l) < nvalue(r);
+}
+
+static int sort_string(lua_State* L, const TValue* l, const TValue* r)
+{
+    return luaV_strcmp(tsvalue(l), tsvalue(r)) < 0;
+}
+
+inline void sort_swap(lua_State* L, Table* t, int i, int j)
+{
+    TValue* arr = t->array;
+    LUAU_ASSERT(unsigned(i) < unsigned(t->sizearray) && unsigned(j) < unsigned(t->sizearray));
+
+    // no barrier required because both elements are in the array before and after the swap
+    TValue temp;
+    setobj2s(L, &temp, &arr[i]);
+    setobj2t(L, &arr[i], &arr[j]);
+    setobj2t(L, &arr[j], &temp);
+}
+
+template<SortPredicate pred>
+inline int sort_less(lua_State* L, Table* t, int i, int j, int n)
+{
+    TValue* arr = t->array;
+    LUAU_ASSERT(unsigned(i) < unsigned(t->sizearray) && unsigned(j) < unsigned(t->sizearray));
+
+    int res = pred(L, &arr[i], &arr[j]);
+
+    // comparator or __lt metamethod may shrink the array part, after which the elements can't be accessed
+    if (pred != sort_number && pred != sort_string && t->sizearray < n)
+        luaL_error(L, "table modified during sorting");
+
+    return res;
+}
+
+template<SortPredicate pred>
+static void sort_siftheap(lua_State* L, Table* t, int l, int u, int root, int n)
+{
+    LUAU_ASSERT(l <= u);
+    int count = u - l + 1;
+
+    // process all elements with two children
+    while (root * 2 + 2 < count)
+    {
+        int left = root * 2 + 1, right = root * 2 + 2;
+        int next = root;
+        next = sort_less<pred>(L, t, l + next, l + left, n) ? left : next;
+        next = sort_less<pred>(L, t, l + next, l + right, n) ? right : next;
+
+        if (next == root)
+            break;
+
+        sort_swap(L, t, l + root, l + next);
+        root = next;
+    }
+
+    // process last element if it has just one child
+    int lastleft = root * 2 + 1;
+    if (lastleft == count - 1 && sort_less<pred>(L, t, l + root, l + lastleft, n))
+        sort_swap(L, t, l + root, l + lastleft);
+}
+
+template<SortPredicate pred>
+static void sort_heap(lua_State* L, Table* t, int l, int u, int n)
+{
+    LUAU_ASSERT(l <= u);
+    int count = u - l + 1;
+
+    for (int i = count / 2 - 1; i >= 0; --i)
+        sort_siftheap<pred>(L, t, l, u, i, n);
+
+    for (int i = count - 1; i > 0; --i)
+    {
+        sort_swap(L, t, l, l + i);
+        sort_siftheap<pred>(L, t, l, l + i - 1, 0, n);
     }
-    else // a < b?
-        return lua_lessthan(L, a, b);
 }
 
-static void auxsort(lua_State* L, int l, int u)
+// sorts range [l..u] (inclusive, 0-based) of the first n elements
+template<SortPredicate pred>
+static void sort_rec(lua_State* L, Table* t, int l, int u, int limit, int n)
 {
     while (l < u)
-    { // for tail recursion
-        int i, j;
+    {
+        // quicksort is going over the permitted n log n complexity, so we fall back to heapsort
+        if (limit == 0)
+            return sort_heap<pred>(L, t, l, u, n);
+
         // sort elements a[l], a[(l+u)/2] and a[u]
-        lua_rawgeti(L, 1, l);
-        lua_rawgeti(L, 1, u);
-        if (sort_comp(L, -1, -2)) // a[u] < a[l]?
-            set2(L, l, u);        // swap a[l] - a[u]
-        else
-            lua_pop(L, 2);
+        // note: this simultaneously acts as a small sort and a median selector
+        if (sort_less<pred>(L, t, u, l, n)) // a[u] < a[l]?
+            sort_swap(L, t, u, l);          // swap a[l] - a[u]
         if (u - l == 1)
-            break; // only 2 elements
-        i = (l + u) / 2;
-        lua_rawgeti(L, 1, i);
-        lua_rawgeti(L, 1, l);
-        if (sort_comp(L, -2, -1)) // a[i]<a[l]?
-            set2(L, i, l);
-        else
-        {
-            lua_pop(L, 1); // remove a[l]
-            lua_rawgeti(L, 1, u);
-            if (sort_comp(L, -1, -2)) // a[u]<a[i]?
-                set2(L, i, u);
-            else
-                lua_pop(L, 2);
-        }
+            break;                          // only 2 elements
+        int m = l + ((u - l) >> 1);         // midpoint
+        if (sort_less<pred>(L, t, m, l, n)) // a[m]<a[l]?
+            sort_swap(L, t, m, l);
+        else if (sort_less<pred>(L, t, u, m, n)) // a[u]<a[m]?
+            sort_swap(L, t, m, u);
         if (u - l == 2)
-            break;            // only 3 elements
-        lua_rawgeti(L, 1, i); // Pivot
-        lua_pushvalue(L, -1);
-        lua_rawgeti(L, 1, u - 1);
-        set2(L, i, u - 1);
+            break; // only 3 elements
+
+        // here l, m, u are ordered; m will become the new pivot
+        int p = u - 1;
+        sort_swap(L, t, m, u - 1); // pivot is now (and always) at u-1
+
         // a[l] <= P == a[u-1] <= a[u], only need to sort from l+1 to u-2
-        i = l;
-        j = u - 1;
+        int i = l;
+        int j = u - 1;
         for (;;)
         { // invariant: a[l..i] <= P <= a[j..u]
             // repeat ++i until a[i] >= P
-            while (lua_rawgeti(L, 1, ++i), sort_comp(L, -1, -2))
+            while (sort_less<pred>(L, t, ++i, p, n))
             {
                 if (i >= u)
                     luaL_error(L, "invalid order function for sorting");
-                lua_pop(L, 1); // remove a[i]
             }
             // repeat --j until a[j] <= P
-            while (lua_rawgeti(L, 1, --j), sort_comp(L, -3, -1))
+            while (sort_less<pred>(L, t, p, --j, n))
             {
                 if (j <= l)
                     luaL_error(L, "invalid order function for sorting");
-                lua_pop(L, 1); // remove a[j]
             }
             if (j < i)
-            {
-                lua_pop(L, 3); // pop pivot, a[i], a[j]
                 break;
-            }
-            set2(L, i, j);
+            sort_swap(L, t, i, j);
         }
-        lua_rawgeti(L, 1, u - 1);
-        lua_rawgeti(L, 1, i);
-        set2(L, u - 1, i); // swap pivot (a[u-1]) with a[i]
+
+        // swap pivot a[p] with a[i], which is the new midpoint
+        sort_swap(L, t, p, i);
+
+        // adjust limit to allow 1.5 log2N recursive steps
+        limit = (limit >> 1) + (limit >> 2);
+
         // a[l..i-1] <= a[i] == P <= a[i+1..u]
-        // adjust so that smaller half is in [j..i] and larger one in [l..u]
+        // sort smaller half recursively; the larger half is sorted in the next loop iteration
         if (i - l < u - i)
         {
-            j = l;
-            i = i - 1;
-            l = i + 2;
+            sort_rec<pred>(L, t, l, i - 1, limit, n);
+            l = i + 1;
         }
         else
         {
-            j = i + 1;
-            i = u;
-            u = j - 2;
+            sort_rec<pred>(L, t, i + 1, u, limit, n);
+            u = i - 1;
         }
-        auxsort(L, j, i); // call recursively the smaller one
-    }                     // repeat the routine for the larger one
+    }
+}
+
+// returns the type shared by all elements of the array, or LUA_TNONE
+static int sort_type(Table* t, int n)
+{
+    int tt = n > 0 ? ttype(&t->array[0]) : LUA_TNONE;
+
+    for (int i = 1; i < n; ++i)
+        if (ttype(&t->array[i]) != tt)
+            return LUA_TNONE;
+
+    return tt;
 }
 
 static int sort(lua_State* L)
 {
     luaL_checktype(L, 1, LUA_TTABLE);
-    int n = lua_objlen(L, 1);
-    luaL_checkstack(L, 40, ""); // assume array is smaller than 2^40
-    if (!lua_isnoneornil(L, 2)) // is there a 2nd argument?
+    Table* t = hvalue(L->base);
+    int n = luaH_getn(t);
+    if (t->readonly)
+        luaG_readonlyerror(L);
+    bool comparator = !lua_isnoneornil(L, 2); // is there a 2nd argument?
+    if (comparator)
         luaL_checktype(L, 2, LUA_TFUNCTION);
     lua_settop(L, 2); // make sure there is two arguments
-    auxsort(L, 1, n);
+
+    if (n < 2)
+        return 0;
+
+    LUAU_ASSERT(n <= t->sizearray);
+
+    if (comparator)
+        sort_rec<sort_func>(L, t, 0, n - 1, n, n);
+    else
+    {
+        // numbers and strings don't have comparison metamethods, so arrays of either can be compared directly
+        switch (sort_type(t, n))
+        {
+        case LUA_TNUMBER:
+            sort_rec<sort_number>(L, t, 0, n - 1, n, n);
+            break;
+        case LUA_TSTRING:
+            sort_rec<sort_string>(L, t, 0, n - 1, n, n);
+            break;
+        default:
+            sort_rec<luaV_lessthan>(L, t, 0, n - 1, n, n);
+        }
+    }
     return 0;
 }
 
@@ -448,6 +556,40 @@ static int tcreate(lua_State* L)
     return 1;
 }
 
+template<int tt>
+static bool tfind_match(const TValue* e, const TValue* v)
+{
+    switch (tt)
+    {
+    case LUA_TNUMBER:
+        return ttisnumber(e) && luai_numeq(nvalue(e), nvalue(v));
+    case LUA_TBOOLEAN:
+        return ttisboolean(e) && bvalue(e) == bvalue(v);
+    case LUA_TLIGHTUSERDATA:
+        return ttislightuserdata(e) && pvalue(e) == pvalue(v);
+    default:
+        return ttype(e) == tt && gcvalue(e) == gcvalue(v);
+    }
+}
+
+/*
+** table.find in the array part for values that are compared without metamethods;
+** returns the index of the first element in [i, n) that is nil or equal to `v', n if there is none
+*/
+template<int tt>
+static int tfind_array(const TValue* array, int i, int n, const TValue* v)
+{
+    for (; i < n; ++i)
+    {
+        const TValue* e = &array[i];
+
+        if (ttisnil(e) || tfind_match<tt>(e, v))
+            return i;
+    }
+
+    return n;
+}
+
 static int tfind(lua_State* L)
 {
     luaL_checktype(L, 1, LUA_TTABLE);
@@ -459,6 +601,42 @@ static int tfind(lua_State* L)
     Table* t = hvalue(L->base);
     StkId v = L->base + 1;
 
+    // values without __eq are compared directly in the array part; because of the boundary invariant, the search rarely continues past it
+    if (init <= t->sizearray)
+    {
+        int index = -1;
+
+        switch (ttype(v))
+        {
+        case LUA_TNUMBER:
+            index = tfind_array<LUA_TNUMBER>(t->array, init - 1, t->sizearray, v);
+            break;
+        case LUA_TBOOLEAN:
+            index = tfind_array<LUA_TBOOLEAN>(t->array, init - 1, t->sizearray, v);
+            break;
+        case LUA_TLIGHTUSERDATA:
+            index = tfind_array<LUA_TLIGHTUSERDATA>(t->array, init - 1, t->sizearray, v);
+            break;
+        case LUA_TSTRING:
+            index = tfind_array<LUA_TSTRING>(t->array, init - 1, t->sizearray, v);
+            break;
+        }
+
+        if (index >= 0)
+        {
+            if (index < t->sizearray)
+            {
+                if (ttisnil(&t->array[index]))
+                    lua_pushnil(L);
+                else
+                    lua_pushinteger(L, index + 1);
+                return 1;
+            }
+
+            init = t->sizearray + 1;
+        }
+    }
+
     for (int i = init;; ++i)
     {
         const TValue* e = luaH_getnum(t, i);
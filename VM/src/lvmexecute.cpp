@@ -80,6 +80,21 @@
         } \
     }
 
+#if LUA_CUSTOM_EXECUTION
+#define VM_LOOP() \
+    { \
+        void (*loop)(lua_State*, Proto*) = L->global->ecb.loop; \
+        if (LUAU_UNLIKELY(cl->l.p->execdata && loop)) \
+        { /* the loop callback can't raise errors or run Lua code, so the VM state doesn't need to be saved */ \
+            loop(L, cl->l.p); \
+        } \
+    }
+#else
+#define VM_LOOP() \
+    { \
+    }
+#endif
+
 
 #define VM_DISPATCH_OP(op) &&CASE_##op
 
@@ -465,7 +480,8 @@ reentry:
                         // fast-path: value is not in expected slot, but the table lookup doesn't involve metatable
                         const TValue* res = luaH_getstr(h, tsvalue(kv));
 
-                        if (res != luaO_nilobject)
+                        // while the hash part is being resized, res may be in the old node array which slot predictions don't cover
+                        if (res != luaO_nilobject && !h->migration)
                         {
                             int cachedslot = gval2slot(h, res);
                             // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
@@ -583,9 +599,12 @@ reentry:
                         VM_PROTECT_PC(); // set may fail
 
                         TValue* res = luaH_setstr(L, h, tsvalue(kv));
-                        int cachedslot = gval2slot(h, res);
-                        // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
-                        VM_PATCH_C(pc - 2, cachedslot);
+                        if (!h->migration)
+                        {
+                            int cachedslot = gval2slot(h, res);
+                            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                            VM_PATCH_C(pc - 2, cachedslot);
+                        }
                         setobj2t(L, res, ra);
                         luaC_barriert(L, h, ra);
                         VM_NEXT();
@@ -818,7 +837,8 @@ reentry:
                         setobj2s(L, ra, gval(n));
                     }
                     // fast-path: key is absent from the base, table has an __index table, and it has the result in the expected slot
-                    else if (gnext(n) == 0 && (mt = fasttm(L, hvalue(rb)->metatable, TM_INDEX)) && ttistable(mt) &&
+                    // note: tables that are being resized may have the key in the old hash part
+                    else if (gnext(n) == 0 && !h->migration && (mt = fasttm(L, hvalue(rb)->metatable, TM_INDEX)) && ttistable(mt) &&
                              (mtn = &hvalue(mt)->node[LUAU_INSN_C(insn) & hvalue(mt)->nodemask8]) && ttisstring(gkey(mtn)) &&
                              tsvalue(gkey(mtn)) == tsvalue(kv) && !ttisnil(gval(mtn)))
                     {
@@ -2140,6 +2160,7 @@ reentry:
             VM_CASE(LOP_FORNLOOP)
             {
                 VM_INTERRUPT();
+                VM_LOOP();
                 Instruction insn = *pc++;
                 StkId ra = VM_REG(LUAU_INSN_A(insn));
                 LUAU_ASSERT(ttisnumber(ra + 0) && ttisnumber(ra + 1) && ttisnumber(ra + 2));
@@ -2225,6 +2246,7 @@ reentry:
             VM_CASE(LOP_FORGLOOP)
             {
                 VM_INTERRUPT();
+                VM_LOOP();
                 Instruction insn = *pc++;
                 StkId ra = VM_REG(LUAU_INSN_A(insn));
                 uint32_t aux = *pc;
@@ -2271,6 +2293,10 @@ reentry:
                         index++;
                     }
 
+                    // nodes must not move while they are visited
+                    if (LUAU_UNLIKELY(h->migration != NULL))
+                        luaH_finishmigration(L, h);
+
                     int sizenode = 1 << h->lsizenode;
 
                     // then we advance index through the hash portion
@@ -2499,6 +2525,7 @@ reentry:
             VM_CASE(LOP_JUMPBACK)
             {
                 VM_INTERRUPT();
+                VM_LOOP();
                 Instruction insn = *pc++;
 
                 pc += LUAU_INSN_D(insn);
@@ -2520,6 +2547,11 @@ reentry:
             VM_CASE(LOP_JUMPX)
             {
                 VM_INTERRUPT();
+
+                // long forward jumps are emitted for large branches and don't indicate a loop
+                if (LUAU_INSN_E(*pc) < 0)
+                    VM_LOOP();
+
                 Instruction insn = *pc++;
 
                 pc += LUAU_INSN_E(insn);
@@ -105,7 +105,8 @@ void luaV_gettable(lua_State* L, const TValue* t, TValue* key, StkId val)
 
             const TValue* res = luaH_get(h, key); // do a primitive get
 
-            if (res != luaO_nilobject)
+            // while the hash part is being resized, res may be in the old node array which slot predictions don't cover
+            if (res != luaO_nilobject && !h->migration)
                 L->cachedslot = gval2slot(h, res); // remember slot to accelerate future lookups
 
             if (!ttisnil(res) // result is no nil?
@@ -150,7 +151,8 @@ void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val)
                 // luaH_set would work but would repeat the lookup so we use luaH_setslot that can reuse oldval if it's safe
                 TValue* newval = luaH_setslot(L, h, oldval, key);
 
-                L->cachedslot = gval2slot(h, newval); // remember slot to accelerate future lookups
+                if (!h->migration)
+                    L->cachedslot = gval2slot(h, newval); // remember slot to accelerate future lookups
 
                 setobj2t(L, newval, val);
                 luaC_barriert(L, h, val);
@@ -0,0 +1,19 @@
+local bench = script and require(script.Parent.bench_support) or require("bench_support")
+
+-- every key is a new string, so the time is dominated by hashing and interning it
+-- string table chain lengths for the same key sets are checked by the StringHashDistribution conformance test, scripts can't observe them
+local function run(format, count)
+    local t = {}
+
+    local ts0 = os.clock()
+    for i=1,count do
+        t[string.format(format, i % 1000, i)] = i
+    end
+    local ts1 = os.clock()
+
+    return ts1-ts0
+end
+
+bench.runCode(function() return run("field_%d_%d", 100000) end, "StringInterning: identifiers")
+bench.runCode(function() return run("data.items[%d].attributes[%d].name", 100000) end, "StringInterning: json paths")
+bench.runCode(function() return run("https://example.com/api/v1/resources/%d/details?id=%d&format=json&include=all", 100000) end, "StringInterning: urls")
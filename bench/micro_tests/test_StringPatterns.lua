@@ -0,0 +1,48 @@
+local bench = script and require(script.Parent.bench_support) or require("bench_support")
+
+local lines = {}
+for i = 1, 1000 do
+	lines[i] = string.format("2023-01-%02d 12:%02d:%02d [%s] request id=%d user=user%d path=/api/v1/items/%d status=%d time=%dms",
+		i % 28 + 1, i % 60, (i * 7) % 60, i % 10 == 0 and "ERROR" or "INFO", i, i % 97, i * 13, i % 10 == 0 and 500 or 200, i % 250)
+end
+local log = table.concat(lines, "\n")
+
+bench.runCode(function()
+	for iter = 1, 20 do
+		local count = 0
+		for key, value in log:gmatch("(%w+)=(%w+)") do
+			count += 1
+		end
+		assert(count == 4000)
+	end
+end, "StringPatterns: gmatch")
+
+bench.runCode(function()
+	for iter = 1, 20 do
+		local errors = 0
+		for _, line in lines do
+			if line:find("%[ERROR%]") then
+				errors += 1
+			end
+		end
+		assert(errors == 100)
+	end
+end, "StringPatterns: find")
+
+bench.runCode(function()
+	for iter = 1, 20 do
+		local total = 0
+		for _, line in lines do
+			local status, time = line:match("status=(%d+) time=(%d+)ms")
+			total += tonumber(time)
+		end
+		assert(total > 0)
+	end
+end, "StringPatterns: match")
+
+bench.runCode(function()
+	for iter = 1, 20 do
+		local result, count = log:gsub("user%d+", "user")
+		assert(count == 1000)
+	end
+end, "StringPatterns: gsub")
@@ -0,0 +1,25 @@
+local bench = script and require(script.Parent.bench_support) or require("bench_support")
+
+local rows = {}
+for i = 1, 20000 do
+	rows[i] = string.format("%d,user%d,%d.%02d,%s,2023-01-%02d", i, i % 997, i % 1000, i % 100, i % 3 == 0 and "active" or "inactive", i % 28 + 1)
+end
+local csv = table.concat(rows, "\n")
+
+bench.runCode(function()
+	for iter = 1, 5 do
+		local lines = csv:split("\n")
+		local fields = 0
+		for _, line in lines do
+			fields += #line:split(",")
+		end
+		assert(fields == 100000)
+	end
+end, "StringSplit: csv")
+
+bench.runCode(function()
+	for iter = 1, 5 do
+		local parts = csv:split(",")
+		assert(#parts == 80001)
+	end
+end, "StringSplit: large")
@@ -0,0 +1,22 @@
+local bench = script and require(script.Parent.bench_support) or require("bench_support")
+
+function test()
+
+    local t = {}
+    for i=1,10000 do t[i] = i end
+
+    local s = {}
+    for i=1,10000 do s[i] = tostring(i) end
+
+    local ts0 = os.clock()
+    for i=1,1000 do
+        table.find(t,9999)
+        table.find(s,"9999")
+        table.find(t,0)
+    end
+    local ts1 = os.clock()
+
+    return ts1-ts0
+end
+
+bench.runCode(test, "TableFind: table.find (large)")
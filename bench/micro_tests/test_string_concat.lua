@@ -0,0 +1,22 @@
+local bench = script and require(script.Parent.bench_support) or require("bench_support")
+
+bench.runCode(function()
+	for outer=1,10 do
+		local str = ""
+		for i=1,10000 do
+			str = str .. "line " .. i .. "\n"
+		end
+		assert(#str)
+	end
+end, "string: concat (append)")
+
+bench.runCode(function()
+	for outer=1,10 do
+		local t = {}
+		for i=1,10000 do
+			t[#t + 1] = "line " .. i .. "\n"
+		end
+		local str = table.concat(t)
+		assert(#str)
+	end
+end, "string: concat (table.concat)")
@@ -99,6 +99,10 @@ TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Binary")
     SINGLE_COMPARE(add(w3, w7, 78), 0x110138E3);
     SINGLE_COMPARE(sub(w3, w7, 78), 0x510138E3);
     SINGLE_COMPARE(cmp(w0, 42), 0x7100A81F);
+
+    // test
+    SINGLE_COMPARE(tst(x0, x1), 0xEA01001F);
+    SINGLE_COMPARE(tst(w0, w1), 0x6A01001F);
 }
 
 TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Loads")
@@ -119,6 +123,19 @@ TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Loads")
     SINGLE_COMPARE(ldrsh(x0, x1), 0x79800020);
     SINGLE_COMPARE(ldrsh(w0, x1), 0x79C00020);
     SINGLE_COMPARE(ldrsw(x0, x1), 0xB9800020);
+
+    // SIMD&FP loads
+    SINGLE_COMPARE(ldr(d0, x1), 0xFD400020);
+    SINGLE_COMPARE(ldr(d0, mem(x1, 8)), 0xFD400420);
+    SINGLE_COMPARE(ldr(d0, mem(x1, x2)), 0xFC626820);
+    SINGLE_COMPARE(ldr(q0, x1), 0x3DC00020);
+    SINGLE_COMPARE(ldr(q0, mem(x1, 16)), 0x3DC00420);
+    SINGLE_COMPARE(ldr(s0, mem(x1, 8)), 0xBD400820);
+
+    // paired loads
+    SINGLE_COMPARE(ldp(x0, x1, mem(sp, 16)), 0xA94107E0);
+    SINGLE_COMPARE(ldp(x29, x30, sp), 0xA9407BFD);
+    SINGLE_COMPARE(ldp(d0, d1, x2), 0x6D400440);
 }
 
 TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Stores")
@@ -134,6 +151,16 @@ TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Stores")
     SINGLE_COMPARE(str(w0, x1), 0xB9000020);
     SINGLE_COMPARE(strb(w0, x1), 0x39000020);
     SINGLE_COMPARE(strh(w0, x1), 0x79000020);
+
+    // SIMD&FP stores
+    SINGLE_COMPARE(str(d0, x1), 0xFD000020);
+    SINGLE_COMPARE(str(q0, x1), 0x3D800020);
+    SINGLE_COMPARE(str(q0, mem(x1, x2)), 0x3CA26820);
+    SINGLE_COMPARE(str(s0, mem(x1, 8)), 0xBD000820);
+
+    // paired stores
+    SINGLE_COMPARE(stp(x0, x1, mem(sp, 16)), 0xA90107E0);
+    SINGLE_COMPARE(stp(d0, d1, x2), 0x6D000440);
 }
 
 TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Moves")
@@ -145,6 +172,66 @@ TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Moves")
     SINGLE_COMPARE(movk(x0, 42, 16), 0xF2A00540);
 }
 
+TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "Conditionals")
+{
+    SINGLE_COMPARE(csel(x0, x1, x2, ConditionA64::Equal), 0x9A820020);
+    SINGLE_COMPARE(csel(w0, w1, w2, ConditionA64::NotEqual), 0x1A821020);
+    SINGLE_COMPARE(cset(w0, ConditionA64::Equal), 0x1A9F17E0);
+    SINGLE_COMPARE(cset(x0, ConditionA64::GreaterEqual), 0x9A9FB7E0);
+}
+
+TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "FPBasic")
+{
+    SINGLE_COMPARE(fmov(d0, d1), 0x1E604020);
+    SINGLE_COMPARE(fmov(d0, x1), 0x9E670020);
+    SINGLE_COMPARE(fmov(x0, d1), 0x9E660020);
+}
+
+TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "FPMath")
+{
+    SINGLE_COMPARE(fabs(d1, d2), 0x1E60C041);
+    SINGLE_COMPARE(fadd(d1, d2, d3), 0x1E632841);
+    SINGLE_COMPARE(fdiv(d1, d2, d3), 0x1E631841);
+    SINGLE_COMPARE(fmul(d1, d2, d3), 0x1E630841);
+    SINGLE_COMPARE(fneg(d1, d2), 0x1E614041);
+    SINGLE_COMPARE(fsqrt(d1, d2), 0x1E61C041);
+    SINGLE_COMPARE(fsub(d1, d2, d3), 0x1E633841);
+
+    SINGLE_COMPARE(fadd(q0, q1, q2), 0x4E22D420);
+    SINGLE_COMPARE(fdiv(q0, q1, q2), 0x6E22FC20);
+    SINGLE_COMPARE(fmul(q0, q1, q2), 0x6E22DC20);
+    SINGLE_COMPARE(fneg(q0, q1), 0x6EA0F820);
+    SINGLE_COMPARE(fsub(q0, q1, q2), 0x4EA2D420);
+
+    SINGLE_COMPARE(frinta(d1, d2), 0x1E664041);
+    SINGLE_COMPARE(frintm(d1, d2), 0x1E654041);
+    SINGLE_COMPARE(frintp(d1, d2), 0x1E64C041);
+
+    SINGLE_COMPARE(fcvtzs(w1, d2), 0x1E780041);
+    SINGLE_COMPARE(fcvtzs(x1, d2), 0x9E780041);
+    SINGLE_COMPARE(scvtf(d1, w2), 0x1E620041);
+    SINGLE_COMPARE(scvtf(d1, x2), 0x9E620041);
+
+    SINGLE_COMPARE(fcvt(d0, s1), 0x1E22C020);
+    SINGLE_COMPARE(fcvt(s0, d1), 0x1E624020);
+}
+
+TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "FPVectorElements")
+{
+    SINGLE_COMPARE(ins_4s(q0, w1, 3), 0x4E1C1C20);
+    SINGLE_COMPARE(ins_4s(q31, w2, 0), 0x4E041C5F);
+    SINGLE_COMPARE(dup_4s(q0, q1, 0), 0x4E040420);
+    SINGLE_COMPARE(dup_4s(q0, s1, 0), 0x4E040420);
+    SINGLE_COMPARE(dup_4s(q3, q4, 2), 0x4E140483);
+    SINGLE_COMPARE(mov(q0, q1), 0x4EA11C20);
+}
+
+TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "FPCompare")
+{
+    SINGLE_COMPARE(fcmp(d0, d1), 0x1E612000);
+    SINGLE_COMPARE(fcmpz(d1), 0x1E602028);
+}
+
 TEST_CASE_FIXTURE(AssemblyBuilderA64Fixture, "ControlFlow")
 {
     // Jump back
@@ -237,6 +324,16 @@ TEST_CASE("LogTest")
     build.movk(x1, 42, 16);
     build.cmp(x1, x2);
     build.blr(x0);
+    build.ldr(d1, mem(x2, 8));
+    build.fadd(d0, d1, d2);
+    build.fcmpz(d0);
+    build.stp(x29, x30, mem(sp, -16));
+    build.csel(x0, x1, x2, ConditionA64::Less);
+    build.cset(w0, ConditionA64::Equal);
+    build.fcvt(s1, d2);
+    build.ins_4s(q0, w1, 3);
+    build.dup_4s(q2, s1, 0);
+    build.mov(q1, q3);
 
     Label l;
     build.b(ConditionA64::Plus, l);
@@ -260,6 +357,16 @@ TEST_CASE("LogTest")
  movk        x1,#42 LSL #16
  cmp         x1,x2
  blr         x0
+ ldr         d1,[x2,#8]
+ fadd        d0,d1,d2
+ fcmp        d0,#0
+ stp         x29,x30,[sp,#-16]
+ csel        x0,x1,x2,lt
+ cset        w0,eq
+ fcvt        s1,d2
+ ins         v0.s[3],w1
+ dup         v2.4s,v1.s[0]
+ mov         v1.16b,v3.16b
  b.pl        .L1
  cbz         x7,.L1
 .L1:
@@ -440,11 +440,17 @@ TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "AVXBinaryInstructionForms")
     SINGLE_COMPARE(vsubsd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x2b, 0x5c, 0xc6);
     SINGLE_COMPARE(vmulsd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x2b, 0x59, 0xc6);
     SINGLE_COMPARE(vdivsd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x2b, 0x5e, 0xc6);
+    SINGLE_COMPARE(vsubps(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x28, 0x5c, 0xc6);
+    SINGLE_COMPARE(vmulps(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x28, 0x59, 0xc6);
+    SINGLE_COMPARE(vdivps(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x28, 0x5e, 0xc6);
 
     SINGLE_COMPARE(vorpd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x29, 0x56, 0xc6);
+    SINGLE_COMPARE(vorps(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x28, 0x56, 0xc6);
     SINGLE_COMPARE(vxorpd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x29, 0x57, 0xc6);
+    SINGLE_COMPARE(vxorps(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x28, 0x57, 0xc6);
 
     SINGLE_COMPARE(vandpd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x29, 0x54, 0xc6);
+    SINGLE_COMPARE(vandps(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x28, 0x54, 0xc6);
     SINGLE_COMPARE(vandnpd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x29, 0x55, 0xc6);
 
     SINGLE_COMPARE(vmaxsd(xmm8, xmm10, xmm14), 0xc4, 0x41, 0x2b, 0x5f, 0xc6);
@@ -506,6 +512,10 @@ TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "AVXConversionInstructionForms")
     SINGLE_COMPARE(vcvtsi2sd(xmm6, xmm11, dword[rcx + rdx]), 0xc4, 0xe1, 0x23, 0x2a, 0x34, 0x11);
     SINGLE_COMPARE(vcvtsi2sd(xmm5, xmm10, r13), 0xc4, 0xc1, 0xab, 0x2a, 0xed);
     SINGLE_COMPARE(vcvtsi2sd(xmm6, xmm11, qword[rcx + rdx]), 0xc4, 0xe1, 0xa3, 0x2a, 0x34, 0x11);
+    SINGLE_COMPARE(vcvtsd2ss(xmm5, xmm10, xmm11), 0xc4, 0xc1, 0x2b, 0x5a, 0xeb);
+    SINGLE_COMPARE(vcvtsd2ss(xmm6, xmm11, qword[rcx + rdx]), 0xc4, 0xe1, 0x23, 0x5a, 0x34, 0x11);
+    SINGLE_COMPARE(vcvtss2sd(xmm5, xmm10, xmm11), 0xc4, 0xc1, 0x2a, 0x5a, 0xeb);
+    SINGLE_COMPARE(vcvtss2sd(xmm6, xmm11, dword[rcx + rdx]), 0xc4, 0xe1, 0x22, 0x5a, 0x34, 0x11);
 }
 
 TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "AVXTernaryInstructionForms")
@@ -515,6 +525,11 @@ TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "AVXTernaryInstructionForms")
         vroundsd(xmm8, xmm13, xmmword[r13 + rdx], RoundingModeX64::RoundToPositiveInfinity), 0xc4, 0x43, 0x11, 0x0b, 0x44, 0x15, 0x00, 0x0a);
     SINGLE_COMPARE(vroundsd(xmm9, xmm14, xmmword[rcx + r10], RoundingModeX64::RoundToZero), 0xc4, 0x23, 0x09, 0x0b, 0x0c, 0x11, 0x0b);
     SINGLE_COMPARE(vblendvpd(xmm7, xmm12, xmmword[rcx + r10], xmm5), 0xc4, 0xa3, 0x19, 0x4b, 0x3c, 0x11, 0x50);
+
+    SINGLE_COMPARE(vpinsrd(xmm7, xmm12, r9d, 3), 0xc4, 0xc3, 0x19, 0x22, 0xf9, 0x03);
+    SINGLE_COMPARE(vpinsrd(xmm7, xmm12, dword[rcx + r10], 3), 0xc4, 0xa3, 0x19, 0x22, 0x3c, 0x11, 0x03);
+    SINGLE_COMPARE(vshufps(xmm7, xmm12, xmm3, 0), 0xc4, 0xe1, 0x18, 0xc6, 0xfb, 0x00);
+    SINGLE_COMPARE(vshufps(xmm8, xmm13, xmmword[r13 + rdx], 0x1b), 0xc4, 0x41, 0x10, 0xc6, 0x44, 0x15, 0x00, 0x1b);
 }
 
 TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "MiscInstructions")
@@ -656,6 +671,30 @@ TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "Constants")
     // clang-format on
 }
 
+TEST_CASE_FIXTURE(AssemblyBuilderX64Fixture, "VectorConstants")
+{
+    // clang-format off
+    CHECK(check(
+        [](AssemblyBuilderX64& build) {
+            build.vandps(xmm0, xmm1, build.u32x4(~0u, ~0u, ~0u, 0));
+            build.vpinsrd(xmm0, xmm0, build.i32(4), 3);
+            build.ret();
+        },
+        {
+            0xc4, 0xe1, 0x70, 0x54, 0x05, 0xe7, 0xff, 0xff, 0xff,
+            0xc4, 0xe3, 0x79, 0x22, 0x05, 0xd9, 0xff, 0xff, 0xff, 0x03,
+            0xc3
+        },
+        {
+            0x04, 0x00, 0x00, 0x00,
+            0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff,
+            0x00, 0x00, 0x00, 0x00,
+        }));
+    // clang-format on
+}
+
 TEST_CASE("ConstantStorage")
 {
     AssemblyBuilderX64 build(/* logText= */ false);
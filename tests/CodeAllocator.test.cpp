@@ -128,6 +128,110 @@ TEST_CASE("CodeAllocationWithUnwindCallbacks")
     CHECK(info.destroyCalled);
 }
 
+TEST_CASE("CodeAllocationReuse")
+{
+    struct Info
+    {
+        int created = 0;
+        int destroyed = 0;
+    };
+    Info info;
+
+    size_t blockSize = 1024 * 1024;
+    size_t maxTotalSize = 1024 * 1024;
+    CodeAllocator allocator(blockSize, maxTotalSize);
+
+    allocator.context = &info;
+    allocator.createBlockUnwindInfo = [](void* context, uint8_t* block, size_t blockSize, size_t& beginOffset) -> void* {
+        Info& info = *(Info*)context;
+        info.created++;
+
+        beginOffset = 8;
+        return &info;
+    };
+    allocator.destroyBlockUnwindInfo = [](void* context, void* unwindData) {
+        Info& info = *(Info*)context;
+        info.destroyed++;
+    };
+
+    std::vector<uint8_t> code;
+    code.resize(128);
+
+    uint8_t* nativeData1;
+    size_t sizeNativeData1;
+    uint8_t* nativeEntry1;
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData1, sizeNativeData1, nativeEntry1));
+
+    uint8_t* nativeData2;
+    size_t sizeNativeData2;
+    uint8_t* nativeEntry2;
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData2, sizeNativeData2, nativeEntry2));
+
+    uint8_t* nativeData3;
+    size_t sizeNativeData3;
+    uint8_t* nativeEntry3;
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData3, sizeNativeData3, nativeEntry3));
+
+    CHECK(info.created == 1);
+    CHECK(allocator.getFragmentedSize() == 0);
+    CHECK(allocator.getUsedSize() + allocator.getFreeSize() == blockSize);
+
+    size_t freeSize = allocator.getFreeSize();
+
+    // Space between allocations is fragmented until it's reused
+    allocator.deallocate(nativeData2, sizeNativeData2);
+    CHECK(allocator.getFreeSize() > freeSize);
+    CHECK(allocator.getFragmentedSize() == allocator.getFreeSize() - freeSize);
+
+    uint8_t* nativeData4;
+    size_t sizeNativeData4;
+    uint8_t* nativeEntry4;
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData4, sizeNativeData4, nativeEntry4));
+    CHECK(nativeData4 == nativeData2);
+    CHECK(allocator.getFragmentedSize() == 0);
+    CHECK(allocator.getFreeSize() == freeSize);
+
+    // First page of the block is shared with unwind information
+    allocator.deallocate(nativeData1, sizeNativeData1);
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData1, sizeNativeData1, nativeEntry1));
+    CHECK(nativeData1 == allocator.blocks[0].memory + kCodeAlignment);
+
+    // Block is released when the last allocation is returned
+    allocator.deallocate(nativeData3, sizeNativeData3);
+    allocator.deallocate(nativeData1, sizeNativeData1);
+    CHECK(info.destroyed == 0);
+    allocator.deallocate(nativeData4, sizeNativeData4);
+    CHECK(info.destroyed == 1);
+    CHECK(allocator.blocks.empty());
+    CHECK(allocator.getUsedSize() == 0);
+
+    // Unwind information is created again for a new block
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData1, sizeNativeData1, nativeEntry1));
+    CHECK(info.created == 2);
+}
+
+TEST_CASE("CodeAllocationReuseAfterFailure")
+{
+    size_t blockSize = 4096;
+    size_t maxTotalSize = 8192;
+    CodeAllocator allocator(blockSize, maxTotalSize);
+
+    uint8_t* nativeData[3];
+    size_t sizeNativeData[3];
+    uint8_t* nativeEntry;
+
+    std::vector<uint8_t> code;
+    code.resize(2000);
+
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData[0], sizeNativeData[0], nativeEntry));
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData[1], sizeNativeData[1], nativeEntry));
+    REQUIRE(!allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData[2], sizeNativeData[2], nativeEntry));
+
+    // Memory budget is returned when the block is released
+    allocator.deallocate(nativeData[0], sizeNativeData[0]);
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData[2], sizeNativeData[2], nativeEntry));
+}
+
 #if !defined(LUAU_BIG_ENDIAN)
 TEST_CASE("WindowsUnwindCodesX64")
 {
@@ -32,9 +32,10 @@ static lua_CompileOptions defaultOptions()
 
 static int lua_collectgarbage(lua_State* L)
 {
-    static const char* const opts[] = {"stop", "restart", "collect", "count", "isrunning", "step", "setgoal", "setstepmul", "setstepsize", nullptr};
-    static const int optsnum[] = {
-        LUA_GCSTOP, LUA_GCRESTART, LUA_GCCOLLECT, LUA_GCCOUNT, LUA_GCISRUNNING, LUA_GCSTEP, LUA_GCSETGOAL, LUA_GCSETSTEPMUL, LUA_GCSETSTEPSIZE};
+    static const char* const opts[] = {
+        "stop", "restart", "collect", "count", "isrunning", "step", "setgoal", "setstepmul", "setstepsize", "generational", "incremental", nullptr};
+    static const int optsnum[] = {LUA_GCSTOP, LUA_GCRESTART, LUA_GCCOLLECT, LUA_GCCOUNT, LUA_GCISRUNNING, LUA_GCSTEP, LUA_GCSETGOAL,
+        LUA_GCSETSTEPMUL, LUA_GCSETSTEPSIZE, LUA_GCGEN, LUA_GCINC};
 
     int o = luaL_checkoption(L, 1, "collect", opts);
     int ex = luaL_optinteger(L, 2, 0);
@@ -47,6 +48,12 @@ static int lua_collectgarbage(lua_State* L)
         lua_pushboolean(L, res);
         return 1;
     }
+    case LUA_GCGEN:
+    case LUA_GCINC:
+    {
+        lua_pushstring(L, res == LUA_GCGEN ? "generational" : "incremental");
+        return 1;
+    }
     default:
     {
         lua_pushnumber(L, res);
@@ -355,6 +362,152 @@ TEST_CASE("GC")
     runConformance("gc.lua");
 }
 
+TEST_CASE("GCGenerational")
+{
+    auto setup = [](lua_State* L) {
+        lua_gc(L, LUA_GCGEN, 0);
+    };
+
+    runConformance("gc.lua", setup);
+    runConformance("closure.lua", setup);
+    runConformance("coroutine.lua", setup);
+}
+
+TEST_CASE("GCDeferredSweep")
+{
+    runConformance("gc.lua", [](lua_State* L) {
+        lua_gc(L, LUA_GCDEFERSWEEP, 1);
+    });
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    CHECK(lua_gc(L, LUA_GCDEFERSWEEP, 1) == 0);
+
+    // without explicit steps, assists still keep the heap bounded
+    for (int i = 0; i < 100000; ++i)
+    {
+        lua_createtable(L, 16, 0);
+        lua_pop(L, 1);
+    }
+
+    CHECK(lua_gc(L, LUA_GCCOUNT, 0) < 4096);
+
+    // explicit steps finish the cycle
+    int steps = 0;
+    while (lua_gc(L, LUA_GCSTEP, 64) == 0 && steps < 1000)
+        steps++;
+
+    CHECK(steps < 1000);
+    CHECK(lua_gc(L, LUA_GCDEFERSWEEP, 0) == 1);
+}
+
+TEST_CASE("GCTimePacing")
+{
+    runConformance("gc.lua", [](lua_State* L) {
+        lua_gc(L, LUA_GCSETSTEPTIME, 100);
+        lua_gc(L, LUA_GCSETCPUFRACTION, 50);
+    });
+
+    static bool swept = false;
+
+    swept = false;
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    CHECK(lua_gc(L, LUA_GCSETSTEPTIME, 200) == 0);
+    CHECK(lua_gc(L, LUA_GCSETCPUFRACTION, 10) == 25);
+    CHECK(lua_gc(L, LUA_GCSETCPUFRACTION, 0) == 10);
+    CHECK(lua_gc(L, LUA_GCSETCPUFRACTION, 20) == 1);
+
+    // keep some live data around so that the cycles have work to pace
+    lua_createtable(L, 0, 0);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        lua_createtable(L, 16, 0);
+        lua_rawseti(L, -2, i + 1);
+    }
+
+    // full collection sets the heap goal (G = 200%) of the next cycle
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    int heapgoal = lua_gc(L, LUA_GCCOUNT, 0) * 2;
+
+    // unreachable object that is freed when the next cycle sweeps
+    lua_newuserdatadtor(L, 0, [](void*) {
+        swept = true;
+    });
+    lua_pop(L, 1);
+
+    // the longest steps the collector can be asked to take; time estimates can't delay a step past the goal, and once the heap is past
+    // the goal, steps do the work stepmul requires, which finishes the cycle before the heap outgrows the goal by another half of the live data
+    lua_gc(L, LUA_GCSETSTEPTIME, 1000000);
+    lua_gc(L, LUA_GCSETCPUFRACTION, 1);
+
+    int peak = 0;
+
+    for (int i = 0; i < 1000000 && !swept; ++i)
+    {
+        lua_createtable(L, 16, 0);
+        lua_pop(L, 1);
+
+        int count = lua_gc(L, LUA_GCCOUNT, 0);
+        peak = count > peak ? count : peak;
+    }
+
+    CHECK(swept);
+    CHECK(peak < heapgoal * 2);
+    CHECK(lua_objlen(L, -1) == 2000);
+
+    lua_pop(L, 1);
+    CHECK(lua_gc(L, LUA_GCSETSTEPTIME, 0) == 1000000);
+}
+
+TEST_CASE("GCPageCache")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_gc(L, LUA_GCSETPAGECACHE, 1000);
+
+    auto churn = [](lua_State* L) {
+        lua_createtable(L, 10000, 0);
+        for (int i = 1; i <= 10000; ++i)
+        {
+            lua_createtable(L, 4, 0);
+            lua_rawseti(L, -2, i);
+        }
+        lua_pop(L, 1);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    };
+
+    churn(L);
+
+    // pages freed by the collection are kept in the cache
+    int misses = lua_gc(L, LUA_GCPAGECACHEMISSES, 0);
+    CHECK(misses > 0);
+
+    int hits = lua_gc(L, LUA_GCPAGECACHEHITS, 0);
+
+    churn(L);
+
+    // and are reused by the next allocations
+    CHECK(lua_gc(L, LUA_GCPAGECACHEHITS, 0) > hits);
+    CHECK(lua_gc(L, LUA_GCPAGECACHEMISSES, 0) < misses * 2);
+
+    CHECK(lua_gc(L, LUA_GCTRIMPAGECACHE, 0) > 0);
+    CHECK(lua_gc(L, LUA_GCTRIMPAGECACHE, 0) == 0);
+
+    // with the cache disabled, pages are released right away
+    CHECK(lua_gc(L, LUA_GCSETPAGECACHE, 0) == 1000);
+
+    churn(L);
+
+    CHECK(lua_gc(L, LUA_GCTRIMPAGECACHE, 0) == 0);
+}
+
 TEST_CASE("Bitwise")
 {
     runConformance("bitwise.lua");
@@ -716,6 +869,91 @@ TEST_CASE("NDebugGetUpValue")
         nullptr, &copts, /* skipCodegen */ false);
 }
 
+TEST_CASE("StringHashDistribution")
+{
+    extern unsigned int luaS_hash(const char* str, size_t len); // internal function, declared in lstring.h - not exposed via lua.h
+
+    // string table chains for structured keys that only differ in a few bytes should stay close to the ones a random hash would produce
+    const char* formats[] = {
+        "field_%d_%d",
+        "data.items[%d].attributes[%d].name",
+        "https://example.com/api/v1/resources/%d/details?id=%d&format=json&include=all",
+    };
+
+    const int count = 1 << 16;
+
+    for (const char* format : formats)
+    {
+        std::vector<int> chains(count);
+        int longest = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            char key[128];
+            int len = snprintf(key, sizeof(key), format, i % 1000, i);
+
+            longest = std::max(longest, ++chains[luaS_hash(key, len) & (count - 1)]);
+        }
+
+        CHECK(longest <= 12);
+    }
+}
+
+TEST_CASE("StringTableResize")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // interned strings are found while the string table grows and its buckets are moved
+    lua_createtable(L, 0, 0);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        lua_pushfstring(L, "key%d", i);
+        lua_rawseti(L, -2, i + 1);
+
+        int j = i * 7 / 8;
+        lua_rawgeti(L, -1, j + 1);
+        const char* str = lua_pushfstring(L, "key%d", j);
+        CHECK(str == lua_tostring(L, -2));
+        lua_pop(L, 2);
+    }
+
+    // keep every 100th string alive while the collector shrinks the table
+    lua_createtable(L, 0, 0);
+
+    for (int i = 0; i < 100000; i += 100)
+    {
+        lua_rawgeti(L, -2, i + 1);
+        lua_rawseti(L, -2, i / 100 + 1);
+    }
+
+    lua_remove(L, -2);
+
+    for (int step = 0; step < 100; ++step)
+    {
+        lua_gc(L, LUA_GCSTEP, 64);
+
+        for (int i = 0; i < 100000; i += 10000)
+        {
+            lua_rawgeti(L, -1, i / 100 + 1);
+            const char* str = lua_pushfstring(L, "key%d", i);
+            CHECK(str == lua_tostring(L, -2));
+            lua_pop(L, 2);
+        }
+    }
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    for (int i = 0; i < 100000; i += 100)
+    {
+        lua_rawgeti(L, -1, i / 100 + 1);
+        const char* str = lua_pushfstring(L, "key%d", i);
+        CHECK(str == lua_tostring(L, -2));
+        lua_pop(L, 2);
+    }
+}
+
 TEST_CASE("SameHash")
 {
     extern unsigned int luaS_hash(const char* str, size_t len); // internal function, declared in lstring.h - not exposed via lua.h
@@ -732,6 +970,31 @@ TEST_CASE("SameHash")
     // Also hash should work on unaligned source data even when hashing long strings
     char buf[128] = {};
     CHECK(luaS_hash(buf + 1, 120) == luaS_hash(buf + 2, 120));
+
+#if LUA_WIDESTRINGHASH
+    // Wide hash is replicated completely, including the long string processing
+    const char* longkey = "luau.compiler.bytecode.builder.string.hash";
+    CHECK(luaS_hash(longkey, 42) == Luau::BytecodeBuilder::getStringHash({longkey, 42}));
+    CHECK(luaS_hash(longkey, 31) == Luau::BytecodeBuilder::getStringHash({longkey, 31}));
+    CHECK(luaS_hash(longkey, 7) == Luau::BytecodeBuilder::getStringHash({longkey, 7}));
+
+    // Every byte of long strings contributes to the hash
+    buf[100] = 1;
+    CHECK(luaS_hash(buf, 120) != luaS_hash(buf + 1, 120));
+#else
+    // Hashes of long strings determine the traversal order of tables with string keys, so they have to stay the same between releases
+    const char* longkey = "luau.compiler.bytecode.builder.string.hash";
+    CHECK(luaS_hash(longkey, 42) == 240682946);
+    CHECK(luaS_hash(longkey, 32) == 794341078);
+    CHECK(luaS_hash(longkey, 31) == 3243692732);
+
+    char alpha[200];
+    for (int i = 0; i < 200; ++i)
+        alpha[i] = char('a' + i % 26);
+
+    CHECK(luaS_hash(alpha, 100) == 2517528346);
+    CHECK(luaS_hash(alpha, 200) == 3249777666);
+#endif
 }
 
 TEST_CASE("Reference")
@@ -1223,6 +1486,99 @@ TEST_CASE("GCDump")
     fclose(f);
 }
 
+TEST_CASE("AllocationSampling")
+{
+    static size_t weight;
+    static size_t samples;
+    static size_t frees;
+    static size_t attributed;
+
+    weight = samples = frees = attributed = 0;
+
+    // sampling has to be transparent to the scripts
+    runConformance("gc.lua", [](lua_State* L) {
+        lua_callbacks(L)->allocsample = [](lua_State* L, void* block, size_t size, size_t w, int memcat) {
+            lua_Debug ar;
+            lua_getinfo(L, 0, "sn", &ar);
+        };
+
+        lua_setallocsampling(L, 1000);
+    });
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_Callbacks* cb = lua_callbacks(L);
+
+    cb->allocsample = [](lua_State* L, void* block, size_t size, size_t w, int memcat) {
+        CHECK(size <= w);
+
+        weight += w;
+        samples++;
+
+        lua_Debug ar;
+        if (lua_getinfo(L, 0, "sn", &ar) && ar.name && strcmp(ar.name, "fill") == 0)
+            attributed++;
+    };
+
+    cb->freesample = [](lua_State* L, void* block, size_t size, int memcat) {
+        frees++;
+    };
+
+    const char* source = R"(
+        local function fill(n)
+            local t = {}
+            for i = 1, n do
+                t[i] = { i }
+            end
+            return t
+        end
+
+        return fill(20000)
+    )";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=AllocationSampling", bytecode, bytecodeSize, 0);
+    free(bytecode);
+
+    REQUIRE(result == 0);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    lua_setallocsampling(L, 4096);
+
+    size_t before = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+
+    lua_gc(L, LUA_GCSTOP, 0);
+    lua_call(L, 0, 1);
+
+    size_t after = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+
+    // every allocated byte is attributed to one sample; growth of the result table is counted but isn't sampled itself
+    CHECK(samples > 0);
+    CHECK(weight <= (after - before) * 2);
+    CHECK(weight + 4096 >= after - before);
+    CHECK(attributed * 2 > samples);
+    CHECK(frees == 0);
+
+    // samples are released when the objects die
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCRESTART, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(frees * 2 > samples);
+
+    // disabling the sampling forgets the remaining blocks
+    size_t freesbefore = frees;
+
+    lua_setallocsampling(L, 0);
+    lua_createtable(L, 1000, 0);
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(frees == freesbefore);
+}
+
 TEST_CASE("Interrupt")
 {
     lua_CompileOptions copts = defaultOptions();
@@ -1622,4 +1978,288 @@ TEST_CASE("HugeFunction")
     CHECK(lua_tonumber(L, -1) == 42);
 }
 
+TEST_CASE("TieredCompilation")
+{
+    StateRef globalState = runConformance("calls.lua", [](lua_State* L) {
+        Luau::CodeGen::TieringOptions options = Luau::CodeGen::getTieringOptions(L);
+        options.enabled = true;
+        options.callThreshold = 2;
+        options.loopThreshold = 16;
+        Luau::CodeGen::setTieringOptions(L, options);
+    });
+
+    if (codegen && Luau::CodeGen::isSupported())
+    {
+        Luau::CodeGen::TieringStats stats = Luau::CodeGen::getTieringStats(globalState.get());
+
+        // Functions are only compiled once they get hot, and the ones that never do stay in the interpreter
+        CHECK(stats.compiledFunctions == 0);
+        CHECK(stats.tieredFunctions > 0);
+        CHECK(stats.profiledFunctions > 0);
+        CHECK(stats.profiledCalls > 0);
+        CHECK(stats.profiledLoopIterations > 0);
+        CHECK(stats.failedFunctions == 0);
+    }
+}
+
+TEST_CASE("TieredCompilationInlinedCalls")
+{
+    if (!codegen || !Luau::CodeGen::isSupported())
+        return;
+
+    std::string source = R"(
+        local function lerp(a, b, t) return a + (b - a) * t end
+        local function first(t) return t[1] end
+        local function pair(x) return x, -x end
+
+        local function run(n, f)
+            local s = 0
+            for i = 1, n do
+                s += lerp(0, 10, i / n)
+                s += first({i})
+                local a, b = pair(i)
+                s += a + b + f(i)
+            end
+            return s
+        end
+
+        local function mix(a) return lerp(a, 1, 0.5) end
+        local function wrap(t) return first(t) end
+
+        local sum = 0
+
+        for i = 1, 50 do
+            sum += run(10, function(x) return x * 2 end)
+            sum += mix(i) + wrap({i})
+        end
+
+        -- Inlined code checks the called closure and the arguments, and performs the call when they don't match
+        sum += run(10, function(x) return x * 3 end)
+        sum += wrap(setmetatable({}, {__index = function() return 1000 end}))
+        assert(not pcall(mix, "a"))
+        assert(not pcall(wrap, 1))
+
+        return sum
+    )";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    Luau::CodeGen::create(L);
+
+    Luau::CodeGen::TieringOptions options = Luau::CodeGen::getTieringOptions(L);
+    options.enabled = true;
+    Luau::CodeGen::setTieringOptions(L, options);
+
+    luaL_openlibs(L);
+
+    // Functions that were inlined are destroyed together with the functions that inlined them and in any order
+    for (int i = 0; i < 10; i++)
+    {
+        REQUIRE(luau_load(L, "=TieredCompilationInlinedCalls", bytecode, bytecodeSize, 0) == 0);
+
+        Luau::CodeGen::compile(L, -1);
+
+        REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+        CHECK(lua_tonumber(L, -1) == 14212.5);
+        lua_pop(L, 1);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
+    free(bytecode);
+
+    Luau::CodeGen::TieringStats stats = Luau::CodeGen::getTieringStats(L);
+    CHECK(stats.tieredFunctions > 0);
+    CHECK(stats.inlinedCalls > 0);
+}
+
+TEST_CASE("TieredCompilationInlinedAccessors")
+{
+    if (!codegen || !Luau::CodeGen::isSupported())
+        return;
+
+    std::string source = R"(
+        local Point = {}
+        Point.__index = Point
+
+        function Point.new(x, y) return setmetatable({x = x, y = y}, Point) end
+        function Point:getY() return self.y end
+        function Point:getZ() return self.z end
+
+        local function getX(p) return p.x end
+
+        local function run(p)
+            return getX(p) + p:getY() + p:getZ()
+        end
+
+        Point.z = 100
+
+        local sum = 0
+
+        for i = 1, 50 do
+            sum += run(Point.new(i, 2 * i))
+        end
+
+        -- Lookups that need a metamethod or fail perform the original call
+        sum += run(setmetatable({}, {__index = function(t, k) return Point[k] or 1000 end}))
+        assert(not pcall(run, setmetatable({}, Point)))
+
+        return sum
+    )";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    Luau::CodeGen::create(L);
+
+    Luau::CodeGen::TieringOptions options = Luau::CodeGen::getTieringOptions(L);
+    options.enabled = true;
+    Luau::CodeGen::setTieringOptions(L, options);
+
+    luaL_openlibs(L);
+
+    REQUIRE(luau_load(L, "=TieredCompilationInlinedAccessors", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    Luau::CodeGen::compile(L, -1);
+
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(lua_tonumber(L, -1) == 3 * 1275 + 50 * 100 + 2100);
+    lua_pop(L, 1);
+
+    // All three calls of 'run' read a field of their argument and are inlined
+    Luau::CodeGen::TieringStats stats = Luau::CodeGen::getTieringStats(L);
+    CHECK(stats.inlinedCalls == 3);
+}
+
+TEST_CASE("NativeCodeMemoryReuse")
+{
+    if (!codegen || !Luau::CodeGen::isSupported())
+        return;
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    Luau::CodeGen::create(L);
+
+    luaL_openlibs(L);
+
+    Luau::CodeGen::CodeMemoryStats initial = Luau::CodeGen::getCodeMemoryStats(L);
+
+    // Scripts that are loaded again and again shouldn't grow executable memory use
+    for (int i = 0; i < 100; i++)
+    {
+        std::string source = "local t = {} for i = 1, 10 do t[i] = i * " + std::to_string(i) + " end return t[10]";
+
+        size_t bytecodeSize = 0;
+        char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+        REQUIRE(luau_load(L, "=NativeCodeMemoryReuse", bytecode, bytecodeSize, 0) == 0);
+        free(bytecode);
+
+        Luau::CodeGen::compile(L, -1);
+
+        REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+        CHECK(lua_tonumber(L, -1) == 10 * i);
+        lua_pop(L, 1);
+
+        if (i % 10 == 9)
+            lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
+    Luau::CodeGen::CodeMemoryStats stats = Luau::CodeGen::getCodeMemoryStats(L);
+    CHECK(stats.totalSize == initial.totalSize);
+    CHECK(stats.usedSize == initial.usedSize);
+    CHECK(stats.usedSize + stats.freeSize <= stats.totalSize);
+
+    CHECK(Luau::CodeGen::getTieringStats(L).compiledFunctions == 100);
+    CHECK(Luau::CodeGen::getTieringStats(L).nativeCodeSize == 0);
+}
+
+TEST_CASE("SerializedNativeCode")
+{
+    if (!codegen || !Luau::CodeGen::isSupported())
+        return;
+
+    std::string source = R"(
+        local Point = {}
+        Point.__index = Point
+
+        function Point.new(x, y) return setmetatable({x = x, y = y}, Point) end
+        function Point:len() return math.sqrt(self.x * self.x + self.y * self.y) end
+
+        local sum = 0
+        for i = 1, 100 do
+            sum += Point.new(3 * i, 4 * i):len()
+        end
+        return sum
+    )";
+
+    size_t bytecodeSize = 0;
+    char* bytecodeData = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+    std::string bytecode(bytecodeData, bytecodeSize);
+    free(bytecodeData);
+
+    auto loadState = [](const std::string& bytecode) {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        Luau::CodeGen::create(L);
+
+        luaL_openlibs(L);
+        luaL_sandbox(L);
+        luaL_sandboxthread(L);
+
+        REQUIRE(luau_load(L, "=SerializedNativeCode", bytecode.data(), bytecode.size(), 0) == 0);
+        return globalState;
+    };
+
+    std::string serialized;
+
+    {
+        StateRef globalState = loadState(bytecode);
+        serialized = Luau::CodeGen::compileSerialized(globalState.get(), -1);
+
+        CHECK(Luau::CodeGen::getTieringStats(globalState.get()).compiledFunctions > 0);
+    }
+
+    REQUIRE(!serialized.empty());
+
+    // Code can't be used with different bytecode or when it's damaged
+    {
+        std::string other = "return 1";
+        char* otherData = luau_compile(other.data(), other.size(), nullptr, &bytecodeSize);
+        std::string otherBytecode(otherData, bytecodeSize);
+        free(otherData);
+
+        StateRef globalState = loadState(otherBytecode);
+        CHECK(!Luau::CodeGen::loadSerialized(globalState.get(), -1, serialized.data(), serialized.size()));
+        CHECK(!Luau::CodeGen::loadSerialized(globalState.get(), -1, serialized.data(), serialized.size() / 2));
+    }
+
+    StateRef globalState = loadState(bytecode);
+    lua_State* L = globalState.get();
+
+    REQUIRE(Luau::CodeGen::loadSerialized(L, -1, serialized.data(), serialized.size()));
+
+    Luau::CodeGen::TieringStats stats = Luau::CodeGen::getTieringStats(L);
+    CHECK(stats.loadedFunctions > 0);
+    CHECK(stats.compiledFunctions == 0);
+
+    // Functions that were loaded are skipped by the compiler
+    Luau::CodeGen::compile(L, -1);
+    CHECK(Luau::CodeGen::getTieringStats(L).compiledFunctions == 0);
+
+    int status = lua_resume(L, nullptr, 0);
+    REQUIRE(status == 0);
+
+    CHECK(lua_tonumber(L, -1) == 25250);
+}
+
 TEST_SUITE_END();
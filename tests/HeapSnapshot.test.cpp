@@ -0,0 +1,245 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+
+#include "HeapSnapshot.h"
+
+#include "doctest.h"
+
+#include <memory>
+#include <string>
+
+#include <string.h>
+
+static HeapSnapshot makeSnapshot(size_t count, std::vector<std::vector<uint32_t>> references)
+{
+    HeapSnapshot snapshot;
+    snapshot.strings.push_back("");
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        snapshot.addresses.push_back(0x1000 + i * 16);
+        snapshot.sizes.push_back(1);
+        snapshot.types.push_back(LUA_TTABLE);
+        snapshot.categories.push_back(0);
+        snapshot.names.push_back(0);
+        snapshot.edgeoffsets.push_back(uint32_t(snapshot.edges.size()));
+
+        if (i < references.size())
+            snapshot.edges.insert(snapshot.edges.end(), references[i].begin(), references[i].end());
+    }
+
+    snapshot.edgeoffsets.push_back(uint32_t(snapshot.edges.size()));
+    snapshot.edgenames.resize(snapshot.edges.size());
+    return snapshot;
+}
+
+static uint32_t findObject(const HeapSnapshot& snapshot, const void* ptr)
+{
+    for (size_t i = 0; i < snapshot.size(); ++i)
+        if (snapshot.addresses[i] == uintptr_t(ptr))
+            return uint32_t(i);
+
+    return HeapDominators::kRoot;
+}
+
+static std::string report(const HeapSnapshot& snapshot, const HeapSnapshot* old)
+{
+    HeapDominators dominators = heapSnapshotDominators(snapshot);
+
+    FILE* f = tmpfile();
+    REQUIRE(f);
+
+    heapSnapshotReport(f, snapshot, dominators, old, 10);
+
+    std::string result(size_t(ftell(f)), '\0');
+    rewind(f);
+    CHECK(fread(&result[0], 1, result.size(), f) == result.size());
+    fclose(f);
+
+    return result;
+}
+
+TEST_SUITE_BEGIN("HeapSnapshot");
+
+TEST_CASE("Dominators")
+{
+    // 0 -> 1, 2; 1 -> 3; 2 -> 3; 3 -> 4; 4 -> 1; 5 is not reachable from 0 and holds 6
+    HeapSnapshot snapshot = makeSnapshot(7, {{1, 2}, {3}, {3}, {4}, {1}, {6}});
+
+    HeapDominators dominators = heapSnapshotDominators(snapshot);
+
+    CHECK(dominators.idom[0] == HeapDominators::kRoot);
+    CHECK(dominators.idom[1] == 0);
+    CHECK(dominators.idom[2] == 0);
+    CHECK(dominators.idom[3] == 0);
+    CHECK(dominators.idom[4] == 3);
+    CHECK(dominators.idom[5] == HeapDominators::kRoot);
+    CHECK(dominators.idom[6] == 5);
+
+    CHECK(dominators.retained[0] == 5);
+    CHECK(dominators.retained[3] == 2);
+    CHECK(dominators.retained[4] == 1);
+    CHECK(dominators.retained[5] == 2);
+}
+
+TEST_CASE("DominatorsLongChain")
+{
+    // deep chains must not exhaust the native stack
+    const size_t count = 1000000;
+
+    std::vector<std::vector<uint32_t>> references(count);
+    for (size_t i = 0; i + 1 < count; ++i)
+        references[i].push_back(uint32_t(i + 1));
+
+    HeapSnapshot snapshot = makeSnapshot(count, references);
+
+    HeapDominators dominators = heapSnapshotDominators(snapshot);
+
+    CHECK(dominators.idom[count - 1] == count - 2);
+    CHECK(dominators.retained[0] == count);
+}
+
+TEST_CASE("CaptureAndDiff")
+{
+    std::unique_ptr<lua_State, void (*)(lua_State*)> globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_createtable(L, 0, 0);
+    const void* holder = lua_topointer(L, -1);
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        lua_createtable(L, 4, 0);
+        lua_rawseti(L, -2, i);
+    }
+
+    lua_setglobal(L, "holder");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    HeapSnapshot before;
+    heapSnapshotCapture(L, before);
+
+    uint32_t object = findObject(before, holder);
+    REQUIRE(object != HeapDominators::kRoot);
+    CHECK(before.types[object] == LUA_TTABLE);
+
+    HeapDominators dominators = heapSnapshotDominators(before);
+
+    size_t children = 0;
+
+    for (uint32_t e = before.edgeoffsets[object]; e < before.edgeoffsets[object + 1]; ++e)
+    {
+        CHECK(dominators.idom[before.edges[e]] == object);
+        children++;
+    }
+
+    CHECK(children == 100);
+    CHECK(dominators.retained[object] > before.sizes[object] + 100 * sizeof(void*));
+
+    // references keep the name of the field they are stored in
+    uint32_t globals = before.edges[before.edgeoffsets[0]];
+    REQUIRE(before.edgename(globals, object));
+    CHECK(before.edgename(globals, object) == std::string("holder"));
+
+    // snapshot survives a round trip through a file
+    FILE* f = tmpfile();
+    REQUIRE(f);
+    REQUIRE(heapSnapshotSave(before, f));
+    rewind(f);
+
+    HeapSnapshot loaded;
+    REQUIRE(heapSnapshotLoad(loaded, f));
+    fclose(f);
+
+    CHECK(loaded.addresses == before.addresses);
+    CHECK(loaded.sizes == before.sizes);
+    CHECK(loaded.edges == before.edges);
+    CHECK(loaded.edgenames == before.edgenames);
+    CHECK(loaded.strings == before.strings);
+
+    // growth is attributed to the table that existed in the first snapshot, and to the field of that table that holds most of it
+    lua_getglobal(L, "holder");
+
+    for (int i = 101; i <= 200; ++i)
+    {
+        lua_createtable(L, 4, 0);
+        lua_rawseti(L, -2, i);
+    }
+
+    lua_createtable(L, 0, 0);
+
+    for (int i = 1; i <= 1000; ++i)
+    {
+        lua_createtable(L, 4, 0);
+        lua_rawseti(L, -2, i);
+    }
+
+    lua_setfield(L, -2, "cache");
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    HeapSnapshot after;
+    heapSnapshotCapture(L, after);
+
+    std::string result = report(after, &before);
+
+    char address[32];
+    snprintf(address, sizeof(address), "table 0x%llx", (unsigned long long)uintptr_t(holder));
+
+    size_t growth = result.find("Largest growth retained by old objects:\n");
+    REQUIRE(growth != std::string::npos);
+    CHECK(result.find(address, growth) != std::string::npos);
+    CHECK(result.find("bytes through 'cache' -> table", growth) != std::string::npos);
+}
+
+TEST_CASE("LoadRejectsInvalidData")
+{
+    FILE* f = tmpfile();
+    REQUIRE(f);
+    fputs("not a snapshot", f);
+    rewind(f);
+
+    HeapSnapshot snapshot;
+    CHECK(!heapSnapshotLoad(snapshot, f));
+    fclose(f);
+
+    // element counts are checked against the file size before the arrays are allocated
+    f = tmpfile();
+    REQUIRE(f);
+
+    HeapSnapshot small = makeSnapshot(4, {{1, 2}, {3}});
+    REQUIRE(heapSnapshotSave(small, f));
+
+    long size = ftell(f);
+    rewind(f);
+
+    std::string data(size_t(size), '\0');
+    REQUIRE(fread(&data[0], 1, data.size(), f) == data.size());
+    fclose(f);
+
+    auto load = [](const std::string& data) {
+        FILE* f = tmpfile();
+        REQUIRE(f);
+        REQUIRE(fwrite(data.data(), 1, data.size(), f) == data.size());
+        rewind(f);
+
+        HeapSnapshot snapshot;
+        bool result = heapSnapshotLoad(snapshot, f);
+        fclose(f);
+        return result;
+    };
+
+    CHECK(load(data));
+
+    for (size_t length = 0; length < data.size(); ++length)
+        CHECK(!load(data.substr(0, length)));
+
+    // the first array count follows the 8-byte magic and the 4-byte version
+    std::string corrupt = data;
+    uint64_t count = uint64_t(1) << 40;
+    memcpy(&corrupt[12], &count, sizeof(count));
+    CHECK(!load(corrupt));
+}
+
+TEST_SUITE_END();
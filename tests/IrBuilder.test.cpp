@@ -5,6 +5,7 @@
 #include "Luau/IrUtils.h"
 #include "Luau/OptimizeConstProp.h"
 #include "Luau/OptimizeFinalX64.h"
+#include "Luau/OptimizeLoops.h"
 
 #include "doctest.h"
 
@@ -86,6 +87,7 @@ public:
     static const int tnil = 0;
     static const int tboolean = 1;
     static const int tnumber = 3;
+    static const int ttable = 6;
 };
 
 TEST_SUITE_BEGIN("Optimization");
@@ -565,7 +567,7 @@ TEST_CASE_FIXTURE(IrBuilderFixture, "RememberTagsAndValues")
     build.inst(IrCmd::STORE_INT, build.vmReg(1), build.inst(IrCmd::LOAD_INT, build.vmReg(7)));
     build.inst(IrCmd::STORE_DOUBLE, build.vmReg(2), build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(8)));
 
-    // So now the constant stores have to be made
+    // So now the stores have to be made, but numeric values that were just stored are forwarded without a reload
     build.inst(IrCmd::STORE_TAG, build.vmReg(9), build.inst(IrCmd::LOAD_TAG, build.vmReg(0)));
     build.inst(IrCmd::STORE_INT, build.vmReg(10), build.inst(IrCmd::LOAD_INT, build.vmReg(1)));
     build.inst(IrCmd::STORE_DOUBLE, build.vmReg(11), build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(2)));
@@ -591,10 +593,8 @@ bb_0:
    STORE_DOUBLE R2, %16
    %18 = LOAD_TAG R0
    STORE_TAG R9, %18
-   %20 = LOAD_INT R1
-   STORE_INT R10, %20
-   %22 = LOAD_DOUBLE R2
-   STORE_DOUBLE R11, %22
+   STORE_INT R10, %14
+   STORE_DOUBLE R11, %16
    LOP_RETURN 0u
 
 )");
@@ -634,6 +634,39 @@ bb_0:
 )");
 }
 
+TEST_CASE_FIXTURE(IrBuilderFixture, "ForwardNumericValues")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(block);
+
+    IrOp sum = build.inst(IrCmd::ADD_NUM, build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(0)), build.constDouble(1.0));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), sum);
+
+    // Value that was just stored doesn't have to be loaded back from memory
+    IrOp mul = build.inst(IrCmd::MUL_NUM, build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1)), build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(0)));
+
+    // Storing the same value again has no effect
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), sum);
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(2), mul);
+
+    build.inst(IrCmd::LOP_RETURN, build.constUint(0));
+
+    updateUseCounts(build.function);
+    constPropInBlockChains(build);
+
+    CHECK("\n" + toString(build.function, /* includeDetails */ false) == R"(
+bb_0:
+   %0 = LOAD_DOUBLE R0
+   %1 = ADD_NUM %0, 1
+   STORE_DOUBLE R1, %1
+   %5 = MUL_NUM %1, %0
+   STORE_DOUBLE R2, %5
+   LOP_RETURN 0u
+
+)");
+}
+
 TEST_CASE_FIXTURE(IrBuilderFixture, "SkipCheckTag")
 {
     IrOp block = build.block(IrBlockKind::Internal);
@@ -767,7 +800,7 @@ TEST_CASE_FIXTURE(IrBuilderFixture, "ConcatInvalidation")
     build.inst(IrCmd::STORE_INT, build.vmReg(1), build.constInt(10));
     build.inst(IrCmd::STORE_DOUBLE, build.vmReg(2), build.constDouble(0.5));
 
-    build.inst(IrCmd::CONCAT, build.vmReg(0), build.vmReg(3)); // Concat invalidates more than the target register
+    build.inst(IrCmd::CONCAT, build.vmReg(0), build.constUint(3)); // Concat invalidates more than the target register
 
     build.inst(IrCmd::STORE_TAG, build.vmReg(3), build.inst(IrCmd::LOAD_TAG, build.vmReg(0)));
     build.inst(IrCmd::STORE_INT, build.vmReg(4), build.inst(IrCmd::LOAD_INT, build.vmReg(1)));
@@ -783,7 +816,7 @@ bb_0:
    STORE_TAG R0, tnumber
    STORE_INT R1, 10i
    STORE_DOUBLE R2, 0.5
-   CONCAT R0, R3
+   CONCAT R0, 3u
    %4 = LOAD_TAG R0
    STORE_TAG R3, %4
    %6 = LOAD_INT R1
@@ -1194,4 +1227,319 @@ bb_2:
 )");
 }
 
+TEST_CASE_FIXTURE(IrBuilderFixture, "LoopCarriedTagCheckRemoval")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp loop = build.block(IrBlockKind::Internal);
+    IrOp exit = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.beginBlock(entry);
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(0), build.constDouble(0.0));
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(tnumber));
+    build.inst(IrCmd::JUMP, loop);
+
+    // Value of R0 changes on every iteration, but its tag doesn't
+    build.beginBlock(loop);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(tnumber), fallback);
+    IrOp sum = build.inst(IrCmd::ADD_NUM, build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(0)), build.constDouble(1.0));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(0), sum);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(tnumber));
+    build.inst(IrCmd::JUMP_CMP_NUM, sum, build.constDouble(10.0), build.cond(IrCondition::Less), loop, exit);
+
+    build.beginBlock(exit);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(0));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(1));
+
+    updateUseCounts(build.function);
+    constPropInFunction(build);
+
+    CHECK("\n" + toString(build.function, /* includeDetails */ false) == R"(
+bb_0:
+   STORE_DOUBLE R0, 0
+   STORE_TAG R0, tnumber
+   JUMP bb_1
+
+bb_1:
+   %5 = LOAD_DOUBLE R0
+   %6 = ADD_NUM %5, 1
+   STORE_DOUBLE R0, %6
+   JUMP_CMP_NUM %6, 10, lt, bb_1, bb_2
+
+bb_2:
+   LOP_RETURN 0u
+
+)");
+}
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "LoopTagCheckKeptWhenBackEdgeChangesTag")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp loop = build.block(IrBlockKind::Internal);
+    IrOp exit = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.beginBlock(entry);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(tnumber));
+    build.inst(IrCmd::JUMP, loop);
+
+    // Tag of R0 is only known on the first iteration
+    build.beginBlock(loop);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(tnumber), fallback);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.inst(IrCmd::LOAD_TAG, build.vmReg(1)));
+    build.inst(IrCmd::JUMP_EQ_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(2)), build.constTag(tnil), loop, exit);
+
+    build.beginBlock(exit);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(0));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(1));
+
+    updateUseCounts(build.function);
+    constPropInFunction(build);
+
+    CHECK("\n" + toString(build.function, /* includeDetails */ false) == R"(
+bb_0:
+   STORE_TAG R0, tnumber
+   JUMP bb_1
+
+bb_1:
+   %2 = LOAD_TAG R0
+   CHECK_TAG %2, tnumber, bb_fallback_3
+   %4 = LOAD_TAG R1
+   STORE_TAG R0, %4
+   %6 = LOAD_TAG R2
+   JUMP_EQ_TAG %6, tnil, bb_1, bb_2
+
+bb_2:
+   LOP_RETURN 0u
+
+bb_fallback_3:
+   LOP_RETURN 1u
+
+)");
+}
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "MergeKeepsFactsCommonToAllPredecessors")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp left = build.block(IrBlockKind::Internal);
+    IrOp right = build.block(IrBlockKind::Internal);
+    IrOp join = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.beginBlock(entry);
+    build.inst(IrCmd::JUMP_EQ_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(2)), build.constTag(tnil), left, right);
+
+    build.beginBlock(left);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(tnumber));
+    build.inst(IrCmd::STORE_TAG, build.vmReg(1), build.constTag(tnumber));
+    build.inst(IrCmd::JUMP, join);
+
+    build.beginBlock(right);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(tnumber));
+    build.inst(IrCmd::STORE_TAG, build.vmReg(1), build.constTag(tboolean));
+    build.inst(IrCmd::JUMP, join);
+
+    build.beginBlock(join);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(tnumber), fallback);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(1)), build.constTag(tnumber), fallback);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(0));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(1));
+
+    updateUseCounts(build.function);
+    constPropInFunction(build);
+
+    CHECK("\n" + toString(build.function, /* includeDetails */ false) == R"(
+bb_0:
+   %0 = LOAD_TAG R2
+   JUMP_EQ_TAG %0, tnil, bb_1, bb_2
+
+bb_1:
+   STORE_TAG R0, tnumber
+   STORE_TAG R1, tnumber
+   JUMP bb_3
+
+bb_2:
+   STORE_TAG R0, tnumber
+   STORE_TAG R1, tboolean
+   JUMP bb_3
+
+bb_3:
+   %10 = LOAD_TAG R1
+   CHECK_TAG %10, tnumber, bb_fallback_4
+   LOP_RETURN 0u
+
+bb_fallback_4:
+   LOP_RETURN 1u
+
+)");
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("LoopOptimization");
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "InvariantGuardsAreHoisted")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp loop = build.block(IrBlockKind::Internal);
+    IrOp latch = build.block(IrBlockKind::Internal);
+    IrOp next = build.block(IrBlockKind::Internal);
+    IrOp exit = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.function.bcMapping.resize(4, {~0u, 0});
+
+    build.beginBlock(entry);
+    build.function.bcMapping[0].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), build.constDouble(0.0));
+    build.inst(IrCmd::STORE_TAG, build.vmReg(1), build.constTag(tnumber));
+    build.inst(IrCmd::JUMP, loop);
+
+    // R0 is not modified by the loop, only R1 is
+    build.beginBlock(loop);
+    build.function.bcMapping[1].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(ttable), fallback);
+    IrOp table = build.inst(IrCmd::LOAD_POINTER, build.vmReg(0));
+    build.inst(IrCmd::CHECK_NO_METATABLE, table, fallback);
+    build.inst(IrCmd::CHECK_READONLY, table, fallback);
+    IrOp sum = build.inst(IrCmd::ADD_NUM, build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1)), build.constDouble(1.0));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), sum);
+    build.inst(IrCmd::JUMP, latch);
+
+    build.beginBlock(latch);
+    build.function.bcMapping[2].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::INTERRUPT, build.constUint(2));
+    build.inst(IrCmd::JUMP, next);
+
+    build.beginBlock(next);
+    IrOp counter = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1));
+    build.inst(IrCmd::JUMP_CMP_NUM, counter, build.constDouble(10.0), build.cond(IrCondition::Less), loop, exit);
+
+    build.beginBlock(exit);
+    build.function.bcMapping[3].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::LOP_RETURN, build.constUint(0));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(1));
+
+    updateUseCounts(build.function);
+    hoistLoopInvariantGuards(build);
+    constPropInFunction(build);
+
+    CHECK("\n" + toString(build.function, /* includeDetails */ false) == R"(
+bb_0:
+   STORE_DOUBLE R1, 0
+   STORE_TAG R1, tnumber
+   JUMP bb_6
+
+bb_1:
+   %8 = LOAD_DOUBLE R1
+   %9 = ADD_NUM %8, 1
+   STORE_DOUBLE R1, %9
+   JUMP bb_2
+
+bb_2:
+   INTERRUPT 2u, bb_fallback_8
+   JUMP bb_3
+
+bb_3:
+   %14 = LOAD_DOUBLE R1
+   JUMP_CMP_NUM %14, 10, lt, bb_1, bb_4
+
+bb_4:
+   LOP_RETURN 0u
+
+bb_6:
+   %19 = LOAD_TAG R0
+   CHECK_TAG %19, ttable, bb_fallback_7
+   %21 = LOAD_POINTER R0
+   CHECK_READONLY %21, bb_fallback_7
+   CHECK_NO_METATABLE %21, bb_fallback_7
+   JUMP bb_1
+
+bb_fallback_7:
+   EXIT_TO_VM 1u
+
+bb_fallback_8:
+   %26 = LOAD_TAG R0
+   CHECK_TAG %26, ttable, bb_fallback_10
+   %28 = LOAD_POINTER R0
+   CHECK_READONLY %28, bb_fallback_10
+   CHECK_NO_METATABLE %28, bb_fallback_10
+   JUMP bb_3
+
+bb_fallback_9:
+   INTERRUPT 2u, bb_fallback_8
+   JUMP bb_fallback_8
+
+bb_fallback_10:
+   EXIT_TO_VM 2u
+
+)");
+
+    // Native code is entered at the loop start through the preheader and after a yield through the interrupt handler continuation
+    CHECK(build.function.bcMapping[1].irLocation == build.function.blocks[6].start);
+    CHECK(build.function.bcMapping[2].irLocation == build.function.blocks[9].start);
+}
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "GuardsOfModifiedRegistersAreNotHoisted")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp loop = build.block(IrBlockKind::Internal);
+    IrOp exit = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.function.bcMapping.resize(3, {~0u, 0});
+
+    build.beginBlock(entry);
+    build.function.bcMapping[0].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::JUMP, loop);
+
+    // Table in R0 is replaced on every iteration
+    build.beginBlock(loop);
+    build.function.bcMapping[1].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(ttable), fallback);
+    build.inst(IrCmd::CHECK_NO_METATABLE, build.inst(IrCmd::LOAD_POINTER, build.vmReg(0)), fallback);
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(0), build.inst(IrCmd::LOAD_TVALUE, build.vmReg(1)));
+    build.inst(IrCmd::JUMP_EQ_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(2)), build.constTag(tnil), loop, exit);
+
+    build.beginBlock(exit);
+    build.function.bcMapping[2].irLocation = uint32_t(build.function.instructions.size());
+    build.inst(IrCmd::LOP_RETURN, build.constUint(0));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::LOP_RETURN, build.constUint(1));
+
+    updateUseCounts(build.function);
+    hoistLoopInvariantGuards(build);
+
+    CHECK("\n" + toString(build.function, /* includeDetails */ false) == R"(
+bb_0:
+   JUMP bb_1
+
+bb_1:
+   %1 = LOAD_TAG R0
+   CHECK_TAG %1, ttable, bb_fallback_3
+   %3 = LOAD_POINTER R0
+   CHECK_NO_METATABLE %3, bb_fallback_3
+   %5 = LOAD_TVALUE R1
+   STORE_TVALUE R0, %5
+   %7 = LOAD_TAG R2
+   JUMP_EQ_TAG %7, tnil, bb_1, bb_2
+
+bb_2:
+   LOP_RETURN 0u
+
+bb_fallback_3:
+   LOP_RETURN 1u
+
+)");
+}
+
 TEST_SUITE_END();
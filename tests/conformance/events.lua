@@ -465,6 +465,84 @@ do
   end
 end
 
+-- field and method lookups that go through __index tables have to observe changes to every table on the path
+do
+  local Base = {} Base.__index = Base
+  function Base.name(self) return "base" end
+  function Base.id(self) return self.v end
+  local Derived = setmetatable({}, Base) Derived.__index = Derived
+  function Derived.name(self) return "derived" end
+
+  local function name(o) return o:name() end
+  local function id(o) return o:id() end
+  local function get(o) return o.v end
+  local function getextra(o) return o.extra end
+  local function set(o, x) o.v = x end
+
+  local a = setmetatable({v=1}, Base)
+  local b = setmetatable({v=2}, Derived)
+
+  for i = 1, 3 do
+    assert(name(a) == "base" and id(a) == 1)
+    assert(name(b) == "derived" and id(b) == 2)
+  end
+
+  b.name = function() return "own" end
+  assert(name(b) == "own")
+  b.name = nil
+  assert(name(b) == "derived")
+
+  Derived.name = nil
+  assert(name(b) == "base")
+  Base.name = function() return "base2" end
+  assert(name(a) == "base2" and name(b) == "base2")
+
+  Derived.__index = function(t, k) return function() return "fn" end end
+  assert(name(b) == "fn")
+  Derived.__index = Derived
+  assert(name(b) == "base2")
+
+  setmetatable(b, Base)
+  assert(name(b) == "base2")
+
+  assert(not pcall(name, setmetatable({}, {__index = {}})))
+
+  assert(getextra(a) == nil)
+  Base.extra = 5
+  assert(getextra(a) == 5 and getextra(b) == 5)
+  Base.extra = nil
+  assert(getextra(a) == nil)
+
+  for i = 1, 100 do a["k"..i] = i end
+  assert(name(a) == "base2" and get(a) == 1)
+
+  set(a, 10)
+  assert(a.v == 10)
+
+  local log = {}
+  local ni = setmetatable({}, {__newindex = function(t, k, v) log[k] = v end})
+  set(ni, 7)
+  assert(log.v == 7 and rawget(ni, "v") == nil)
+
+  local p = {v = 1}
+  for i = 1, 10 do set(p, i) end
+  assert(p.v == 10)
+  p.v = nil
+  set(p, 3)
+  assert(p.v == 3)
+
+  local shapes = {}
+  for i = 1, 8 do
+    local t = {}
+    for j = 1, i do t["f"..j] = j end
+    t.v = i
+    shapes[i] = t
+  end
+  for r = 1, 3 do
+    for i = 1, 8 do assert(get(shapes[i]) == i) end
+  end
+end
+
 function testfenv()
   X = 20; B = 30
 
@@ -350,4 +350,117 @@ do
   collectgarbage()
 end
 
+-- old objects that are modified to refer to young objects must keep them alive in generational mode
+do
+  local prev = collectgarbage("generational")
+  assert(collectgarbage("generational") == "generational")
+
+  local old = {}
+  local weak = setmetatable({}, {__mode = "v"})
+  local co = coroutine.wrap(function()
+    local uv = {}
+    while true do
+      uv = {uv}
+      coroutine.yield(function() return uv end)
+    end
+  end)
+
+  collectgarbage()
+
+  for i = 1,200 do
+    old[i % 10 + 1] = {i}
+    weak[i] = {i}
+    local f = co()
+    for j = 1,100 do
+      local _ = {j}
+    end
+    assert(f()[1] ~= nil)
+  end
+
+  for i = 1,10 do
+    assert(old[i][1] % 10 + 1 == i)
+  end
+
+  for k, v in weak do
+    assert(v[1] == k)
+  end
+
+  assert(collectgarbage(prev) == "generational")
+end
+
+-- large hash parts are resized incrementally, keys must stay reachable while their nodes are moved by insertions and collector steps
+do
+  local own = function() return "own" end
+  local t = setmetatable({own = own}, {__index = {own = function() return "index" end}})
+  local count = 1
+
+  for i = 1,40000 do
+    t["k" .. i] = i
+    t[-i] = i
+    count += 2
+
+    -- method lookups must not skip the key in the old hash part
+    assert(t:own() == "own")
+
+    local j = math.floor(i * 7 / 8) + 1
+    assert(t["k" .. j] == j and t[-j] == j)
+
+    -- removed keys that haven't been moved yet can be inserted again
+    if i % 10 == 0 then
+      t["k" .. j] = nil
+      assert(t["k" .. j] == nil)
+      t["k" .. j] = j
+    end
+
+    if i % 1000 == 0 then
+      collectgarbage("step")
+
+      local c = 0
+      for k, v in t do
+        c += 1
+        assert(k == "own" or v == (type(k) == "number" and -k or tonumber(k:sub(2))))
+      end
+      assert(c == count)
+
+      local copy = table.clone(t)
+      assert(copy["k" .. i] == i and copy[-j] == j)
+    end
+  end
+
+  collectgarbage()
+
+  for i = 1,40000 do
+    assert(t["k" .. i] == i and t[-i] == i)
+  end
+
+  table.clear(t)
+  assert(next(t) == nil)
+end
+
+-- weak tables are cleared while they are resized
+do
+  local t = setmetatable({}, {__mode = "k"})
+  local alive = {}
+
+  for i = 1,20000 do
+    local k = {}
+    t[k] = i
+    if i % 2 == 0 then
+      alive[i] = k
+    end
+    if i % 100 == 0 then
+      collectgarbage("step")
+    end
+  end
+
+  collectgarbage()
+
+  local c = 0
+  for k, v in t do
+    assert(alive[v] == k)
+    c += 1
+  end
+  assert(c == 10000)
+end
+
 return('OK')
@@ -314,4 +314,49 @@ assert(string.match("abc\0\0\0", "%\0%\0?") == "\0\0")
 assert(string.find("abc\0\0","\0.") == 4)
 assert(string.find("abcx\0\0abc\0abc","x\0\0abc\0a.") == 4)
 
+-- patterns are compiled and skip ahead to positions where a match can start
+assert(string.find("a.b.c", "%.c") == 4)
+assert(string.find("xaxabxab", "(a)b") == 4)
+assert(string.find(string.rep("a", 100) .. "ab", "ab") == 101)
+assert(string.find(string.rep("a", 100) .. "ab", "a+b") == 1)
+assert(string.match("xx[ERROR] yy", "()%[(%u+)%]()") == 3)
+assert(string.match("foo = bar; baz = qux;", "(%w+) = (%w+);", 10) == "baz")
+assert(string.match("aaab", "a*ab") == "aaab")
+assert(string.match("aaa", "a-a$") == "aaa")
+assert(string.match("  trim  ", "^%s*(.-)%s*$") == "trim")
+assert(string.gsub("hello world", "o", "0") == "hell0 w0rld")
+assert(string.gsub("abc", "x*", "-") == "-a-b-c-")
+assert(string.gsub("abc def", "%f[%w]", "^") == "^abc ^def")
+assert(string.gsub("a,b,,c", ",", ";", 2) == "a;b;,c")
+assert(string.gsub("key=1 key=2", "^key", "k") == "k=1 key=2")
+
+-- '^' is not an anchor in gmatch
+local t = {}
+for w in string.gmatch("^a^b", "^%a") do t[#t + 1] = w end
+assert(#t == 2 and t[1] == "^a" and t[2] == "^b")
+
+-- malformed parts of a pattern are only reported once the match reaches them
+assert(string.find("abc", "x[") == nil)
+assert(string.find("abc", "x%") == nil)
+
+-- compiled patterns are cached until the next collection
+for i = 1, 3 do
+  assert(string.match("key=value", "(%w+)=(%w+)") == "key")
+  collectgarbage()
+end
+
+-- long patterns are not compiled, so matching them doesn't take memory proportional to their length
+do
+  local p = string.rep("a", 100000)
+  local s = p .. "b"
+  local before = gcinfo()
+  assert(string.match(s, p) == p)
+  assert(string.find(s, p .. "$") == nil)
+  assert(gcinfo() - before < 1000)
+
+  assert(string.match(string.rep("x", 300), string.rep("%a", 200)) == string.rep("x", 200))
+  assert(string.gsub(string.rep("x", 300), string.rep("x", 300), "y") == "y")
+  assert(select(2, string.gsub(s, string.rep("a", 300), "")) == 333)
+end
+
 return('OK')
@@ -72,4 +72,60 @@ table.sort(a)
 check(a, tt.__lt)
 check(a)
 
+-- McIlroy's adversary makes quicksort quadratic; the number of comparisons has to stay within n log n
+local function antiqsort(n)
+  local gas = n
+  local val = {}
+  local items = {}
+  local nsolid = 0
+  local candidate = 0
+  local ncmp = 0
+  for i=1,n do items[i] = i; val[i] = gas end
+  table.sort(items, function (x, y)
+    ncmp += 1
+    if val[x] == gas and val[y] == gas then
+      if x == candidate then val[x] = nsolid else val[y] = nsolid end
+      nsolid += 1
+    end
+    if val[x] == gas then candidate = x elseif val[y] == gas then candidate = y end
+    return val[x] < val[y]
+  end)
+  for i=2,n do assert(val[items[i-1]] <= val[items[i]]) end
+  return ncmp
+end
+
+assert(antiqsort(10000) < 10000 * 14 * 5)
+
+-- arrays of numbers and strings are sorted without calling the generic comparison
+a = {}
+for i=1,limit do a[i] = math.random(1, 100) + (i % 3 == 0 and 0.5 or 0) end
+table.sort(a)
+check(a)
+
+a = {}
+for i=1,limit do a[i] = tostring(math.random(1, 1000)) end
+table.sort(a)
+check(a)
+
+-- numbers and strings can't be compared
+a = {1, "2", 3}
+assert(not pcall(table.sort, a))
+
+-- the table can't be changed when it's read-only or when its array part shrinks while it's sorted
+a = {3, 2, 1}
+table.freeze(a)
+assert(not pcall(table.sort, a))
+
+a = {}
+for i=1,100 do a[i] = i end
+local ok, err = pcall(table.sort, a, function (x, y)
+  table.clear(a)
+  for k=1,10 do a[k] = k end
+  a.x = 1
+  return x < y
+end)
+assert(not ok and err:find("table modified during sorting"))
+
+assert(not pcall(table.sort, {1, 2, 3, 4, 5}, function () return true end))
+
 return"OK"
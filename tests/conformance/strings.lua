@@ -199,6 +199,35 @@ assert(table.concat(a, ",", 2) == "b,c")
 assert(table.concat(a, ",", 3) == "c")
 assert(table.concat(a, ",", 4) == "")
 
+-- strings built by appending compare and index like strings created in one piece
+do
+  local s, u = "", ""
+  local t = {}
+  for i = 1, 300 do
+    s = s .. "xuxu"
+    u = u .. "xu" .. "xu"
+    t[s] = i
+  end
+  assert(s == string.rep("xuxu", 300) and s == u)
+  assert(t[string.rep("xuxu", 300)] == 300 and t[string.rep("xuxu", 200)] == 200)
+
+  -- the same prefix extended twice
+  local a, b = s .. "a", s .. "b"
+  assert(a == table.concat({s, "a"}) and b == table.concat({s, "b"}) and a ~= b)
+
+  -- more builders than the concatenation keeps track of
+  local builders = {}
+  for j = 1, 7 do builders[j] = string.rep(tostring(j), 600) end
+  for i = 1, 100 do
+    for j = 1, 7 do builders[j] = builders[j] .. i end
+  end
+  for j = 1, 7 do
+    local parts = {string.rep(tostring(j), 600)}
+    for i = 1, 100 do parts[#parts + 1] = tostring(i) end
+    assert(builders[j] == table.concat(parts))
+  end
+end
+
 -- string.split
 do
   local function eq(a, b)
@@ -217,6 +246,24 @@ do
   assert(eq(string.split("abc", "b"), {'a', 'c'}))
   assert(eq(string.split("abc", "d"), {'abc'}))
   assert(eq(string.split("abc", "c"), {'ab', ''}))
+  assert(eq(string.split(",a,,b,", ","), {'', 'a', '', 'b', ''}))
+  assert(eq(string.split("a, b, c", ", "), {'a', 'b', 'c'}))
+  assert(eq(string.split("aaa", "aa"), {'', 'a'}))
+  assert(eq(string.split("a\0b\0", "\0"), {'a', 'b', ''}))
+  assert(eq(string.split("", ","), {''}))
+  assert(eq(string.split("", ""), {}))
+  assert(eq(string.split("a,b"), {'a', 'b'}))
+  assert(#string.split(string.rep("x,", 1000)) == 1001)
+
+  -- single character needles in plain searches, split and literal pattern prefixes
+  assert(string.find("a", "a", 1, true) == 1)
+  assert(string.find("xya", "a", 1, true) == 3)
+  assert(string.find("xyz", "a", 1, true) == nil)
+  assert(string.find("a.b", ".", 1, true) == 2)
+  assert(string.find("xab", "a%w") == 2)
+  assert(eq(string.split(",", ","), {'', ''}))
+  assert(eq(string.split("a", "a"), {'', ''}))
+  assert(eq(string.split("ab", "b"), {'a', ''}))
 end
 
 --[[
@@ -410,6 +410,25 @@ do
 
   -- make sure table.find checks the hash portion as well by constructing a table literal that forces the value into the hash part
   assert(table.find({[(1)] = true}, true) == 1)
+
+  -- values are compared the same way as with ==
+  assert(table.find({1, 2, -0, 3}, 0) == 3)
+  assert(table.find({0/0, 1}, 0/0) == nil)
+  assert(table.find({"1", 1}, 1) == 2)
+  assert(table.find({1, "1"}, "1") == 2)
+  assert(table.find({true, false}, false) == 2)
+  assert(table.find({false, 0}, 0) == 2)
+
+  -- the search stops at the first nil
+  local t3 = table.create(100, 1)
+  t3[50] = nil
+  t3[75] = 2
+  assert(table.find(t3, 2) == nil)
+  assert(table.find(t3, 2, 51) == 75)
+
+  -- __eq is used for tables
+  local mt = {__eq = function() return true end}
+  assert(table.find({setmetatable({}, mt), 1}, setmetatable({}, mt)) == 1)
 end
 
 -- test indexing with strings that have zeroes embedded in them
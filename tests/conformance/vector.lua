@@ -117,4 +117,59 @@ do
 	assert(larget[vector(-0, 0, 0)] == 42)
 end
 
+-- arithmetic on values that can be either numbers or vectors
+do
+	local function arith(a, b)
+		return a + b, a - b, a * b, a / b, -a
+	end
+
+	local s, d, m, q, n = arith(2, 4)
+	assert(s == 6 and d == -2 and m == 8 and q == 0.5 and n == -2)
+
+	s, d, m, q, n = arith(vector(1, 2, 4), vector(2, 4, 8))
+	assert(s == vector(3, 6, 12) and d == vector(-1, -2, -4) and m == vector(2, 8, 32) and q == vector(0.5, 0.5, 0.5) and n == vector(-1, -2, -4))
+
+	local function scale(a, b)
+		return a * b, a / b, a * 2, a / 2
+	end
+
+	local m1, q1, m2, q2 = scale(vector(1, 2, 4), 4)
+	assert(m1 == vector(4, 8, 16) and q1 == vector(0.25, 0.5, 1) and m2 == vector(2, 4, 8) and q2 == vector(0.5, 1, 2))
+
+	m1, q1 = scale(4, vector(1, 2, 4))
+	assert(m1 == vector(4, 8, 16) and q1 == vector(4, 2, 1))
+
+	-- mismatched operands still report errors
+	assert(pcall(arith, vector(1, 2, 3), 1) == false)
+	assert(pcall(arith, 1, vector(1, 2, 3)) == false)
+	assert(pcall(scale, vector(1, 2, 3), "a") == false)
+
+	-- result overwriting an operand
+	local v = vector(1, 2, 3)
+	for i = 1, 10 do
+		v = v * 2 + v
+		v = -v
+	end
+	assert(v == vector(59049, 118098, 177147))
+
+	-- component access on tables and vectors from the same instruction
+	local function sum(p)
+		return p.x + p.y + p.Z
+	end
+
+	assert(sum(vector(1, 2, 3)) == 6)
+	assert(sum({x = 1, y = 2, Z = 3}) == 6)
+	assert(sum(vector(0.5, -0.5, 0.25)) == 0.25)
+
+	local function accumulate(n)
+		local acc = vector(0, 0, 0)
+		for i = 1, n do
+			acc += vector(i, i * 2, -i)
+		end
+		return acc
+	end
+
+	assert(accumulate(100) == vector(5050, 10100, -5050))
+end
+
 return 'OK'